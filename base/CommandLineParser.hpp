@@ -1,7 +1,7 @@
 /*
  * Simple command line parse
  *
- * Copyright (C) 2016-2022 by Sascha Willems - www.saschawillems.de
+ * Copyright (C) 2016-2025 by Sascha Willems - www.saschawillems.de
  *
  * This code is licensed under the MIT license (MIT) (http://opensource.org/licenses/MIT)
  */
@@ -114,4 +114,18 @@ public:
 		return int32_t();
 	}
 
+	float getValueAsFloat(std::string name, float defaultValue)
+	{
+		assert(options.find(name) != options.end());
+		std::string value = options[name].value;
+		if (value != "") {
+			char* numConvPtr;
+			float floatVal = strtof(value.c_str(), &numConvPtr);
+			return (floatVal > 0.0f) ? floatVal : defaultValue;
+		}
+		else {
+			return defaultValue;
+		}
+	}
+
 };
\ No newline at end of file
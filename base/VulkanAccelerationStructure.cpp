@@ -0,0 +1,417 @@
+/*
+* Vulkan acceleration structure manager
+*
+* Copyright (C) 2025 by Sascha Willems - www.saschawillems.de
+*
+* This code is licensed under the MIT license (MIT) (http://opensource.org/licenses/MIT)
+*/
+
+#include "VulkanAccelerationStructure.h"
+
+#include <algorithm>
+
+namespace vks
+{
+	void AccelerationStructureManager::prepare(vks::VulkanDevice* vulkanDevice, VkQueue queue)
+	{
+		this->vulkanDevice = vulkanDevice;
+		this->queue = queue;
+
+		VkPhysicalDeviceAccelerationStructurePropertiesKHR accelerationStructureProperties{};
+		accelerationStructureProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_PROPERTIES_KHR;
+		VkPhysicalDeviceProperties2 deviceProperties2{};
+		deviceProperties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+		deviceProperties2.pNext = &accelerationStructureProperties;
+		vkGetPhysicalDeviceProperties2(vulkanDevice->physicalDevice, &deviceProperties2);
+		scratchAlignment = std::max<VkDeviceSize>(accelerationStructureProperties.minAccelerationStructureScratchOffsetAlignment, 1);
+
+		VkDevice device = vulkanDevice->logicalDevice;
+		vkGetBufferDeviceAddressKHR = reinterpret_cast<PFN_vkGetBufferDeviceAddressKHR>(vkGetDeviceProcAddr(device, "vkGetBufferDeviceAddressKHR"));
+		vkCreateAccelerationStructureKHR = reinterpret_cast<PFN_vkCreateAccelerationStructureKHR>(vkGetDeviceProcAddr(device, "vkCreateAccelerationStructureKHR"));
+		vkDestroyAccelerationStructureKHR = reinterpret_cast<PFN_vkDestroyAccelerationStructureKHR>(vkGetDeviceProcAddr(device, "vkDestroyAccelerationStructureKHR"));
+		vkGetAccelerationStructureBuildSizesKHR = reinterpret_cast<PFN_vkGetAccelerationStructureBuildSizesKHR>(vkGetDeviceProcAddr(device, "vkGetAccelerationStructureBuildSizesKHR"));
+		vkGetAccelerationStructureDeviceAddressKHR = reinterpret_cast<PFN_vkGetAccelerationStructureDeviceAddressKHR>(vkGetDeviceProcAddr(device, "vkGetAccelerationStructureDeviceAddressKHR"));
+		vkCmdBuildAccelerationStructuresKHR = reinterpret_cast<PFN_vkCmdBuildAccelerationStructuresKHR>(vkGetDeviceProcAddr(device, "vkCmdBuildAccelerationStructuresKHR"));
+		vkCmdWriteAccelerationStructuresPropertiesKHR = reinterpret_cast<PFN_vkCmdWriteAccelerationStructuresPropertiesKHR>(vkGetDeviceProcAddr(device, "vkCmdWriteAccelerationStructuresPropertiesKHR"));
+		vkCmdCopyAccelerationStructureKHR = reinterpret_cast<PFN_vkCmdCopyAccelerationStructureKHR>(vkGetDeviceProcAddr(device, "vkCmdCopyAccelerationStructureKHR"));
+	}
+
+	void AccelerationStructureManager::destroy()
+	{
+		if (!vulkanDevice) {
+			return;
+		}
+		for (auto& b : blas) {
+			destroyAllocation(b.allocation);
+		}
+		blas.clear();
+		updateScratchBuffer.destroy();
+		updateScratchBuffer = {};
+		destroyAllocation(tlas.allocation);
+		tlas.instanceBuffer.destroy();
+		tlas.scratchBuffer.destroy();
+		tlas = {};
+		statistics = {};
+		vulkanDevice = nullptr;
+	}
+
+	void AccelerationStructureManager::createAllocation(Allocation& allocation, VkAccelerationStructureTypeKHR type, VkDeviceSize size)
+	{
+		VkDevice device = vulkanDevice->logicalDevice;
+		VkBufferCreateInfo bufferCreateInfo{};
+		bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		bufferCreateInfo.size = size;
+		bufferCreateInfo.usage = VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+		VK_CHECK_RESULT(vkCreateBuffer(device, &bufferCreateInfo, nullptr, &allocation.buffer));
+		VkMemoryRequirements memoryRequirements{};
+		vkGetBufferMemoryRequirements(device, allocation.buffer, &memoryRequirements);
+		VkMemoryAllocateFlagsInfo memoryAllocateFlagsInfo{};
+		memoryAllocateFlagsInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
+		memoryAllocateFlagsInfo.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT_KHR;
+		VkMemoryAllocateInfo memoryAllocateInfo{};
+		memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		memoryAllocateInfo.pNext = &memoryAllocateFlagsInfo;
+		memoryAllocateInfo.allocationSize = memoryRequirements.size;
+		memoryAllocateInfo.memoryTypeIndex = vulkanDevice->getMemoryType(memoryRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+		VK_CHECK_RESULT(vkAllocateMemory(device, &memoryAllocateInfo, nullptr, &allocation.memory));
+		VK_CHECK_RESULT(vkBindBufferMemory(device, allocation.buffer, allocation.memory, 0));
+		allocation.size = size;
+
+		VkAccelerationStructureCreateInfoKHR accelerationStructureCreateInfo{};
+		accelerationStructureCreateInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_CREATE_INFO_KHR;
+		accelerationStructureCreateInfo.buffer = allocation.buffer;
+		accelerationStructureCreateInfo.size = size;
+		accelerationStructureCreateInfo.type = type;
+		VK_CHECK_RESULT(vkCreateAccelerationStructureKHR(device, &accelerationStructureCreateInfo, nullptr, &allocation.handle));
+
+		VkAccelerationStructureDeviceAddressInfoKHR accelerationDeviceAddressInfo{};
+		accelerationDeviceAddressInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_DEVICE_ADDRESS_INFO_KHR;
+		accelerationDeviceAddressInfo.accelerationStructure = allocation.handle;
+		allocation.deviceAddress = vkGetAccelerationStructureDeviceAddressKHR(device, &accelerationDeviceAddressInfo);
+	}
+
+	void AccelerationStructureManager::destroyAllocation(Allocation& allocation)
+	{
+		VkDevice device = vulkanDevice->logicalDevice;
+		if (allocation.handle != VK_NULL_HANDLE) {
+			vkDestroyAccelerationStructureKHR(device, allocation.handle, nullptr);
+		}
+		if (allocation.buffer != VK_NULL_HANDLE) {
+			vkDestroyBuffer(device, allocation.buffer, nullptr);
+		}
+		if (allocation.memory != VK_NULL_HANDLE) {
+			vkFreeMemory(device, allocation.memory, nullptr);
+		}
+		allocation = {};
+	}
+
+	void AccelerationStructureManager::createScratchBuffer(vks::Buffer& buffer, VkDeviceSize size)
+	{
+		// Scratch memory needs some extra space, so the base address can be aligned to the required scratch offset alignment
+		VK_CHECK_RESULT(vulkanDevice->createBuffer(
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+			&buffer,
+			size + scratchAlignment));
+	}
+
+	uint64_t AccelerationStructureManager::getBufferDeviceAddress(VkBuffer buffer) const
+	{
+		VkBufferDeviceAddressInfoKHR bufferDeviceAddressInfo{};
+		bufferDeviceAddressInfo.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
+		bufferDeviceAddressInfo.buffer = buffer;
+		return vkGetBufferDeviceAddressKHR(vulkanDevice->logicalDevice, &bufferDeviceAddressInfo);
+	}
+
+	VkAccelerationStructureBuildGeometryInfoKHR AccelerationStructureManager::getBuildGeometryInfo(const BLAS& blas) const
+	{
+		VkAccelerationStructureBuildGeometryInfoKHR buildGeometryInfo{};
+		buildGeometryInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
+		buildGeometryInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR;
+		buildGeometryInfo.flags = blas.flags;
+		buildGeometryInfo.mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
+		buildGeometryInfo.geometryCount = static_cast<uint32_t>(blas.geometries.size());
+		buildGeometryInfo.pGeometries = blas.geometries.data();
+		return buildGeometryInfo;
+	}
+
+	void AccelerationStructureManager::insertBuildBarrier(VkCommandBuffer commandBuffer, VkPipelineStageFlags dstStageMask, VkAccessFlags dstAccessMask) const
+	{
+		VkMemoryBarrier memoryBarrier = vks::initializers::memoryBarrier();
+		memoryBarrier.srcAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+		memoryBarrier.dstAccessMask = dstAccessMask;
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR, dstStageMask, 0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+	}
+
+	uint32_t AccelerationStructureManager::addBLAS(const std::vector<VkAccelerationStructureGeometryKHR>& geometries, const std::vector<VkAccelerationStructureBuildRangeInfoKHR>& buildRanges, VkBuildAccelerationStructureFlagsKHR flags)
+	{
+		assert(geometries.size() == buildRanges.size());
+		BLAS newBlas{};
+		newBlas.geometries = geometries;
+		newBlas.buildRanges = buildRanges;
+		newBlas.flags = flags;
+		blas.push_back(newBlas);
+		return static_cast<uint32_t>(blas.size() - 1);
+	}
+
+	void AccelerationStructureManager::buildBLAS()
+	{
+		VkDevice device = vulkanDevice->logicalDevice;
+
+		std::vector<uint32_t> pending;
+		for (uint32_t i = 0; i < blas.size(); i++) {
+			if (!blas[i].built) {
+				pending.push_back(i);
+			}
+		}
+		if (pending.empty()) {
+			return;
+		}
+
+		// Get the sizes and create the (uncompacted) acceleration structures
+		VkDeviceSize maxScratchSize = 0;
+		VkDeviceSize totalScratchSize = 0;
+		for (uint32_t index : pending) {
+			BLAS& b = blas[index];
+			VkAccelerationStructureBuildGeometryInfoKHR buildGeometryInfo = getBuildGeometryInfo(b);
+			std::vector<uint32_t> maxPrimitiveCounts(b.buildRanges.size());
+			for (size_t i = 0; i < b.buildRanges.size(); i++) {
+				maxPrimitiveCounts[i] = b.buildRanges[i].primitiveCount;
+			}
+			b.sizes = {};
+			b.sizes.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_SIZES_INFO_KHR;
+			vkGetAccelerationStructureBuildSizesKHR(device, VK_ACCELERATION_STRUCTURE_BUILD_TYPE_DEVICE_KHR, &buildGeometryInfo, maxPrimitiveCounts.data(), &b.sizes);
+			createAllocation(b.allocation, VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR, b.sizes.accelerationStructureSize);
+			const VkDeviceSize scratchSize = vks::tools::alignedVkSize(b.sizes.buildScratchSize, scratchAlignment);
+			maxScratchSize = std::max(maxScratchSize, scratchSize);
+			totalScratchSize += scratchSize;
+		}
+
+		// All builds of a batch run concurrently and each needs its own scratch memory, so they get disjoint ranges of a shared arena
+		// The arena is reused by the next batch once the previous one has finished
+		const VkDeviceSize arenaSize = std::max(maxScratchSize, std::min(totalScratchSize, scratchBudget));
+		vks::Buffer scratchArena;
+		createScratchBuffer(scratchArena, arenaSize);
+		const VkDeviceSize arenaAddress = vks::tools::alignedVkSize(getBufferDeviceAddress(scratchArena.buffer), scratchAlignment);
+
+		// Updates need a destination of at least the build size, so BLAS that allow updates are never replaced by a compacted copy
+		std::vector<uint32_t> compactable;
+		for (uint32_t index : pending) {
+			const VkBuildAccelerationStructureFlagsKHR flags = blas[index].flags;
+			if ((flags & VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_COMPACTION_BIT_KHR) && !(flags & VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR)) {
+				compactable.push_back(index);
+			}
+		}
+		VkQueryPool queryPool{ VK_NULL_HANDLE };
+		if (!compactable.empty()) {
+			VkQueryPoolCreateInfo queryPoolInfo = {};
+			queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+			queryPoolInfo.queryType = VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_KHR;
+			queryPoolInfo.queryCount = static_cast<uint32_t>(compactable.size());
+			VK_CHECK_RESULT(vkCreateQueryPool(device, &queryPoolInfo, nullptr, &queryPool));
+		}
+
+		statistics.batchCount = 0;
+		VkCommandBuffer commandBuffer = vulkanDevice->createCommandBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
+		if (queryPool != VK_NULL_HANDLE) {
+			vkCmdResetQueryPool(commandBuffer, queryPool, 0, static_cast<uint32_t>(compactable.size()));
+		}
+		size_t next = 0;
+		while (next < pending.size()) {
+			std::vector<VkAccelerationStructureBuildGeometryInfoKHR> buildGeometryInfos;
+			std::vector<const VkAccelerationStructureBuildRangeInfoKHR*> pBuildRanges;
+			VkDeviceSize offset = 0;
+			while (next < pending.size()) {
+				BLAS& b = blas[pending[next]];
+				const VkDeviceSize scratchSize = vks::tools::alignedVkSize(b.sizes.buildScratchSize, scratchAlignment);
+				if ((offset > 0) && (offset + scratchSize > arenaSize)) {
+					break;
+				}
+				VkAccelerationStructureBuildGeometryInfoKHR buildGeometryInfo = getBuildGeometryInfo(b);
+				buildGeometryInfo.dstAccelerationStructure = b.allocation.handle;
+				buildGeometryInfo.scratchData.deviceAddress = arenaAddress + offset;
+				buildGeometryInfos.push_back(buildGeometryInfo);
+				pBuildRanges.push_back(b.buildRanges.data());
+				offset += scratchSize;
+				next++;
+			}
+			vkCmdBuildAccelerationStructuresKHR(commandBuffer, static_cast<uint32_t>(buildGeometryInfos.size()), buildGeometryInfos.data(), pBuildRanges.data());
+			// Wait for the batch before its scratch memory is reused and before the compacted sizes are queried
+			insertBuildBarrier(commandBuffer, VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR, VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR | VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR);
+			statistics.batchCount++;
+		}
+		if (queryPool != VK_NULL_HANDLE) {
+			std::vector<VkAccelerationStructureKHR> handles;
+			for (uint32_t index : compactable) {
+				handles.push_back(blas[index].allocation.handle);
+			}
+			vkCmdWriteAccelerationStructuresPropertiesKHR(commandBuffer, static_cast<uint32_t>(handles.size()), handles.data(), VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_KHR, queryPool, 0);
+		}
+		vulkanDevice->flushCommandBuffer(commandBuffer, queue);
+		scratchArena.destroy();
+
+		statistics.scratchArenaSize = arenaSize;
+		for (uint32_t index : pending) {
+			blas[index].built = true;
+			statistics.memoryBeforeCompaction += blas[index].allocation.size;
+		}
+
+		// Copy all BLAS that allow compaction into acceleration structures that only have the size they actually need
+		if (queryPool != VK_NULL_HANDLE) {
+			std::vector<VkDeviceSize> compactedSizes(compactable.size());
+			VK_CHECK_RESULT(vkGetQueryPoolResults(device, queryPool, 0, static_cast<uint32_t>(compactable.size()), compactedSizes.size() * sizeof(VkDeviceSize), compactedSizes.data(), sizeof(VkDeviceSize), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT));
+			vkDestroyQueryPool(device, queryPool, nullptr);
+
+			std::vector<Allocation> compacted(compactable.size());
+			commandBuffer = vulkanDevice->createCommandBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
+			for (size_t i = 0; i < compactable.size(); i++) {
+				createAllocation(compacted[i], VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR, compactedSizes[i]);
+				VkCopyAccelerationStructureInfoKHR copyInfo{};
+				copyInfo.sType = VK_STRUCTURE_TYPE_COPY_ACCELERATION_STRUCTURE_INFO_KHR;
+				copyInfo.src = blas[compactable[i]].allocation.handle;
+				copyInfo.dst = compacted[i].handle;
+				copyInfo.mode = VK_COPY_ACCELERATION_STRUCTURE_MODE_COMPACT_KHR;
+				vkCmdCopyAccelerationStructureKHR(commandBuffer, &copyInfo);
+			}
+			vulkanDevice->flushCommandBuffer(commandBuffer, queue);
+			for (size_t i = 0; i < compactable.size(); i++) {
+				destroyAllocation(blas[compactable[i]].allocation);
+				blas[compactable[i]].allocation = compacted[i];
+			}
+			statistics.compactedCount += static_cast<uint32_t>(compactable.size());
+		}
+		for (uint32_t index : pending) {
+			statistics.memoryAfterCompaction += blas[index].allocation.size;
+		}
+		statistics.blasCount = static_cast<uint32_t>(blas.size());
+
+		// Refits of all updatable BLAS can be recorded at once, so each gets its own range of a persistent scratch buffer
+		VkDeviceSize updateScratchSize = 0;
+		for (auto& b : blas) {
+			if (b.flags & VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR) {
+				b.updateScratchOffset = updateScratchSize;
+				updateScratchSize += vks::tools::alignedVkSize(b.sizes.updateScratchSize, scratchAlignment);
+			}
+		}
+		if (updateScratchSize != statistics.updateScratchSize) {
+			updateScratchBuffer.destroy();
+			updateScratchBuffer = {};
+			if (updateScratchSize > 0) {
+				createScratchBuffer(updateScratchBuffer, updateScratchSize);
+			}
+			statistics.updateScratchSize = updateScratchSize;
+		}
+	}
+
+	void AccelerationStructureManager::recordRefit(VkCommandBuffer commandBuffer, const std::vector<uint32_t>& blasHandles)
+	{
+		if (blasHandles.empty()) {
+			return;
+		}
+		const VkDeviceSize scratchAddress = vks::tools::alignedVkSize(getBufferDeviceAddress(updateScratchBuffer.buffer), scratchAlignment);
+		std::vector<VkAccelerationStructureBuildGeometryInfoKHR> buildGeometryInfos;
+		std::vector<const VkAccelerationStructureBuildRangeInfoKHR*> pBuildRanges;
+		for (uint32_t handle : blasHandles) {
+			const BLAS& b = blas[handle];
+			assert(b.built && (b.flags & VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR));
+			// An update keeps the topology of the hierarchy and only refits the bounds, which is a lot faster than a rebuild but degrades trace performance for large deformations
+			VkAccelerationStructureBuildGeometryInfoKHR buildGeometryInfo = getBuildGeometryInfo(b);
+			buildGeometryInfo.mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_UPDATE_KHR;
+			buildGeometryInfo.srcAccelerationStructure = b.allocation.handle;
+			buildGeometryInfo.dstAccelerationStructure = b.allocation.handle;
+			buildGeometryInfo.scratchData.deviceAddress = scratchAddress + b.updateScratchOffset;
+			buildGeometryInfos.push_back(buildGeometryInfo);
+			pBuildRanges.push_back(b.buildRanges.data());
+		}
+		vkCmdBuildAccelerationStructuresKHR(commandBuffer, static_cast<uint32_t>(buildGeometryInfos.size()), buildGeometryInfos.data(), pBuildRanges.data());
+		insertBuildBarrier(commandBuffer, VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR, VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR | VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR);
+	}
+
+	uint64_t AccelerationStructureManager::getBLASDeviceAddress(uint32_t blasHandle) const
+	{
+		return blas[blasHandle].allocation.deviceAddress;
+	}
+
+	bool AccelerationStructureManager::setInstances(const std::vector<VkAccelerationStructureInstanceKHR>& instances)
+	{
+		const uint32_t instanceCount = static_cast<uint32_t>(instances.size());
+		bool recreated = false;
+		if ((tlas.allocation.handle == VK_NULL_HANDLE) || (instanceCount > tlas.capacity)) {
+			// Grow with some headroom, so adding a few instances doesn't recreate the TLAS every time
+			tlas.capacity = std::max(instanceCount + instanceCount / 2, 16u);
+
+			vkDeviceWaitIdle(vulkanDevice->logicalDevice);
+			destroyAllocation(tlas.allocation);
+			tlas.instanceBuffer.destroy();
+			tlas.instanceBuffer = {};
+			tlas.scratchBuffer.destroy();
+			tlas.scratchBuffer = {};
+
+			VK_CHECK_RESULT(vulkanDevice->createBuffer(
+				VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR,
+				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+				&tlas.instanceBuffer,
+				tlas.capacity * sizeof(VkAccelerationStructureInstanceKHR)));
+			VK_CHECK_RESULT(tlas.instanceBuffer.map());
+
+			tlas.geometry = {};
+			tlas.geometry.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR;
+			tlas.geometry.geometryType = VK_GEOMETRY_TYPE_INSTANCES_KHR;
+			tlas.geometry.flags = VK_GEOMETRY_OPAQUE_BIT_KHR;
+			tlas.geometry.geometry.instances.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_INSTANCES_DATA_KHR;
+			tlas.geometry.geometry.instances.arrayOfPointers = VK_FALSE;
+			tlas.geometry.geometry.instances.data.deviceAddress = getBufferDeviceAddress(tlas.instanceBuffer.buffer);
+
+			VkAccelerationStructureBuildGeometryInfoKHR buildGeometryInfo{};
+			buildGeometryInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
+			buildGeometryInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR;
+			buildGeometryInfo.flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR;
+			buildGeometryInfo.geometryCount = 1;
+			buildGeometryInfo.pGeometries = &tlas.geometry;
+			VkAccelerationStructureBuildSizesInfoKHR buildSizesInfo{};
+			buildSizesInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_SIZES_INFO_KHR;
+			vkGetAccelerationStructureBuildSizesKHR(vulkanDevice->logicalDevice, VK_ACCELERATION_STRUCTURE_BUILD_TYPE_DEVICE_KHR, &buildGeometryInfo, &tlas.capacity, &buildSizesInfo);
+
+			createAllocation(tlas.allocation, VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR, buildSizesInfo.accelerationStructureSize);
+			createScratchBuffer(tlas.scratchBuffer, buildSizesInfo.buildScratchSize);
+			statistics.tlasSize = buildSizesInfo.accelerationStructureSize;
+			recreated = true;
+		}
+		memcpy(tlas.instanceBuffer.mapped, instances.data(), instanceCount * sizeof(VkAccelerationStructureInstanceKHR));
+		tlas.instanceCount = instanceCount;
+		return recreated;
+	}
+
+	void AccelerationStructureManager::recordTLASBuild(VkCommandBuffer commandBuffer)
+	{
+		// The TLAS is rebuilt instead of updated, as instances usually move too much for a refit to produce a good hierarchy, and rebuilding a few instances is cheap
+		VkAccelerationStructureBuildGeometryInfoKHR buildGeometryInfo{};
+		buildGeometryInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
+		buildGeometryInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR;
+		buildGeometryInfo.flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR;
+		buildGeometryInfo.mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
+		buildGeometryInfo.dstAccelerationStructure = tlas.allocation.handle;
+		buildGeometryInfo.geometryCount = 1;
+		buildGeometryInfo.pGeometries = &tlas.geometry;
+		buildGeometryInfo.scratchData.deviceAddress = vks::tools::alignedVkSize(getBufferDeviceAddress(tlas.scratchBuffer.buffer), scratchAlignment);
+
+		VkAccelerationStructureBuildRangeInfoKHR buildRangeInfo{};
+		buildRangeInfo.primitiveCount = tlas.instanceCount;
+		const VkAccelerationStructureBuildRangeInfoKHR* pBuildRangeInfo = &buildRangeInfo;
+
+		vkCmdBuildAccelerationStructuresKHR(commandBuffer, 1, &buildGeometryInfo, &pBuildRangeInfo);
+		insertBuildBarrier(commandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR | VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR);
+	}
+
+	void AccelerationStructureManager::buildTLAS()
+	{
+		VkCommandBuffer commandBuffer = vulkanDevice->createCommandBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
+		recordTLASBuild(commandBuffer);
+		vulkanDevice->flushCommandBuffer(commandBuffer, queue);
+	}
+
+	VkAccelerationStructureKHR AccelerationStructureManager::getTLAS() const
+	{
+		return tlas.allocation.handle;
+	}
+}
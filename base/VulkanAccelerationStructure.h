@@ -0,0 +1,126 @@
+/*
+* Vulkan acceleration structure manager
+*
+* Builds bottom level acceleration structures in batches that share a suballocated scratch arena, compacts them using
+* compacted size queries, refits updatable ones for animated geometry and rebuilds the top level acceleration structure from an instance buffer
+*
+* Copyright (C) 2025 by Sascha Willems - www.saschawillems.de
+*
+* This code is licensed under the MIT license (MIT) (http://opensource.org/licenses/MIT)
+*/
+
+#pragma once
+
+#include <vector>
+
+#include "vulkan/vulkan.h"
+#include "VulkanDevice.h"
+#include "VulkanTools.h"
+
+namespace vks
+{
+	class AccelerationStructureManager
+	{
+	public:
+		/** @brief Numbers of the last BLAS build, used to display the effect of compaction */
+		struct Statistics {
+			uint32_t blasCount{ 0 };
+			uint32_t compactedCount{ 0 };
+			/** @brief Number of vkCmdBuildAccelerationStructuresKHR calls needed to fit all builds into the scratch arena */
+			uint32_t batchCount{ 0 };
+			/** @brief Size of all BLAS as built (before compaction) */
+			VkDeviceSize memoryBeforeCompaction{ 0 };
+			/** @brief Size of all BLAS after compaction */
+			VkDeviceSize memoryAfterCompaction{ 0 };
+			/** @brief Size of the scratch arena shared by all builds of a batch */
+			VkDeviceSize scratchArenaSize{ 0 };
+			/** @brief Size of the persistent scratch buffer used for refits */
+			VkDeviceSize updateScratchSize{ 0 };
+			VkDeviceSize tlasSize{ 0 };
+		} statistics;
+
+		/** @brief Upper limit for the scratch arena, builds are split into batches that fit into it (a single larger build still gets its own arena) */
+		VkDeviceSize scratchBudget{ 32 * 1024 * 1024 };
+
+		void prepare(vks::VulkanDevice* vulkanDevice, VkQueue queue);
+		/** @brief Destroys all acceleration structures and buffers, safe to call if prepare has not been called */
+		void destroy();
+
+		/**
+		* @brief Adds a bottom level acceleration structure that is created with the next call to buildBLAS
+		* @note Geometries and ranges are kept, so device addresses referenced by them (e.g. transform data) must stay valid for refits
+		* @return Handle of the BLAS
+		*/
+		uint32_t addBLAS(const std::vector<VkAccelerationStructureGeometryKHR>& geometries, const std::vector<VkAccelerationStructureBuildRangeInfoKHR>& buildRanges, VkBuildAccelerationStructureFlagsKHR flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR | VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_COMPACTION_BIT_KHR);
+		/**
+		* @brief Builds all BLAS added since the last call and compacts those that allow it, waits for the device to finish
+		* @note BLAS that also allow updates are not compacted, as refits require a destination of at least the size returned for the build
+		*/
+		void buildBLAS();
+		/** @brief Records an update of BLAS that have been built with VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR, e.g. after changing their vertex or transform data */
+		void recordRefit(VkCommandBuffer commandBuffer, const std::vector<uint32_t>& blasHandles);
+		uint64_t getBLASDeviceAddress(uint32_t blasHandle) const;
+
+		/**
+		* @brief Writes the instances to the host visible instance buffer used by the next TLAS build
+		* @return True if the TLAS had to be recreated for a larger instance count, descriptors referencing the old handle need to be updated
+		*/
+		bool setInstances(const std::vector<VkAccelerationStructureInstanceKHR>& instances);
+		/** @brief Records a full rebuild of the TLAS from the instance buffer, followed by a barrier that makes it visible to all later commands */
+		void recordTLASBuild(VkCommandBuffer commandBuffer);
+		/** @brief Builds the TLAS using a one-time command buffer */
+		void buildTLAS();
+		VkAccelerationStructureKHR getTLAS() const;
+
+	private:
+		struct Allocation {
+			VkAccelerationStructureKHR handle{ VK_NULL_HANDLE };
+			uint64_t deviceAddress{ 0 };
+			VkBuffer buffer{ VK_NULL_HANDLE };
+			VkDeviceMemory memory{ VK_NULL_HANDLE };
+			VkDeviceSize size{ 0 };
+		};
+		struct BLAS {
+			Allocation allocation;
+			std::vector<VkAccelerationStructureGeometryKHR> geometries;
+			std::vector<VkAccelerationStructureBuildRangeInfoKHR> buildRanges;
+			VkBuildAccelerationStructureFlagsKHR flags{ 0 };
+			VkAccelerationStructureBuildSizesInfoKHR sizes{};
+			// Offset into the update scratch buffer, only valid for BLAS that allow updates
+			VkDeviceSize updateScratchOffset{ 0 };
+			bool built{ false };
+		};
+
+		vks::VulkanDevice* vulkanDevice{ nullptr };
+		VkQueue queue{ VK_NULL_HANDLE };
+		VkDeviceSize scratchAlignment{ 256 };
+
+		std::vector<BLAS> blas;
+		vks::Buffer updateScratchBuffer;
+
+		struct TLAS {
+			Allocation allocation;
+			vks::Buffer instanceBuffer;
+			vks::Buffer scratchBuffer;
+			uint32_t capacity{ 0 };
+			uint32_t instanceCount{ 0 };
+			VkAccelerationStructureGeometryKHR geometry{};
+		} tlas;
+
+		PFN_vkGetBufferDeviceAddressKHR vkGetBufferDeviceAddressKHR{ nullptr };
+		PFN_vkCreateAccelerationStructureKHR vkCreateAccelerationStructureKHR{ nullptr };
+		PFN_vkDestroyAccelerationStructureKHR vkDestroyAccelerationStructureKHR{ nullptr };
+		PFN_vkGetAccelerationStructureBuildSizesKHR vkGetAccelerationStructureBuildSizesKHR{ nullptr };
+		PFN_vkGetAccelerationStructureDeviceAddressKHR vkGetAccelerationStructureDeviceAddressKHR{ nullptr };
+		PFN_vkCmdBuildAccelerationStructuresKHR vkCmdBuildAccelerationStructuresKHR{ nullptr };
+		PFN_vkCmdWriteAccelerationStructuresPropertiesKHR vkCmdWriteAccelerationStructuresPropertiesKHR{ nullptr };
+		PFN_vkCmdCopyAccelerationStructureKHR vkCmdCopyAccelerationStructureKHR{ nullptr };
+
+		void createAllocation(Allocation& allocation, VkAccelerationStructureTypeKHR type, VkDeviceSize size);
+		void destroyAllocation(Allocation& allocation);
+		void createScratchBuffer(vks::Buffer& buffer, VkDeviceSize size);
+		uint64_t getBufferDeviceAddress(VkBuffer buffer) const;
+		VkAccelerationStructureBuildGeometryInfoKHR getBuildGeometryInfo(const BLAS& blas) const;
+		void insertBuildBarrier(VkCommandBuffer commandBuffer, VkPipelineStageFlags dstStageMask, VkAccessFlags dstAccessMask) const;
+	};
+}
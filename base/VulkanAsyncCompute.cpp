@@ -0,0 +1,414 @@
+/*
+* Vulkan async compute scheduler
+*
+* Schedules compute and graphics workloads on separate queues, deriving queue family ownership transfers
+* and timeline semaphore waits from declared buffer dependencies
+*
+* Copyright (C) 2025 by Sascha Willems - www.saschawillems.de
+*
+* This code is licensed under the MIT license (MIT) (http://opensource.org/licenses/MIT)
+*/
+
+#include "VulkanAsyncCompute.h"
+
+namespace vks
+{
+	/**
+	* Create the command buffers, timeline semaphores and timestamp queries used by the scheduler
+	*
+	* @param vulkanDevice Device the workloads are run on (the timeline semaphore feature must have been enabled at device creation)
+	* @param graphicsQueue Queue graphics workloads are submitted to
+	* @param computeQueue Queue compute workloads are submitted to (may be the same as the graphics queue)
+	* @param framesInFlight Number of frames whose workloads may be in flight at the same time
+	*/
+	void AsyncComputeScheduler::prepare(vks::VulkanDevice* vulkanDevice, VkQueue graphicsQueue, VkQueue computeQueue, uint32_t framesInFlight)
+	{
+		this->vulkanDevice = vulkanDevice;
+		this->device = vulkanDevice->logicalDevice;
+		this->graphicsQueue = graphicsQueue;
+		this->computeQueue = computeQueue;
+		this->framesInFlight = framesInFlight;
+		graphicsFamily = vulkanDevice->queueFamilyIndices.graphics;
+		computeFamily = vulkanDevice->queueFamilyIndices.compute;
+
+		// Compute command buffers are allocated from a separate pool, as the queue family may differ from the one used for graphics
+		computeCommandPool = vulkanDevice->createCommandPool(computeFamily);
+		computeCommandBuffers.resize(framesInFlight);
+		VkCommandBufferAllocateInfo cmdBufAllocateInfo = vks::initializers::commandBufferAllocateInfo(computeCommandPool, VK_COMMAND_BUFFER_LEVEL_PRIMARY, framesInFlight);
+		VK_CHECK_RESULT(vkAllocateCommandBuffers(device, &cmdBufAllocateInfo, computeCommandBuffers.data()));
+
+		// Separate timelines for compute and graphics, as workloads of different frames may finish out of order across the two queues
+		VkSemaphoreTypeCreateInfoKHR semaphoreTypeCI{};
+		semaphoreTypeCI.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR;
+		semaphoreTypeCI.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+		semaphoreTypeCI.initialValue = 0;
+		VkSemaphoreCreateInfo semaphoreCI = vks::initializers::semaphoreCreateInfo();
+		semaphoreCI.pNext = &semaphoreTypeCI;
+		VK_CHECK_RESULT(vkCreateSemaphore(device, &semaphoreCI, nullptr, &computeTimeline.handle));
+		VK_CHECK_RESULT(vkCreateSemaphore(device, &semaphoreCI, nullptr, &graphicsTimeline.handle));
+
+		vkWaitSemaphoresKHR = reinterpret_cast<PFN_vkWaitSemaphoresKHR>(vkGetDeviceProcAddr(device, "vkWaitSemaphoresKHR"));
+		if (!vkWaitSemaphoresKHR) {
+			vkWaitSemaphoresKHR = reinterpret_cast<PFN_vkWaitSemaphoresKHR>(vkGetDeviceProcAddr(device, "vkWaitSemaphores"));
+		}
+		assert(vkWaitSemaphoresKHR);
+
+		// Timestamps are only written if both queue families support them
+		timestampsSupported = (vulkanDevice->queueFamilyProperties[graphicsFamily].timestampValidBits > 0) && (vulkanDevice->queueFamilyProperties[computeFamily].timestampValidBits > 0);
+		if (timestampsSupported) {
+			timestampPeriod = vulkanDevice->properties.limits.timestampPeriod;
+			// Four queries per frame in flight: compute begin/end, graphics begin/end
+			VkQueryPoolCreateInfo queryPoolCI{};
+			queryPoolCI.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+			queryPoolCI.queryType = VK_QUERY_TYPE_TIMESTAMP;
+			queryPoolCI.queryCount = framesInFlight * 4;
+			VK_CHECK_RESULT(vkCreateQueryPool(device, &queryPoolCI, nullptr, &queryPool));
+			queriesWritten.resize(framesInFlight, false);
+		}
+	}
+
+	/**
+	* Release all Vulkan resources held by the scheduler
+	*
+	* @note Registered buffers are owned by the application and are not destroyed
+	*/
+	void AsyncComputeScheduler::destroy()
+	{
+		if (device == VK_NULL_HANDLE) {
+			return;
+		}
+		vkDestroySemaphore(device, computeTimeline.handle, nullptr);
+		vkDestroySemaphore(device, graphicsTimeline.handle, nullptr);
+		vkDestroyCommandPool(device, computeCommandPool, nullptr);
+		if (queryPool != VK_NULL_HANDLE) {
+			vkDestroyQueryPool(device, queryPool, nullptr);
+		}
+		resources.clear();
+		device = VK_NULL_HANDLE;
+	}
+
+	uint32_t AsyncComputeScheduler::addBuffer(const std::vector<VkBuffer>& buffers, VkDeviceSize size)
+	{
+		assert((buffers.size() == 1) || (buffers.size() == framesInFlight));
+		Resource resource{};
+		resource.buffers = buffers;
+		resource.size = size;
+		// Freshly created buffers are not owned by any queue family, so their first use doesn't need an acquire operation
+		resource.owner.resize(buffers.size(), VK_QUEUE_FAMILY_IGNORED);
+		resources.push_back(resource);
+		return static_cast<uint32_t>(resources.size() - 1);
+	}
+
+	void AsyncComputeScheduler::declareAccess(uint32_t resource, WorkloadQueue queue, VkPipelineStageFlags stageMask, VkAccessFlags accessMask)
+	{
+		Access& access = resources[resource].access[queueIndex(queue)];
+		access.used = true;
+		access.stageMask |= stageMask;
+		access.accessMask |= accessMask;
+	}
+
+	VkBuffer AsyncComputeScheduler::getBuffer(uint32_t resource, uint64_t frameIndex) const
+	{
+		const Resource& res = resources[resource];
+		return res.buffers[bufferIndex(res, frameIndex)];
+	}
+
+	uint32_t AsyncComputeScheduler::getSlot(uint64_t frameIndex) const
+	{
+		return static_cast<uint32_t>(frameIndex % framesInFlight);
+	}
+
+	uint32_t AsyncComputeScheduler::bufferIndex(const Resource& resource, uint64_t frameIndex) const
+	{
+		return static_cast<uint32_t>(frameIndex % resource.buffers.size());
+	}
+
+	void AsyncComputeScheduler::waitTimeline(const TimelineSemaphore& timeline, uint64_t value)
+	{
+		VkSemaphoreWaitInfoKHR waitInfo{};
+		waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR;
+		waitInfo.semaphoreCount = 1;
+		waitInfo.pSemaphores = &timeline.handle;
+		waitInfo.pValues = &value;
+		VK_CHECK_RESULT(vkWaitSemaphoresKHR(device, &waitInfo, UINT64_MAX));
+	}
+
+	/**
+	* Insert the barriers required before the workload on the given queue accesses its resources
+	*
+	* Buffers last owned by the other queue family get an acquire operation matching the release recorded by that queue,
+	* buffers only ever used by this queue get a regular memory barrier against the previous frame's accesses
+	*/
+	void AsyncComputeScheduler::recordAcquireBarriers(VkCommandBuffer commandBuffer, WorkloadQueue queue, uint64_t frameIndex)
+	{
+		const uint32_t q = queueIndex(queue);
+		const uint32_t family = familyIndex(queue);
+		std::vector<VkBufferMemoryBarrier> barriers;
+		VkPipelineStageFlags srcStageMask = 0;
+		VkPipelineStageFlags dstStageMask = 0;
+		for (auto& resource : resources) {
+			const Access& access = resource.access[q];
+			if (!access.used) {
+				continue;
+			}
+			const uint32_t index = bufferIndex(resource, frameIndex);
+			const bool sharedWithOtherQueue = resource.access[1 - q].used;
+			VkBufferMemoryBarrier barrier = vks::initializers::bufferMemoryBarrier();
+			barrier.buffer = resource.buffers[index];
+			barrier.offset = 0;
+			barrier.size = resource.size;
+			barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			if (sharedWithOtherQueue && (graphicsFamily != computeFamily) && (resource.owner[index] != VK_QUEUE_FAMILY_IGNORED) && (resource.owner[index] != family)) {
+				// Acquire, the source access mask is ignored for this half of the ownership transfer
+				barrier.srcAccessMask = 0;
+				barrier.dstAccessMask = access.accessMask;
+				barrier.srcQueueFamilyIndex = resource.owner[index];
+				barrier.dstQueueFamilyIndex = family;
+				srcStageMask |= VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+				ownershipTransfers++;
+			} else if (!sharedWithOtherQueue && (resource.owner[index] == family)) {
+				// Only used by this queue: make the previous frame's writes visible (cross-queue accesses are covered by the semaphore waits)
+				barrier.srcAccessMask = access.accessMask;
+				barrier.dstAccessMask = access.accessMask;
+				srcStageMask |= access.stageMask;
+			} else {
+				resource.owner[index] = family;
+				continue;
+			}
+			dstStageMask |= access.stageMask;
+			barriers.push_back(barrier);
+			resource.owner[index] = family;
+		}
+		if (!barriers.empty()) {
+			vkCmdPipelineBarrier(commandBuffer, srcStageMask, dstStageMask, 0, 0, nullptr, static_cast<uint32_t>(barriers.size()), barriers.data(), 0, nullptr);
+		}
+	}
+
+	/**
+	* Insert the release operations for all buffers that are handed over to the other queue family
+	*/
+	void AsyncComputeScheduler::recordReleaseBarriers(VkCommandBuffer commandBuffer, WorkloadQueue queue, uint64_t frameIndex)
+	{
+		if (graphicsFamily == computeFamily) {
+			return;
+		}
+		const uint32_t q = queueIndex(queue);
+		const uint32_t family = familyIndex(queue);
+		const uint32_t otherFamily = (queue == WorkloadQueue::Graphics) ? computeFamily : graphicsFamily;
+		std::vector<VkBufferMemoryBarrier> barriers;
+		VkPipelineStageFlags srcStageMask = 0;
+		for (auto& resource : resources) {
+			if (!resource.access[q].used || !resource.access[1 - q].used) {
+				continue;
+			}
+			const uint32_t index = bufferIndex(resource, frameIndex);
+			// Release, the destination access mask is ignored for this half of the ownership transfer
+			VkBufferMemoryBarrier barrier = vks::initializers::bufferMemoryBarrier();
+			barrier.buffer = resource.buffers[index];
+			barrier.offset = 0;
+			barrier.size = resource.size;
+			barrier.srcAccessMask = resource.access[q].accessMask;
+			barrier.dstAccessMask = 0;
+			barrier.srcQueueFamilyIndex = family;
+			barrier.dstQueueFamilyIndex = otherFamily;
+			srcStageMask |= resource.access[q].stageMask;
+			barriers.push_back(barrier);
+			ownershipTransfers++;
+		}
+		if (!barriers.empty()) {
+			vkCmdPipelineBarrier(commandBuffer, srcStageMask, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, static_cast<uint32_t>(barriers.size()), barriers.data(), 0, nullptr);
+		}
+	}
+
+	/**
+	* Read back the timestamps of a completed frame and update the statistics
+	*
+	* The overlap is estimated between the compute workload of this frame and the graphics workload of the previous frame,
+	* which is the pair that is allowed to run concurrently
+	* @note This compares timestamps written by different queues, which the spec doesn't guarantee to be comparable, so the result is only an estimate
+	*/
+	void AsyncComputeScheduler::collectTimestamps(uint32_t slot, uint64_t frameIndex)
+	{
+		if (!timestampsSupported || !queriesWritten[slot]) {
+			return;
+		}
+		waitTimeline(graphicsTimeline, graphicsSignalValue(frameIndex));
+		std::array<uint64_t, 4> timestamps{};
+		VkResult result = vkGetQueryPoolResults(device, queryPool, slot * 4, 4, sizeof(uint64_t) * timestamps.size(), timestamps.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
+		if (result != VK_SUCCESS) {
+			return;
+		}
+		FrameTimestamps current{};
+		current.frameIndex = frameIndex;
+		current.computeBegin = timestamps[0];
+		current.computeEnd = timestamps[1];
+		current.graphicsBegin = timestamps[2];
+		current.graphicsEnd = timestamps[3];
+		current.valid = true;
+
+		const float toMs = timestampPeriod / 1000000.0f;
+		statistics.computeTime = static_cast<float>(current.computeEnd - current.computeBegin) * toMs;
+		statistics.graphicsTime = static_cast<float>(current.graphicsEnd - current.graphicsBegin) * toMs;
+		if (previousTimestamps.valid && (previousTimestamps.frameIndex + 1 == frameIndex) && (current.computeEnd > current.computeBegin)) {
+			const uint64_t overlapBegin = std::max(current.computeBegin, previousTimestamps.graphicsBegin);
+			const uint64_t overlapEnd = std::min(current.computeEnd, previousTimestamps.graphicsEnd);
+			const float overlap = (overlapEnd > overlapBegin) ? static_cast<float>(overlapEnd - overlapBegin) / static_cast<float>(current.computeEnd - current.computeBegin) : 0.0f;
+			// Smooth the value, as the relative timing of the queues varies from frame to frame
+			statistics.overlapEstimate = statistics.available ? (statistics.overlapEstimate * 0.9f + overlap * 0.1f) : overlap;
+			statistics.available = true;
+		}
+		previousTimestamps = current;
+	}
+
+	void AsyncComputeScheduler::beginFrame()
+	{
+		// The graphics workload of a frame and the compute workload of the next one may be recorded in any order, so the counter is only reset here
+		lastOwnershipTransfers = ownershipTransfers;
+		ownershipTransfers = 0;
+	}
+
+	VkCommandBuffer AsyncComputeScheduler::beginCompute(uint64_t frameIndex)
+	{
+		const uint32_t slot = getSlot(frameIndex);
+		if (frameIndex >= framesInFlight) {
+			// The command buffer of this slot may only be reused once the compute workload that used it last has finished
+			waitTimeline(computeTimeline, computeSignalValue(frameIndex - framesInFlight));
+			collectTimestamps(slot, frameIndex - framesInFlight);
+		}
+
+		VkCommandBuffer commandBuffer = computeCommandBuffers[slot];
+		VK_CHECK_RESULT(vkResetCommandBuffer(commandBuffer, 0));
+		VkCommandBufferBeginInfo cmdBufInfo = vks::initializers::commandBufferBeginInfo();
+		cmdBufInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		VK_CHECK_RESULT(vkBeginCommandBuffer(commandBuffer, &cmdBufInfo));
+		if (timestampsSupported) {
+			vkCmdResetQueryPool(commandBuffer, queryPool, slot * 4, 2);
+			vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool, slot * 4);
+		}
+		recordAcquireBarriers(commandBuffer, WorkloadQueue::Compute, frameIndex);
+		return commandBuffer;
+	}
+
+	void AsyncComputeScheduler::endCompute(uint64_t frameIndex)
+	{
+		const uint32_t slot = getSlot(frameIndex);
+		VkCommandBuffer commandBuffer = computeCommandBuffers[slot];
+		recordReleaseBarriers(commandBuffer, WorkloadQueue::Compute, frameIndex);
+		if (timestampsSupported) {
+			vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool, slot * 4 + 1);
+		}
+		VK_CHECK_RESULT(vkEndCommandBuffer(commandBuffer));
+	}
+
+	void AsyncComputeScheduler::submitCompute(uint64_t frameIndex)
+	{
+		// Compute only has to wait for graphics workloads that still access one of its buffers
+		// With one buffer per frame in flight, that's the graphics workload submitted framesInFlight frames earlier
+		uint64_t waitValue = 0;
+		VkPipelineStageFlags waitStageMask = 0;
+		for (auto& resource : resources) {
+			if (!resource.access[0].used || !resource.access[1].used) {
+				continue;
+			}
+			const uint64_t distance = resource.buffers.size();
+			if (frameIndex >= distance) {
+				waitValue = std::max(waitValue, graphicsSignalValue(frameIndex - distance));
+			}
+			waitStageMask |= resource.access[1].stageMask;
+		}
+
+		const uint64_t signalValue = computeSignalValue(frameIndex);
+		VkTimelineSemaphoreSubmitInfoKHR timelineSubmitInfo{};
+		timelineSubmitInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+		timelineSubmitInfo.signalSemaphoreValueCount = 1;
+		timelineSubmitInfo.pSignalSemaphoreValues = &signalValue;
+
+		VkSubmitInfo submitInfo = vks::initializers::submitInfo();
+		submitInfo.pNext = &timelineSubmitInfo;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &computeCommandBuffers[getSlot(frameIndex)];
+		submitInfo.signalSemaphoreCount = 1;
+		submitInfo.pSignalSemaphores = &computeTimeline.handle;
+		if (waitValue > 0) {
+			timelineSubmitInfo.waitSemaphoreValueCount = 1;
+			timelineSubmitInfo.pWaitSemaphoreValues = &waitValue;
+			submitInfo.waitSemaphoreCount = 1;
+			submitInfo.pWaitSemaphores = &graphicsTimeline.handle;
+			submitInfo.pWaitDstStageMask = &waitStageMask;
+		}
+		VK_CHECK_RESULT(vkQueueSubmit(computeQueue, 1, &submitInfo, VK_NULL_HANDLE));
+		computeTimeline.value = signalValue;
+	}
+
+	void AsyncComputeScheduler::beginGraphics(VkCommandBuffer commandBuffer, uint64_t frameIndex)
+	{
+		const uint32_t slot = getSlot(frameIndex);
+		if (timestampsSupported) {
+			vkCmdResetQueryPool(commandBuffer, queryPool, slot * 4 + 2, 2);
+			vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool, slot * 4 + 2);
+		}
+		recordAcquireBarriers(commandBuffer, WorkloadQueue::Graphics, frameIndex);
+	}
+
+	void AsyncComputeScheduler::endGraphics(VkCommandBuffer commandBuffer, uint64_t frameIndex)
+	{
+		recordReleaseBarriers(commandBuffer, WorkloadQueue::Graphics, frameIndex);
+		if (timestampsSupported) {
+			vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool, getSlot(frameIndex) * 4 + 3);
+		}
+	}
+
+	void AsyncComputeScheduler::submitGraphics(VkCommandBuffer commandBuffer, uint64_t frameIndex, VkSemaphore waitSemaphore, VkPipelineStageFlags waitStageMask, VkSemaphore signalSemaphore, VkFence fence)
+	{
+		// Graphics always waits for the compute workload of the same frame
+		VkPipelineStageFlags computeWaitStageMask = 0;
+		for (auto& resource : resources) {
+			if (resource.access[0].used) {
+				computeWaitStageMask |= resource.access[0].stageMask;
+			}
+		}
+		if (computeWaitStageMask == 0) {
+			computeWaitStageMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+		}
+
+		// Binary semaphores can be mixed with timeline semaphores, their values are ignored
+		std::vector<VkSemaphore> waitSemaphores = { computeTimeline.handle };
+		std::vector<uint64_t> waitValues = { computeSignalValue(frameIndex) };
+		std::vector<VkPipelineStageFlags> waitStageMasks = { computeWaitStageMask };
+		if (waitSemaphore != VK_NULL_HANDLE) {
+			waitSemaphores.push_back(waitSemaphore);
+			waitValues.push_back(0);
+			waitStageMasks.push_back(waitStageMask);
+		}
+		std::vector<VkSemaphore> signalSemaphores = { graphicsTimeline.handle };
+		std::vector<uint64_t> signalValues = { graphicsSignalValue(frameIndex) };
+		if (signalSemaphore != VK_NULL_HANDLE) {
+			signalSemaphores.push_back(signalSemaphore);
+			signalValues.push_back(0);
+		}
+
+		VkTimelineSemaphoreSubmitInfoKHR timelineSubmitInfo{};
+		timelineSubmitInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+		timelineSubmitInfo.waitSemaphoreValueCount = static_cast<uint32_t>(waitValues.size());
+		timelineSubmitInfo.pWaitSemaphoreValues = waitValues.data();
+		timelineSubmitInfo.signalSemaphoreValueCount = static_cast<uint32_t>(signalValues.size());
+		timelineSubmitInfo.pSignalSemaphoreValues = signalValues.data();
+
+		VkSubmitInfo submitInfo = vks::initializers::submitInfo();
+		submitInfo.pNext = &timelineSubmitInfo;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &commandBuffer;
+		submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
+		submitInfo.pWaitSemaphores = waitSemaphores.data();
+		submitInfo.pWaitDstStageMask = waitStageMasks.data();
+		submitInfo.signalSemaphoreCount = static_cast<uint32_t>(signalSemaphores.size());
+		submitInfo.pSignalSemaphores = signalSemaphores.data();
+		VK_CHECK_RESULT(vkQueueSubmit(graphicsQueue, 1, &submitInfo, fence));
+		graphicsTimeline.value = graphicsSignalValue(frameIndex);
+
+		if (timestampsSupported) {
+			queriesWritten[getSlot(frameIndex)] = true;
+		}
+	}
+}
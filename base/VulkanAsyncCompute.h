@@ -0,0 +1,149 @@
+/*
+* Vulkan async compute scheduler
+*
+* Schedules compute and graphics workloads on separate queues, deriving queue family ownership transfers
+* and timeline semaphore waits from declared buffer dependencies
+*
+* Copyright (C) 2025 by Sascha Willems - www.saschawillems.de
+*
+* This code is licensed under the MIT license (MIT) (http://opensource.org/licenses/MIT)
+*/
+
+#pragma once
+
+#include <vector>
+#include <array>
+
+#include "vulkan/vulkan.h"
+#include "VulkanDevice.h"
+#include "VulkanTools.h"
+
+namespace vks
+{
+	/** @brief Queue type a workload is executed on */
+	enum class WorkloadQueue { Graphics, Compute };
+
+	/**
+	* @brief Schedules a compute and a graphics workload per frame on different queues
+	* @note Compute for frame N+1 can be submitted while graphics for frame N is still executing, as long as the resources it touches
+	* are not in use by that graphics workload (e.g. by declaring one buffer copy per frame in flight)
+	* @note Requires VK_KHR_timeline_semaphore (or Vulkan 1.2) with the timelineSemaphore feature enabled
+	*/
+	class AsyncComputeScheduler
+	{
+	public:
+		/** @brief GPU timings of the last completed frame (in milliseconds) and an estimate of the overlap of compute with the preceding graphics workload */
+		struct Statistics {
+			float computeTime{ 0.0f };
+			float graphicsTime{ 0.0f };
+			/**
+			* @brief Estimated fraction of the compute workload's GPU time that overlapped the graphics workload of the previous frame (0..1)
+			* @note Timestamps are only guaranteed to be comparable if written by the same queue, so this assumes that both queues share one time base (which is the case on common implementations, but not required by the spec)
+			*/
+			float overlapEstimate{ 0.0f };
+			bool available{ false };
+		} statistics;
+
+		/** @brief Number of frames the scheduler keeps in flight */
+		uint32_t framesInFlight{ 2 };
+
+		VkQueue graphicsQueue{ VK_NULL_HANDLE };
+		VkQueue computeQueue{ VK_NULL_HANDLE };
+
+		void prepare(vks::VulkanDevice* vulkanDevice, VkQueue graphicsQueue, VkQueue computeQueue, uint32_t framesInFlight = 2);
+		void destroy();
+
+		/**
+		* @brief Registers a buffer shared between the workloads
+		* @param buffers Either a single buffer or one buffer per frame in flight (the buffer for a frame is selected by frame index)
+		* @return Handle of the resource used to declare accesses
+		*/
+		uint32_t addBuffer(const std::vector<VkBuffer>& buffers, VkDeviceSize size = VK_WHOLE_SIZE);
+		/** @brief Declares how a workload on the given queue accesses a registered resource */
+		void declareAccess(uint32_t resource, WorkloadQueue queue, VkPipelineStageFlags stageMask, VkAccessFlags accessMask);
+
+		/** @brief Returns the buffer of a registered resource used by the given frame */
+		VkBuffer getBuffer(uint32_t resource, uint64_t frameIndex) const;
+		/** @brief Returns the index of the frame in flight slot used by the given frame */
+		uint32_t getSlot(uint64_t frameIndex) const;
+
+		/** @brief Starts a new frame, must be called once per frame before any of its workloads are recorded */
+		void beginFrame();
+		/** @brief Waits (on the host) until the compute workload that last used the slot of the given frame has finished, then starts recording the compute command buffer */
+		VkCommandBuffer beginCompute(uint64_t frameIndex);
+		/** @brief Ends recording of the compute command buffer */
+		void endCompute(uint64_t frameIndex);
+		/** @brief Submits the compute workload, waiting on all graphics workloads that still access its resources */
+		void submitCompute(uint64_t frameIndex);
+
+		/** @brief Adds acquire barriers and the begin timestamp to the graphics command buffer (must be called outside of a render pass) */
+		void beginGraphics(VkCommandBuffer commandBuffer, uint64_t frameIndex);
+		/** @brief Adds release barriers and the end timestamp to the graphics command buffer (must be called outside of a render pass) */
+		void endGraphics(VkCommandBuffer commandBuffer, uint64_t frameIndex);
+
+		/** @brief Submits the graphics workload, waiting for the compute workload of the same frame in addition to the (optional) binary semaphores */
+		void submitGraphics(VkCommandBuffer commandBuffer, uint64_t frameIndex, VkSemaphore waitSemaphore = VK_NULL_HANDLE, VkPipelineStageFlags waitStageMask = 0, VkSemaphore signalSemaphore = VK_NULL_HANDLE, VkFence fence = VK_NULL_HANDLE);
+
+		/** @brief Returns the number of queue family ownership barriers recorded for the last complete frame */
+		uint32_t getOwnershipTransferCount() const { return lastOwnershipTransfers; }
+		/** @brief True if graphics and compute are executed on different queue families */
+		bool separateQueueFamilies() const { return graphicsFamily != computeFamily; }
+
+	private:
+		struct Access {
+			bool used{ false };
+			VkPipelineStageFlags stageMask{ 0 };
+			VkAccessFlags accessMask{ 0 };
+		};
+		struct Resource {
+			std::vector<VkBuffer> buffers;
+			VkDeviceSize size{ VK_WHOLE_SIZE };
+			// Index 0 = graphics, 1 = compute
+			std::array<Access, 2> access{};
+			// Queue family that currently owns each buffer of the resource (at the time of recording)
+			std::vector<uint32_t> owner;
+		};
+		struct TimelineSemaphore {
+			VkSemaphore handle{ VK_NULL_HANDLE };
+			// Last value that has been submitted for signaling
+			uint64_t value{ 0 };
+		};
+		struct FrameTimestamps {
+			uint64_t frameIndex{ 0 };
+			uint64_t computeBegin{ 0 }, computeEnd{ 0 };
+			uint64_t graphicsBegin{ 0 }, graphicsEnd{ 0 };
+			bool valid{ false };
+		};
+
+		vks::VulkanDevice* vulkanDevice{ nullptr };
+		VkDevice device{ VK_NULL_HANDLE };
+		uint32_t graphicsFamily{ 0 };
+		uint32_t computeFamily{ 0 };
+		VkCommandPool computeCommandPool{ VK_NULL_HANDLE };
+		std::vector<VkCommandBuffer> computeCommandBuffers;
+		std::vector<Resource> resources;
+		TimelineSemaphore computeTimeline;
+		TimelineSemaphore graphicsTimeline;
+		PFN_vkWaitSemaphoresKHR vkWaitSemaphoresKHR{ nullptr };
+
+		VkQueryPool queryPool{ VK_NULL_HANDLE };
+		bool timestampsSupported{ false };
+		float timestampPeriod{ 1.0f };
+		std::vector<bool> queriesWritten;
+		FrameTimestamps previousTimestamps;
+		// Barriers recorded since the last call to beginFrame, and the total of the frame before that
+		uint32_t ownershipTransfers{ 0 };
+		uint32_t lastOwnershipTransfers{ 0 };
+
+		// Per frame: the compute workload signals computeTimeline = frame + 1, the graphics workload signals graphicsTimeline = frame + 1
+		uint64_t computeSignalValue(uint64_t frameIndex) const { return frameIndex + 1; }
+		uint64_t graphicsSignalValue(uint64_t frameIndex) const { return frameIndex + 1; }
+		uint32_t bufferIndex(const Resource& resource, uint64_t frameIndex) const;
+		uint32_t queueIndex(WorkloadQueue queue) const { return queue == WorkloadQueue::Graphics ? 0 : 1; }
+		uint32_t familyIndex(WorkloadQueue queue) const { return queue == WorkloadQueue::Graphics ? graphicsFamily : computeFamily; }
+		void recordAcquireBarriers(VkCommandBuffer commandBuffer, WorkloadQueue queue, uint64_t frameIndex);
+		void recordReleaseBarriers(VkCommandBuffer commandBuffer, WorkloadQueue queue, uint64_t frameIndex);
+		void waitTimeline(const TimelineSemaphore& timeline, uint64_t value);
+		void collectTimestamps(uint32_t slot, uint64_t frameIndex);
+	};
+}
@@ -0,0 +1,175 @@
+/*
+* Vulkan descriptor buffer
+*
+* Copyright (C) 2025 by Sascha Willems - www.saschawillems.de
+*
+* This code is licensed under the MIT license (MIT) (http://opensource.org/licenses/MIT)
+*/
+
+#include "VulkanDescriptorBuffer.h"
+
+namespace vks
+{
+	bool DescriptorBuffer::supported(vks::VulkanDevice* vulkanDevice)
+	{
+		if (!vulkanDevice->extensionSupported(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME)) {
+			return false;
+		}
+		// The extension may be exposed without the features being supported
+		VkPhysicalDeviceBufferDeviceAddressFeatures bufferDeviceAddressFeatures{};
+		bufferDeviceAddressFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_BUFFER_DEVICE_ADDRESS_FEATURES;
+		VkPhysicalDeviceDescriptorBufferFeaturesEXT descriptorBufferFeatures{};
+		descriptorBufferFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT;
+		descriptorBufferFeatures.pNext = &bufferDeviceAddressFeatures;
+		VkPhysicalDeviceFeatures2 deviceFeatures2{};
+		deviceFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		deviceFeatures2.pNext = &descriptorBufferFeatures;
+		vkGetPhysicalDeviceFeatures2(vulkanDevice->physicalDevice, &deviceFeatures2);
+		return descriptorBufferFeatures.descriptorBuffer && bufferDeviceAddressFeatures.bufferDeviceAddress;
+	}
+
+	void DescriptorBuffer::create(vks::VulkanDevice* vulkanDevice, VkDescriptorSetLayout setLayout, uint32_t bindingCount, uint32_t maxSets, bool samplers)
+	{
+		this->vulkanDevice = vulkanDevice;
+		this->maxSets = maxSets;
+		VkDevice device = vulkanDevice->logicalDevice;
+
+		vkGetBufferDeviceAddressKHR = reinterpret_cast<PFN_vkGetBufferDeviceAddressKHR>(vkGetDeviceProcAddr(device, "vkGetBufferDeviceAddressKHR"));
+		vkGetDescriptorSetLayoutSizeEXT = reinterpret_cast<PFN_vkGetDescriptorSetLayoutSizeEXT>(vkGetDeviceProcAddr(device, "vkGetDescriptorSetLayoutSizeEXT"));
+		vkGetDescriptorSetLayoutBindingOffsetEXT = reinterpret_cast<PFN_vkGetDescriptorSetLayoutBindingOffsetEXT>(vkGetDeviceProcAddr(device, "vkGetDescriptorSetLayoutBindingOffsetEXT"));
+		vkGetDescriptorEXT = reinterpret_cast<PFN_vkGetDescriptorEXT>(vkGetDeviceProcAddr(device, "vkGetDescriptorEXT"));
+		vkCmdBindDescriptorBuffersEXT = reinterpret_cast<PFN_vkCmdBindDescriptorBuffersEXT>(vkGetDeviceProcAddr(device, "vkCmdBindDescriptorBuffersEXT"));
+		vkCmdSetDescriptorBufferOffsetsEXT = reinterpret_cast<PFN_vkCmdSetDescriptorBufferOffsetsEXT>(vkGetDeviceProcAddr(device, "vkCmdSetDescriptorBufferOffsetsEXT"));
+
+		properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT;
+		VkPhysicalDeviceProperties2 deviceProperties2{};
+		deviceProperties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+		deviceProperties2.pNext = &properties;
+		vkGetPhysicalDeviceProperties2(vulkanDevice->physicalDevice, &deviceProperties2);
+
+		// Offsets of sets in the buffer need to be aligned, so each set occupies the layout's size rounded up to the alignment
+		vkGetDescriptorSetLayoutSizeEXT(device, setLayout, &setSize);
+		setSize = vks::tools::alignedVkSize(setSize, properties.descriptorBufferOffsetAlignment);
+		bindingOffsets.resize(bindingCount);
+		for (uint32_t i = 0; i < bindingCount; i++) {
+			vkGetDescriptorSetLayoutBindingOffsetEXT(device, setLayout, i, &bindingOffsets[i]);
+		}
+
+		// Combined image samplers contain a sampler, so they need to be stored in a buffer that is also a sampler descriptor buffer
+		usage = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT;
+		if (samplers) {
+			usage |= VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT;
+		}
+		VK_CHECK_RESULT(vulkanDevice->createBuffer(
+			usage | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			&buffer,
+			std::max(setSize * maxSets, setSize)));
+		VK_CHECK_RESULT(buffer.map());
+
+		VkBufferDeviceAddressInfoKHR bufferDeviceAddressInfo{};
+		bufferDeviceAddressInfo.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
+		bufferDeviceAddressInfo.buffer = buffer.buffer;
+		deviceAddress = vkGetBufferDeviceAddressKHR(device, &bufferDeviceAddressInfo);
+		setCount = 0;
+	}
+
+	void DescriptorBuffer::destroy()
+	{
+		if (!vulkanDevice) {
+			return;
+		}
+		buffer.destroy();
+		bindingOffsets.clear();
+		vulkanDevice = nullptr;
+	}
+
+	uint32_t DescriptorBuffer::allocate()
+	{
+		const uint32_t set = setCount.fetch_add(1, std::memory_order_relaxed);
+		if (set >= maxSets) {
+			vks::tools::exitFatal("Descriptor buffer ran out of space, it has been created for " + std::to_string(maxSets) + " sets", -1);
+		}
+		return set;
+	}
+
+	void DescriptorBuffer::reset()
+	{
+		setCount = 0;
+	}
+
+	uint32_t DescriptorBuffer::getSetCount() const
+	{
+		return std::min(setCount.load(std::memory_order_relaxed), maxSets);
+	}
+
+	void* DescriptorBuffer::getDescriptorPointer(uint32_t set, uint32_t binding, uint32_t arrayElement, size_t descriptorSize) const
+	{
+		assert((set < maxSets) && (binding < bindingOffsets.size()));
+		// Elements of an array binding are tightly packed using the descriptor type's size
+		return static_cast<uint8_t*>(buffer.mapped) + set * setSize + bindingOffsets[binding] + arrayElement * descriptorSize;
+	}
+
+	void DescriptorBuffer::writeBuffer(uint32_t set, uint32_t binding, VkDescriptorType type, size_t descriptorSize, const VkDescriptorBufferInfo& bufferInfo, uint32_t arrayElement)
+	{
+		// Buffer descriptors are created from device addresses
+		VkBufferDeviceAddressInfoKHR bufferDeviceAddressInfo{};
+		bufferDeviceAddressInfo.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
+		bufferDeviceAddressInfo.buffer = bufferInfo.buffer;
+		VkDescriptorAddressInfoEXT descriptorAddressInfo{};
+		descriptorAddressInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT;
+		descriptorAddressInfo.address = vkGetBufferDeviceAddressKHR(vulkanDevice->logicalDevice, &bufferDeviceAddressInfo) + bufferInfo.offset;
+		descriptorAddressInfo.range = bufferInfo.range;
+		descriptorAddressInfo.format = VK_FORMAT_UNDEFINED;
+
+		VkDescriptorGetInfoEXT descriptorInfo{};
+		descriptorInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT;
+		descriptorInfo.type = type;
+		if (type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER) {
+			descriptorInfo.data.pUniformBuffer = &descriptorAddressInfo;
+		}
+		else {
+			descriptorInfo.data.pStorageBuffer = &descriptorAddressInfo;
+		}
+		vkGetDescriptorEXT(vulkanDevice->logicalDevice, &descriptorInfo, descriptorSize, getDescriptorPointer(set, binding, arrayElement, descriptorSize));
+	}
+
+	void DescriptorBuffer::writeUniformBuffer(uint32_t set, uint32_t binding, const VkDescriptorBufferInfo& bufferInfo, uint32_t arrayElement)
+	{
+		writeBuffer(set, binding, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, properties.uniformBufferDescriptorSize, bufferInfo, arrayElement);
+	}
+
+	void DescriptorBuffer::writeStorageBuffer(uint32_t set, uint32_t binding, const VkDescriptorBufferInfo& bufferInfo, uint32_t arrayElement)
+	{
+		writeBuffer(set, binding, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, properties.storageBufferDescriptorSize, bufferInfo, arrayElement);
+	}
+
+	void DescriptorBuffer::writeCombinedImageSampler(uint32_t set, uint32_t binding, const VkDescriptorImageInfo& imageInfo, uint32_t arrayElement)
+	{
+		VkDescriptorGetInfoEXT descriptorInfo{};
+		descriptorInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT;
+		descriptorInfo.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		descriptorInfo.data.pCombinedImageSampler = &imageInfo;
+		const size_t descriptorSize = properties.combinedImageSamplerDescriptorSize;
+		vkGetDescriptorEXT(vulkanDevice->logicalDevice, &descriptorInfo, descriptorSize, getDescriptorPointer(set, binding, arrayElement, descriptorSize));
+	}
+
+	void DescriptorBuffer::bind(VkCommandBuffer commandBuffer, const std::vector<DescriptorBuffer*>& descriptorBuffers)
+	{
+		assert(!descriptorBuffers.empty());
+		std::vector<VkDescriptorBufferBindingInfoEXT> bindingInfos(descriptorBuffers.size());
+		for (uint32_t i = 0; i < static_cast<uint32_t>(descriptorBuffers.size()); i++) {
+			bindingInfos[i].sType = VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT;
+			bindingInfos[i].address = descriptorBuffers[i]->deviceAddress;
+			bindingInfos[i].usage = descriptorBuffers[i]->usage;
+			descriptorBuffers[i]->bindingIndex = i;
+		}
+		descriptorBuffers[0]->vkCmdBindDescriptorBuffersEXT(commandBuffer, static_cast<uint32_t>(bindingInfos.size()), bindingInfos.data());
+	}
+
+	void DescriptorBuffer::setOffset(VkCommandBuffer commandBuffer, VkPipelineBindPoint pipelineBindPoint, VkPipelineLayout pipelineLayout, uint32_t firstSet, uint32_t set) const
+	{
+		const VkDeviceSize offset = set * setSize;
+		vkCmdSetDescriptorBufferOffsetsEXT(commandBuffer, pipelineBindPoint, pipelineLayout, firstSet, 1, &bindingIndex, &offset);
+	}
+}
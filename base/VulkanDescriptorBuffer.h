@@ -0,0 +1,91 @@
+/*
+* Vulkan descriptor buffer
+*
+* Stores the descriptor sets of a single set layout in a host visible buffer using VK_EXT_descriptor_buffer
+* Descriptors are written directly into the mapped buffer with vkGetDescriptorEXT, so there are no descriptor pools, and sets are bound by setting
+* an offset into the buffer with vkCmdSetDescriptorBufferOffsetsEXT instead of binding descriptor set objects
+* Sets are allocated with an atomic counter and each set occupies its own part of the buffer, so sets can be allocated and written from multiple
+* threads without any locking
+*
+* Copyright (C) 2025 by Sascha Willems - www.saschawillems.de
+*
+* This code is licensed under the MIT license (MIT) (http://opensource.org/licenses/MIT)
+*/
+
+#pragma once
+
+#include <vector>
+#include <atomic>
+
+#include "vulkan/vulkan.h"
+#include "VulkanDevice.h"
+#include "VulkanBuffer.h"
+#include "VulkanTools.h"
+
+namespace vks
+{
+	class DescriptorBuffer
+	{
+	public:
+		/**
+		* @brief Returns true if the physical device supports VK_EXT_descriptor_buffer with the descriptorBuffer and bufferDeviceAddress features
+		* @note Meant to be called before device creation (e.g. from getEnabledExtensions), requires Vulkan 1.1 for the feature query
+		* @note The device needs to be created with the extension and both features enabled, and set layouts need to be created with
+		* VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT
+		*/
+		static bool supported(vks::VulkanDevice* vulkanDevice);
+
+		/**
+		* @brief Creates the buffer for up to maxSets sets of the given layout
+		* @param bindingCount Number of bindings in the layout, their offsets are looked up once so writes don't need to call into the driver for them
+		* @param samplers Set if the layout contains samplers or combined image samplers, the buffer then is also a sampler descriptor buffer
+		*/
+		void create(vks::VulkanDevice* vulkanDevice, VkDescriptorSetLayout setLayout, uint32_t bindingCount, uint32_t maxSets, bool samplers);
+		/** @brief Destroys the buffer, safe to call if create has not been called */
+		void destroy();
+
+		/** @brief Returns the index of a new set, can be called from multiple threads */
+		uint32_t allocate();
+		/** @brief Resets the allocation counter, all previously allocated sets become invalid */
+		void reset();
+		uint32_t getSetCount() const;
+
+		/** @brief Writes a uniform buffer descriptor, the buffer needs to have been created with VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT */
+		void writeUniformBuffer(uint32_t set, uint32_t binding, const VkDescriptorBufferInfo& bufferInfo, uint32_t arrayElement = 0);
+		/** @brief Writes a storage buffer descriptor, the buffer needs to have been created with VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT */
+		void writeStorageBuffer(uint32_t set, uint32_t binding, const VkDescriptorBufferInfo& bufferInfo, uint32_t arrayElement = 0);
+		void writeCombinedImageSampler(uint32_t set, uint32_t binding, const VkDescriptorImageInfo& imageInfo, uint32_t arrayElement = 0);
+
+		/**
+		* @brief Binds the descriptor buffers to the command buffer, replacing all previously bound descriptor buffers
+		* @note Each buffer uses its position in the list as its binding index until the next call, so bind the buffers before setting their offsets
+		*/
+		static void bind(VkCommandBuffer commandBuffer, const std::vector<DescriptorBuffer*>& descriptorBuffers);
+		/** @brief Binds a set of this buffer to the given set index of the pipeline layout */
+		void setOffset(VkCommandBuffer commandBuffer, VkPipelineBindPoint pipelineBindPoint, VkPipelineLayout pipelineLayout, uint32_t firstSet, uint32_t set) const;
+
+	private:
+		vks::VulkanDevice* vulkanDevice{ nullptr };
+		VkPhysicalDeviceDescriptorBufferPropertiesEXT properties{};
+		vks::Buffer buffer;
+		VkDeviceAddress deviceAddress{ 0 };
+		VkBufferUsageFlags usage{ 0 };
+		// Size of a set in the buffer, aligned to the descriptor buffer offset alignment
+		VkDeviceSize setSize{ 0 };
+		std::vector<VkDeviceSize> bindingOffsets;
+		uint32_t maxSets{ 0 };
+		std::atomic<uint32_t> setCount{ 0 };
+		// Index of this buffer in the last call to bind
+		uint32_t bindingIndex{ 0 };
+
+		PFN_vkGetBufferDeviceAddressKHR vkGetBufferDeviceAddressKHR{ nullptr };
+		PFN_vkGetDescriptorSetLayoutSizeEXT vkGetDescriptorSetLayoutSizeEXT{ nullptr };
+		PFN_vkGetDescriptorSetLayoutBindingOffsetEXT vkGetDescriptorSetLayoutBindingOffsetEXT{ nullptr };
+		PFN_vkGetDescriptorEXT vkGetDescriptorEXT{ nullptr };
+		PFN_vkCmdBindDescriptorBuffersEXT vkCmdBindDescriptorBuffersEXT{ nullptr };
+		PFN_vkCmdSetDescriptorBufferOffsetsEXT vkCmdSetDescriptorBufferOffsetsEXT{ nullptr };
+
+		void writeBuffer(uint32_t set, uint32_t binding, VkDescriptorType type, size_t descriptorSize, const VkDescriptorBufferInfo& bufferInfo, uint32_t arrayElement);
+		void* getDescriptorPointer(uint32_t set, uint32_t binding, uint32_t arrayElement, size_t descriptorSize) const;
+	};
+}
@@ -3,7 +3,7 @@
  * 
  * Encapsulates a physical Vulkan device and its logical representation
  *
- * Copyright (C) 2016-2024 by Sascha Willems - www.saschawillems.de
+ * Copyright (C) 2016-2025 by Sascha Willems - www.saschawillems.de
  *
  * This code is licensed under the MIT license (MIT) (http://opensource.org/licenses/MIT)
  */
@@ -301,6 +301,13 @@ namespace vks
 		// Create a default command pool for graphics command buffers
 		commandPool = createCommandPool(queueFamilyIndices.graphics);
 
+		if (hostImageCopySupported)
+		{
+			vkCopyMemoryToImageEXT = reinterpret_cast<PFN_vkCopyMemoryToImageEXT>(vkGetDeviceProcAddr(logicalDevice, "vkCopyMemoryToImageEXT"));
+			vkTransitionImageLayoutEXT = reinterpret_cast<PFN_vkTransitionImageLayoutEXT>(vkGetDeviceProcAddr(logicalDevice, "vkTransitionImageLayoutEXT"));
+			hostImageCopySupported = (vkCopyMemoryToImageEXT != nullptr) && (vkTransitionImageLayoutEXT != nullptr);
+		}
+
 		return result;
 	}
 
@@ -586,4 +593,111 @@ namespace vks
 		throw std::runtime_error("Could not find a matching depth format");
 	}
 
+	/**
+	* Enable VK_EXT_host_image_copy and the extensions it depends on if supported by the device, so texture loaders can upload without staging buffers
+	* Needs to be called before creating the logical device, as it adds the extensions and the feature structure for device creation
+	*
+	* @param instance Instance the physical device belongs to, which needs to support Vulkan 1.1 or VK_KHR_get_physical_device_properties2
+	* @param enabledExtensions Device extensions the required extensions are added to
+	* @param pNextChain Device creation pNext chain the host image copy feature structure is added to
+	*
+	* @note Does nothing if the extension has already been requested, in that case the caller manages host image copies itself
+	*/
+	void VulkanDevice::enableHostImageCopy(VkInstance instance, std::vector<const char*>& enabledExtensions, void*& pNextChain)
+	{
+		const std::vector<const char*> requiredExtensions = { VK_EXT_HOST_IMAGE_COPY_EXTENSION_NAME, VK_KHR_COPY_COMMANDS_2_EXTENSION_NAME, VK_KHR_FORMAT_FEATURE_FLAGS_2_EXTENSION_NAME };
+		for (const char* extension : requiredExtensions) {
+			if (!extensionSupported(extension)) {
+				return;
+			}
+		}
+		for (const char* extension : enabledExtensions) {
+			if (strcmp(extension, VK_EXT_HOST_IMAGE_COPY_EXTENSION_NAME) == 0) {
+				return;
+			}
+		}
+
+		// Functions are provided by VK_KHR_get_physical_device_properties2 or Vulkan 1.1
+		auto getInstanceFunction = [instance](const char* name) {
+			PFN_vkVoidFunction function = vkGetInstanceProcAddr(instance, (std::string(name) + "KHR").c_str());
+			return function ? function : vkGetInstanceProcAddr(instance, name);
+		};
+		auto getPhysicalDeviceFeatures2 = reinterpret_cast<PFN_vkGetPhysicalDeviceFeatures2KHR>(getInstanceFunction("vkGetPhysicalDeviceFeatures2"));
+		auto getPhysicalDeviceProperties2 = reinterpret_cast<PFN_vkGetPhysicalDeviceProperties2KHR>(getInstanceFunction("vkGetPhysicalDeviceProperties2"));
+		vkGetPhysicalDeviceImageFormatProperties2KHR = reinterpret_cast<PFN_vkGetPhysicalDeviceImageFormatProperties2KHR>(getInstanceFunction("vkGetPhysicalDeviceImageFormatProperties2"));
+		if (!getPhysicalDeviceFeatures2 || !getPhysicalDeviceProperties2 || !vkGetPhysicalDeviceImageFormatProperties2KHR) {
+			return;
+		}
+
+		VkPhysicalDeviceHostImageCopyFeaturesEXT supportedFeatures{};
+		supportedFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_IMAGE_COPY_FEATURES_EXT;
+		VkPhysicalDeviceFeatures2 features2{};
+		features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		features2.pNext = &supportedFeatures;
+		getPhysicalDeviceFeatures2(physicalDevice, &features2);
+		if (!supportedFeatures.hostImageCopy) {
+			return;
+		}
+
+		// Host image copies can only write to a limited set of layouts, which has to be queried in two steps
+		VkPhysicalDeviceHostImageCopyPropertiesEXT hostImageCopyProperties{};
+		hostImageCopyProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_IMAGE_COPY_PROPERTIES_EXT;
+		VkPhysicalDeviceProperties2 properties2{};
+		properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+		properties2.pNext = &hostImageCopyProperties;
+		getPhysicalDeviceProperties2(physicalDevice, &properties2);
+		hostImageCopyDstLayouts.resize(hostImageCopyProperties.copyDstLayoutCount);
+		hostImageCopyProperties.pCopyDstLayouts = hostImageCopyDstLayouts.data();
+		hostImageCopyProperties.copySrcLayoutCount = 0;
+		getPhysicalDeviceProperties2(physicalDevice, &properties2);
+
+		for (const char* extension : requiredExtensions) {
+			if (std::find_if(enabledExtensions.begin(), enabledExtensions.end(), [extension](const char* enabled) { return strcmp(enabled, extension) == 0; }) == enabledExtensions.end()) {
+				enabledExtensions.push_back(extension);
+			}
+		}
+		hostImageCopyFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_IMAGE_COPY_FEATURES_EXT;
+		hostImageCopyFeatures.hostImageCopy = VK_TRUE;
+		hostImageCopyFeatures.pNext = pNextChain;
+		pNextChain = &hostImageCopyFeatures;
+		hostImageCopySupported = true;
+	}
+
+	/**
+	* Check if an image can be uploaded with host image copies
+	*
+	* @param format Format of the image
+	* @param type Type of the image
+	* @param usage Usage flags of the image, without the host transfer bit
+	* @param flags Create flags of the image
+	* @param layout Layout the image is used in after the upload
+	*
+	* @return True if host image copies have been enabled, the format supports them for the given usage and layout, and the device accesses such images as fast as images uploaded with staging buffers
+	*/
+	bool VulkanDevice::hostImageCopyAvailable(VkFormat format, VkImageType type, VkImageUsageFlags usage, VkImageCreateFlags flags, VkImageLayout layout)
+	{
+		if (!hostImageCopySupported || !useHostImageCopy) {
+			return false;
+		}
+		if (std::find(hostImageCopyDstLayouts.begin(), hostImageCopyDstLayouts.end(), layout) == hostImageCopyDstLayouts.end()) {
+			return false;
+		}
+		VkPhysicalDeviceImageFormatInfo2 imageFormatInfo{};
+		imageFormatInfo.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_IMAGE_FORMAT_INFO_2;
+		imageFormatInfo.format = format;
+		imageFormatInfo.type = type;
+		imageFormatInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+		imageFormatInfo.usage = usage | VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT;
+		imageFormatInfo.flags = flags;
+		// Some implementations need a different memory layout for images that can be written by the host, which may make device access slower
+		VkHostImageCopyDevicePerformanceQueryEXT performanceQuery{};
+		performanceQuery.sType = VK_STRUCTURE_TYPE_HOST_IMAGE_COPY_DEVICE_PERFORMANCE_QUERY_EXT;
+		VkImageFormatProperties2 imageFormatProperties{};
+		imageFormatProperties.sType = VK_STRUCTURE_TYPE_IMAGE_FORMAT_PROPERTIES_2;
+		imageFormatProperties.pNext = &performanceQuery;
+		if (vkGetPhysicalDeviceImageFormatProperties2KHR(physicalDevice, &imageFormatInfo, &imageFormatProperties) != VK_SUCCESS) {
+			return false;
+		}
+		return performanceQuery.optimalDeviceAccess == VK_TRUE;
+	}
 };
@@ -3,7 +3,7 @@
  *
  * Encapsulates a physical Vulkan device and its logical representation
  *
- * Copyright (C) 2016-2023 by Sascha Willems - www.saschawillems.de
+ * Copyright (C) 2016-2025 by Sascha Willems - www.saschawillems.de
  *
  * This code is licensed under the MIT license (MIT) (http://opensource.org/licenses/MIT)
  */
@@ -16,6 +16,7 @@
 #include <algorithm>
 #include <assert.h>
 #include <exception>
+#include <mutex>
 
 namespace vks
 {
@@ -39,6 +40,19 @@ struct VulkanDevice
 	std::vector<std::string> supportedExtensions;
 	/** @brief Default command pool for the graphics queue family index */
 	VkCommandPool commandPool = VK_NULL_HANDLE;
+	/** @brief Set if VK_EXT_host_image_copy has been enabled, texture loaders then copy image data from host memory without staging buffers or queue submissions */
+	bool hostImageCopySupported{ false };
+	/** @brief Texture loaders only use host image copies if set, can be cleared to force uploads through staging buffers (e.g. for comparisons) */
+	bool useHostImageCopy{ true };
+	/** @brief Image layouts that host image copies can write to */
+	std::vector<VkImageLayout> hostImageCopyDstLayouts;
+	/** @brief Feature structure chained into device creation if host image copies are enabled */
+	VkPhysicalDeviceHostImageCopyFeaturesEXT hostImageCopyFeatures{};
+	PFN_vkCopyMemoryToImageEXT vkCopyMemoryToImageEXT{ nullptr };
+	PFN_vkTransitionImageLayoutEXT vkTransitionImageLayoutEXT{ nullptr };
+	PFN_vkGetPhysicalDeviceImageFormatProperties2KHR vkGetPhysicalDeviceImageFormatProperties2KHR{ nullptr };
+	/** @brief Serializes uploads that record and submit command buffers from the default command pool, so texture loaders can be called from multiple threads */
+	std::mutex transferMutex;
 	/** @brief Contains queue family indices */
 	struct
 	{
@@ -65,5 +79,7 @@ struct VulkanDevice
 	void            flushCommandBuffer(VkCommandBuffer commandBuffer, VkQueue queue, bool free = true);
 	bool            extensionSupported(std::string extension);
 	VkFormat        getSupportedDepthFormat(bool checkSamplingSupport);
+	void            enableHostImageCopy(VkInstance instance, std::vector<const char *> &enabledExtensions, void *&pNextChain);
+	bool            hostImageCopyAvailable(VkFormat format, VkImageType type, VkImageUsageFlags usage, VkImageCreateFlags flags, VkImageLayout layout);
 };
 }        // namespace vks
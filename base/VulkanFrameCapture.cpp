@@ -0,0 +1,594 @@
+/*
+* Vulkan frame capture
+*
+* Copyright (C) 2025 by Sascha Willems - www.saschawillems.de
+*
+* This code is licensed under the MIT license (MIT) (http://opensource.org/licenses/MIT)
+*/
+
+#include "VulkanFrameCapture.h"
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#include <glm/gtc/packing.hpp>
+
+// The SSSE3 path is compiled for all x86 targets and selected at runtime, as default builds only enable SSE2
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <tmmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#if defined(_MSC_VER) && !defined(__clang__)
+#define CAPTURE_TARGET_SSSE3
+#else
+#define CAPTURE_TARGET_SSSE3 __attribute__((target("ssse3")))
+#endif
+#define CAPTURE_SWIZZLE_SSSE3
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define CAPTURE_SWIZZLE_NEON
+#endif
+
+namespace vks
+{
+#if defined(CAPTURE_SWIZZLE_SSSE3)
+	static bool cpuSupportsSSSE3()
+	{
+#if defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 1);
+		return (info[2] & (1 << 9)) != 0;
+#else
+		unsigned int eax, ebx, ecx, edx;
+		return __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_SSSE3);
+#endif
+	}
+
+	// Packs as many pixels of the row as possible and returns the number of pixels written
+	CAPTURE_TARGET_SSSE3 static uint32_t packRowRGBSSSE3(const uint8_t* src, uint8_t* dst, uint32_t width, bool swizzle)
+	{
+		// Four pixels per iteration, the 16 byte store writes four bytes past the twelve used, so the loop stops two pixels before the end of the row
+		const __m128i shuffle = swizzle ?
+			_mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1) :
+			_mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+		uint32_t x = 0;
+		for (; x + 6 <= width; x += 4) {
+			const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 4));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 3), _mm_shuffle_epi8(pixels, shuffle));
+		}
+		return x;
+	}
+#endif
+
+	// Converts a row of 8 bit RGBA or BGRA pixels to tightly packed RGB
+	static void packRowRGB(const uint8_t* src, uint8_t* dst, uint32_t width, bool swizzle)
+	{
+		uint32_t x = 0;
+#if defined(CAPTURE_SWIZZLE_SSSE3)
+		static const bool ssse3 = cpuSupportsSSSE3();
+		if (ssse3) {
+			x = packRowRGBSSSE3(src, dst, width, swizzle);
+		}
+#elif defined(CAPTURE_SWIZZLE_NEON)
+		// Sixteen pixels per iteration, de-interleaved into one register per channel
+		for (; x + 16 <= width; x += 16) {
+			const uint8x16x4_t pixels = vld4q_u8(src + x * 4);
+			uint8x16x3_t rgb;
+			rgb.val[0] = pixels.val[swizzle ? 2 : 0];
+			rgb.val[1] = pixels.val[1];
+			rgb.val[2] = pixels.val[swizzle ? 0 : 2];
+			vst3q_u8(dst + x * 3, rgb);
+		}
+#endif
+		const uint32_t r = swizzle ? 2 : 0;
+		const uint32_t b = swizzle ? 0 : 2;
+		for (; x < width; x++) {
+			dst[x * 3 + 0] = src[x * 4 + r];
+			dst[x * 3 + 1] = src[x * 4 + 1];
+			dst[x * 3 + 2] = src[x * 4 + b];
+		}
+	}
+
+	static uint32_t crc32(const uint8_t* data, size_t size, uint32_t crc = 0)
+	{
+		static const std::array<uint32_t, 256> table = [] {
+			std::array<uint32_t, 256> t{};
+			for (uint32_t i = 0; i < 256; i++) {
+				uint32_t c = i;
+				for (uint32_t k = 0; k < 8; k++) {
+					c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+				}
+				t[i] = c;
+			}
+			return t;
+		}();
+		crc = ~crc;
+		for (size_t i = 0; i < size; i++) {
+			crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+		}
+		return ~crc;
+	}
+
+	static void writeBigEndian(std::vector<uint8_t>& out, uint32_t value)
+	{
+		out.push_back((value >> 24) & 0xFF);
+		out.push_back((value >> 16) & 0xFF);
+		out.push_back((value >> 8) & 0xFF);
+		out.push_back(value & 0xFF);
+	}
+
+	static void writePNGChunk(std::ofstream& file, const char* type, const std::vector<uint8_t>& data)
+	{
+		std::vector<uint8_t> chunk;
+		writeBigEndian(chunk, static_cast<uint32_t>(data.size()));
+		chunk.insert(chunk.end(), type, type + 4);
+		chunk.insert(chunk.end(), data.begin(), data.end());
+		// The checksum covers the type and the data, but not the length
+		writeBigEndian(chunk, crc32(chunk.data() + 4, chunk.size() - 4));
+		file.write(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+	}
+
+	// Writes little endian values and zero terminated strings for the OpenEXR header
+	template<typename T>
+	static void writeEXR(std::ofstream& file, const T& value)
+	{
+		file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	static void writeEXRAttribute(std::ofstream& file, const char* name, const char* type, const void* data, int32_t size)
+	{
+		file.write(name, strlen(name) + 1);
+		file.write(type, strlen(type) + 1);
+		writeEXR(file, size);
+		file.write(static_cast<const char*>(data), size);
+	}
+
+	FrameCapture::~FrameCapture()
+	{
+		destroy();
+	}
+
+	bool FrameCapture::parseFormat(const std::string& name, CaptureFormat& format)
+	{
+		if (name == "ppm") {
+			format = CaptureFormat::PPM;
+		} else if (name == "png") {
+			format = CaptureFormat::PNG;
+		} else if (name == "exr") {
+			format = CaptureFormat::EXR;
+		} else if (name == "y4m") {
+			format = CaptureFormat::Y4M;
+		} else {
+			return false;
+		}
+		return true;
+	}
+
+	bool FrameCapture::prepare(vks::VulkanDevice* vulkanDevice, VkQueue queue, VkFormat colorFormat, uint32_t width, uint32_t height)
+	{
+		switch (colorFormat) {
+		case VK_FORMAT_B8G8R8A8_UNORM:
+		case VK_FORMAT_B8G8R8A8_SRGB:
+			swizzle = true;
+			break;
+		case VK_FORMAT_R8G8B8A8_UNORM:
+		case VK_FORMAT_R8G8B8A8_SRGB:
+			swizzle = false;
+			break;
+		default:
+			return false;
+		}
+		this->vulkanDevice = vulkanDevice;
+		this->queue = queue;
+		this->width = width;
+		this->height = height;
+
+		VkCommandPoolCreateInfo commandPoolCI = vks::initializers::commandPoolCreateInfo();
+		commandPoolCI.queueFamilyIndex = vulkanDevice->queueFamilyIndices.graphics;
+		commandPoolCI.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+		VK_CHECK_RESULT(vkCreateCommandPool(vulkanDevice->logicalDevice, &commandPoolCI, nullptr, &commandPool));
+		createSlots();
+
+		stopWorker = false;
+		worker = std::thread(&FrameCapture::encodeLoop, this);
+		return true;
+	}
+
+	bool FrameCapture::active() const
+	{
+		return vulkanDevice != nullptr;
+	}
+
+	void FrameCapture::createSlots()
+	{
+		VkDevice device = vulkanDevice->logicalDevice;
+		bufferSize = static_cast<VkDeviceSize>(width) * height * 4;
+		slots.resize(std::max(bufferCount, 1u));
+		nextSlot = 0;
+		for (Slot& slot : slots) {
+			VkBufferCreateInfo bufferCI = vks::initializers::bufferCreateInfo(VK_BUFFER_USAGE_TRANSFER_DST_BIT, bufferSize);
+			VK_CHECK_RESULT(vkCreateBuffer(device, &bufferCI, nullptr, &slot.buffer));
+			VkMemoryRequirements memReqs;
+			vkGetBufferMemoryRequirements(device, slot.buffer, &memReqs);
+			VkMemoryAllocateInfo memAlloc = vks::initializers::memoryAllocateInfo();
+			memAlloc.allocationSize = memReqs.size;
+			// Reading uncached memory on the host is slow, so cached memory is preferred even if it needs to be invalidated before reading
+			VkBool32 cachedFound{ VK_FALSE };
+			memAlloc.memoryTypeIndex = vulkanDevice->getMemoryType(memReqs.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT, &cachedFound);
+			if (cachedFound) {
+				const VkMemoryPropertyFlags flags = vulkanDevice->memoryProperties.memoryTypes[memAlloc.memoryTypeIndex].propertyFlags;
+				coherent = (flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+			} else {
+				memAlloc.memoryTypeIndex = vulkanDevice->getMemoryType(memReqs.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+				coherent = true;
+			}
+			VK_CHECK_RESULT(vkAllocateMemory(device, &memAlloc, nullptr, &slot.memory));
+			VK_CHECK_RESULT(vkBindBufferMemory(device, slot.buffer, slot.memory, 0));
+			VK_CHECK_RESULT(vkMapMemory(device, slot.memory, 0, VK_WHOLE_SIZE, 0, &slot.mapped));
+
+			VkCommandBufferAllocateInfo cmdBufAllocateInfo = vks::initializers::commandBufferAllocateInfo(commandPool, VK_COMMAND_BUFFER_LEVEL_PRIMARY, 1);
+			VK_CHECK_RESULT(vkAllocateCommandBuffers(device, &cmdBufAllocateInfo, &slot.commandBuffer));
+			VkFenceCreateInfo fenceCI = vks::initializers::fenceCreateInfo(VK_FENCE_CREATE_SIGNALED_BIT);
+			VK_CHECK_RESULT(vkCreateFence(device, &fenceCI, nullptr, &slot.fence));
+			VkSemaphoreCreateInfo semaphoreCI = vks::initializers::semaphoreCreateInfo();
+			VK_CHECK_RESULT(vkCreateSemaphore(device, &semaphoreCI, nullptr, &slot.semaphore));
+			slot.state = SlotState::Free;
+		}
+	}
+
+	void FrameCapture::destroySlots()
+	{
+		VkDevice device = vulkanDevice->logicalDevice;
+		for (Slot& slot : slots) {
+			vkUnmapMemory(device, slot.memory);
+			vkDestroyBuffer(device, slot.buffer, nullptr);
+			vkFreeMemory(device, slot.memory, nullptr);
+			vkFreeCommandBuffers(device, commandPool, 1, &slot.commandBuffer);
+			vkDestroyFence(device, slot.fence, nullptr);
+			vkDestroySemaphore(device, slot.semaphore, nullptr);
+		}
+		slots.clear();
+	}
+
+	void FrameCapture::destroy()
+	{
+		if (!vulkanDevice) {
+			return;
+		}
+		flush();
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopWorker = true;
+		}
+		condition.notify_all();
+		worker.join();
+		destroySlots();
+		vkDestroyCommandPool(vulkanDevice->logicalDevice, commandPool, nullptr);
+		commandPool = VK_NULL_HANDLE;
+		if (stream.is_open()) {
+			stream.close();
+		}
+		std::cout << "Captured " << statistics.captured << " frames to " << outputPath << " (" << statistics.stalls << " captures had to wait for a free buffer)\n";
+		vulkanDevice = nullptr;
+	}
+
+	void FrameCapture::resize(uint32_t width, uint32_t height)
+	{
+		if (!vulkanDevice) {
+			return;
+		}
+		flush();
+		destroySlots();
+		// Y4M streams have a fixed frame size
+		if (stream.is_open()) {
+			stream.close();
+			streamIndex++;
+		}
+		this->width = width;
+		this->height = height;
+		createSlots();
+	}
+
+	void FrameCapture::poll()
+	{
+		// Frames are handed over in submission order, so a frame that is still copying also holds back all later frames
+		while (!copying.empty()) {
+			const uint32_t slotIndex = copying.front();
+			if (vkGetFenceStatus(vulkanDevice->logicalDevice, slots[slotIndex].fence) != VK_SUCCESS) {
+				break;
+			}
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				slots[slotIndex].state = SlotState::Encoding;
+				jobs.push_back(slotIndex);
+			}
+			condition.notify_all();
+			copying.pop_front();
+		}
+	}
+
+	void FrameCapture::flush()
+	{
+		for (uint32_t slotIndex : copying) {
+			VK_CHECK_RESULT(vkWaitForFences(vulkanDevice->logicalDevice, 1, &slots[slotIndex].fence, VK_TRUE, UINT64_MAX));
+		}
+		poll();
+		std::unique_lock<std::mutex> lock(mutex);
+		condition.wait(lock, [this] { return jobs.empty(); });
+	}
+
+	VkSemaphore FrameCapture::capture(VkImage image, VkSemaphore waitSemaphore)
+	{
+		poll();
+
+		const uint32_t slotIndex = nextSlot;
+		nextSlot = (nextSlot + 1) % static_cast<uint32_t>(slots.size());
+		Slot& slot = slots[slotIndex];
+
+		// The ring is full if the oldest buffer is still being copied to or encoded from
+		// The encoder thread frees slots, so the state is only read under the lock
+		SlotState state;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			state = slot.state;
+		}
+		bool stalled = false;
+		if (state == SlotState::Copying) {
+			stalled = true;
+			VK_CHECK_RESULT(vkWaitForFences(vulkanDevice->logicalDevice, 1, &slot.fence, VK_TRUE, UINT64_MAX));
+			poll();
+		}
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			if (slot.state != SlotState::Free) {
+				stalled = true;
+				condition.wait(lock, [&slot] { return slot.state == SlotState::Free; });
+			}
+		}
+		if (stalled) {
+			statistics.stalls++;
+		}
+
+		VkCommandBuffer cmdBuffer = slot.commandBuffer;
+		VkCommandBufferBeginInfo cmdBufInfo = vks::initializers::commandBufferBeginInfo();
+		cmdBufInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		VK_CHECK_RESULT(vkBeginCommandBuffer(cmdBuffer, &cmdBufInfo));
+		const VkImageSubresourceRange subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+		// Rendering is made available by the wait semaphore, so the transition only needs to be ordered against the wait stage
+		vks::tools::insertImageMemoryBarrier(cmdBuffer, image, 0, VK_ACCESS_TRANSFER_READ_BIT, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, subresourceRange);
+		VkBufferImageCopy copyRegion{};
+		copyRegion.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+		copyRegion.imageExtent = { width, height, 1 };
+		vkCmdCopyImageToBuffer(cmdBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, slot.buffer, 1, &copyRegion);
+		vks::tools::insertImageMemoryBarrier(cmdBuffer, image, VK_ACCESS_TRANSFER_READ_BIT, 0, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, subresourceRange);
+		VkBufferMemoryBarrier bufferBarrier = vks::initializers::bufferMemoryBarrier();
+		bufferBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		bufferBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+		bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		bufferBarrier.buffer = slot.buffer;
+		bufferBarrier.size = VK_WHOLE_SIZE;
+		vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 0, nullptr, 1, &bufferBarrier, 0, nullptr);
+		VK_CHECK_RESULT(vkEndCommandBuffer(cmdBuffer));
+
+		VK_CHECK_RESULT(vkResetFences(vulkanDevice->logicalDevice, 1, &slot.fence));
+		const VkPipelineStageFlags waitStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+		VkSubmitInfo submitInfo = vks::initializers::submitInfo();
+		submitInfo.waitSemaphoreCount = 1;
+		submitInfo.pWaitSemaphores = &waitSemaphore;
+		submitInfo.pWaitDstStageMask = &waitStageMask;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &cmdBuffer;
+		submitInfo.signalSemaphoreCount = 1;
+		submitInfo.pSignalSemaphores = &slot.semaphore;
+		VK_CHECK_RESULT(vkQueueSubmit(queue, 1, &submitInfo, slot.fence));
+
+		slot.frameIndex = statistics.captured++;
+		slot.state = SlotState::Copying;
+		copying.push_back(slotIndex);
+		return slot.semaphore;
+	}
+
+	void FrameCapture::encodeLoop()
+	{
+		while (true) {
+			uint32_t slotIndex;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				condition.wait(lock, [this] { return !jobs.empty() || stopWorker; });
+				// Pending frames are written before the worker stops
+				if (jobs.empty()) {
+					break;
+				}
+				slotIndex = jobs.front();
+			}
+			encode(slots[slotIndex]);
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				slots[slotIndex].state = SlotState::Free;
+				jobs.pop_front();
+			}
+			condition.notify_all();
+		}
+	}
+
+	void FrameCapture::encode(Slot& slot)
+	{
+		auto tStart = std::chrono::high_resolution_clock::now();
+		if (!coherent) {
+			VkMappedMemoryRange mappedRange = vks::initializers::mappedMemoryRange();
+			mappedRange.memory = slot.memory;
+			mappedRange.size = VK_WHOLE_SIZE;
+			VK_CHECK_RESULT(vkInvalidateMappedMemoryRanges(vulkanDevice->logicalDevice, 1, &mappedRange));
+		}
+		const uint8_t* pixels = static_cast<const uint8_t*>(slot.mapped);
+		if (format == CaptureFormat::Y4M) {
+			encodeStream(pixels);
+		} else {
+			encodeFile(pixels, slot.frameIndex);
+		}
+		statistics.encodeTime = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - tStart).count();
+		statistics.encoded++;
+	}
+
+	void FrameCapture::encodeFile(const uint8_t* pixels, uint32_t frameIndex)
+	{
+		const char* extensions[] = { "ppm", "png", "exr" };
+		char filename[32];
+		snprintf(filename, sizeof(filename), "frame_%05u.%s", frameIndex, extensions[static_cast<uint32_t>(format)]);
+		std::ofstream file(outputPath + "/" + filename, std::ios::out | std::ios::binary);
+		if (!file.is_open()) {
+			std::cerr << "Could not write captured frame " << outputPath << "/" << filename << "\n";
+			return;
+		}
+
+		const size_t rowSize = static_cast<size_t>(width) * 3;
+		std::vector<uint8_t> row(rowSize);
+
+		switch (format) {
+		case CaptureFormat::PPM:
+		{
+			file << "P6\n" << width << "\n" << height << "\n" << 255 << "\n";
+			for (uint32_t y = 0; y < height; y++) {
+				packRowRGB(pixels + static_cast<size_t>(y) * width * 4, row.data(), width, swizzle);
+				file.write(reinterpret_cast<const char*>(row.data()), rowSize);
+			}
+			break;
+		}
+		case CaptureFormat::PNG:
+		{
+			// Compressing would take longer than the frame itself, so the image data is stored in uncompressed deflate blocks
+			std::vector<uint8_t> scanlines((rowSize + 1) * height);
+			for (uint32_t y = 0; y < height; y++) {
+				uint8_t* scanline = &scanlines[(rowSize + 1) * y];
+				// No filter
+				scanline[0] = 0;
+				packRowRGB(pixels + static_cast<size_t>(y) * width * 4, scanline + 1, width, swizzle);
+			}
+			const uint8_t signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+			file.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+			std::vector<uint8_t> header;
+			writeBigEndian(header, width);
+			writeBigEndian(header, height);
+			// 8 bit RGB, default compression, filtering and no interlacing
+			header.insert(header.end(), { 8, 2, 0, 0, 0 });
+			writePNGChunk(file, "IHDR", header);
+			std::vector<uint8_t> data = { 0x78, 0x01 };
+			data.reserve(scanlines.size() + (scanlines.size() / 65535 + 1) * 5 + 6);
+			uint32_t a = 1, b = 0;
+			size_t offset = 0;
+			do {
+				const uint16_t blockSize = static_cast<uint16_t>(std::min<size_t>(scanlines.size() - offset, 65535));
+				const bool lastBlock = (offset + blockSize) == scanlines.size();
+				data.push_back(lastBlock ? 1 : 0);
+				data.insert(data.end(), { static_cast<uint8_t>(blockSize & 0xFF), static_cast<uint8_t>(blockSize >> 8), static_cast<uint8_t>(~blockSize & 0xFF), static_cast<uint8_t>((~blockSize >> 8) & 0xFF) });
+				data.insert(data.end(), scanlines.begin() + offset, scanlines.begin() + offset + blockSize);
+				for (size_t i = offset; i < offset + blockSize; i++) {
+					a = (a + scanlines[i]) % 65521;
+					b = (b + a) % 65521;
+				}
+				offset += blockSize;
+			} while (offset < scanlines.size());
+			writeBigEndian(data, (b << 16) | a);
+			writePNGChunk(file, "IDAT", data);
+			writePNGChunk(file, "IEND", {});
+			break;
+		}
+		case CaptureFormat::EXR:
+		{
+			// OpenEXR stores linear values, so the sRGB encoding of the presented image is removed with a lookup table
+			static const std::array<uint16_t, 256> linearHalf = [] {
+				std::array<uint16_t, 256> table{};
+				for (uint32_t i = 0; i < 256; i++) {
+					const float c = i / 255.0f;
+					const float linear = (c <= 0.04045f) ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+					table[i] = glm::packHalf1x16(linear);
+				}
+				return table;
+			}();
+			writeEXR(file, int32_t(20000630));
+			writeEXR(file, int32_t(2));
+			// Channels are stored in alphabetical order as half floats (pixel type 1) without subsampling
+			std::vector<char> channels;
+			for (const char* name : { "B", "G", "R" }) {
+				channels.push_back(name[0]);
+				channels.push_back(0);
+				const int32_t channel[4] = { 1, 0, 1, 1 };
+				channels.insert(channels.end(), reinterpret_cast<const char*>(channel), reinterpret_cast<const char*>(channel) + sizeof(channel));
+			}
+			channels.push_back(0);
+			const uint8_t noCompression = 0, increasingY = 0;
+			const int32_t window[4] = { 0, 0, static_cast<int32_t>(width) - 1, static_cast<int32_t>(height) - 1 };
+			const float one = 1.0f, center[2] = { 0.0f, 0.0f };
+			writeEXRAttribute(file, "channels", "chlist", channels.data(), static_cast<int32_t>(channels.size()));
+			writeEXRAttribute(file, "compression", "compression", &noCompression, 1);
+			writeEXRAttribute(file, "dataWindow", "box2i", window, sizeof(window));
+			writeEXRAttribute(file, "displayWindow", "box2i", window, sizeof(window));
+			writeEXRAttribute(file, "lineOrder", "lineOrder", &increasingY, 1);
+			writeEXRAttribute(file, "pixelAspectRatio", "float", &one, sizeof(float));
+			writeEXRAttribute(file, "screenWindowCenter", "v2f", center, sizeof(center));
+			writeEXRAttribute(file, "screenWindowWidth", "float", &one, sizeof(float));
+			file.put(0);
+			// Offset table with one entry per scanline, each scanline is preceded by its y coordinate and data size
+			const int32_t lineDataSize = static_cast<int32_t>(width) * 3 * sizeof(uint16_t);
+			const uint64_t tableStart = static_cast<uint64_t>(file.tellp());
+			for (uint32_t y = 0; y < height; y++) {
+				writeEXR(file, uint64_t(tableStart + height * sizeof(uint64_t) + static_cast<uint64_t>(y) * (8 + lineDataSize)));
+			}
+			std::vector<uint16_t> line(static_cast<size_t>(width) * 3);
+			for (uint32_t y = 0; y < height; y++) {
+				packRowRGB(pixels + static_cast<size_t>(y) * width * 4, row.data(), width, swizzle);
+				for (uint32_t x = 0; x < width; x++) {
+					line[x] = linearHalf[row[x * 3 + 2]];
+					line[width + x] = linearHalf[row[x * 3 + 1]];
+					line[width * 2 + x] = linearHalf[row[x * 3 + 0]];
+				}
+				writeEXR(file, int32_t(y));
+				writeEXR(file, lineDataSize);
+				file.write(reinterpret_cast<const char*>(line.data()), lineDataSize);
+			}
+			break;
+		}
+		default:
+			break;
+		}
+	}
+
+	void FrameCapture::encodeStream(const uint8_t* pixels)
+	{
+		if (!stream.is_open()) {
+			char filename[32];
+			snprintf(filename, sizeof(filename), "capture_%03u.y4m", streamIndex);
+			stream.open(outputPath + "/" + filename, std::ios::out | std::ios::binary);
+			if (!stream.is_open()) {
+				std::cerr << "Could not write capture stream " << outputPath << "/" << filename << "\n";
+				return;
+			}
+			stream << "YUV4MPEG2 W" << width << " H" << height << " F" << frameRate << ":1 Ip A1:1 C444\n";
+		}
+		// Full resolution chroma planes, converted with the integer approximation of BT.601 in video range
+		const size_t planeSize = static_cast<size_t>(width) * height;
+		std::vector<uint8_t> planes(planeSize * 3);
+		std::vector<uint8_t> row(static_cast<size_t>(width) * 3);
+		for (uint32_t y = 0; y < height; y++) {
+			packRowRGB(pixels + static_cast<size_t>(y) * width * 4, row.data(), width, swizzle);
+			uint8_t* planeY = &planes[static_cast<size_t>(y) * width];
+			uint8_t* planeU = planeY + planeSize;
+			uint8_t* planeV = planeU + planeSize;
+			for (uint32_t x = 0; x < width; x++) {
+				const int32_t r = row[x * 3 + 0], g = row[x * 3 + 1], b = row[x * 3 + 2];
+				planeY[x] = static_cast<uint8_t>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+				planeU[x] = static_cast<uint8_t>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+				planeV[x] = static_cast<uint8_t>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+			}
+		}
+		stream << "FRAME\n";
+		stream.write(reinterpret_cast<const char*>(planes.data()), planes.size());
+	}
+}
@@ -0,0 +1,137 @@
+/*
+* Vulkan frame capture
+*
+* Copies presented images into a ring of host readable buffers and encodes them on a worker thread, so frames can be recorded
+* without waiting for the copy or the file output on the render thread
+*
+* Copyright (C) 2025 by Sascha Willems - www.saschawillems.de
+*
+* This code is licensed under the MIT license (MIT) (http://opensource.org/licenses/MIT)
+*/
+
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+#include "vulkan/vulkan.h"
+#include "VulkanDevice.h"
+#include "VulkanTools.h"
+
+namespace vks
+{
+	/** @brief File format captured frames are encoded to */
+	enum class CaptureFormat {
+		/** @brief Binary PPM image per frame */
+		PPM,
+		/** @brief Uncompressed PNG image per frame */
+		PNG,
+		/** @brief Uncompressed half float OpenEXR image per frame, with the sRGB encoding removed */
+		EXR,
+		/** @brief All frames in a single raw YUV 4:4:4 stream, that can be read by e.g. ffmpeg */
+		Y4M
+	};
+
+	/**
+	* @brief Captures presented images to disk
+	* @note Each frame is copied into the next buffer of a ring, and buffers are only handed to the encoder once their fence has been
+	* signaled, which usually happens without waiting. The render thread only stalls if all buffers are still in use.
+	* @note Supports 8 bit RGBA and BGRA color formats, which covers the formats the example swap chains select
+	*/
+	class FrameCapture
+	{
+	public:
+		/** @brief Directory the frames are written to */
+		std::string outputPath;
+		CaptureFormat format{ CaptureFormat::PPM };
+		/** @brief Number of readback buffers, more buffers allow for longer encode times before the render thread has to wait */
+		uint32_t bufferCount{ 4 };
+		/** @brief Frame rate stored in Y4M streams */
+		uint32_t frameRate{ 60 };
+
+		struct Statistics {
+			uint32_t captured{ 0 };
+			std::atomic<uint32_t> encoded{ 0 };
+			/** @brief Number of captures that had to wait for a buffer to become available */
+			uint32_t stalls{ 0 };
+			/** @brief Time spent converting and writing the last encoded frame in milliseconds */
+			std::atomic<float> encodeTime{ 0.0f };
+		} statistics;
+
+		~FrameCapture();
+
+		/**
+		* @brief Creates the readback buffers and starts the encoder thread
+		* @return False if the color format can't be captured
+		*/
+		bool prepare(vks::VulkanDevice* vulkanDevice, VkQueue queue, VkFormat colorFormat, uint32_t width, uint32_t height);
+		/** @brief Waits for all pending frames to be written and releases all resources */
+		void destroy();
+		/** @brief Recreates the readback buffers for a new image size, Y4M captures continue in a new stream */
+		void resize(uint32_t width, uint32_t height);
+		bool active() const;
+
+		/**
+		* @brief Submits the copy of a presentable image to the next readback buffer
+		* @param image Image in VK_IMAGE_LAYOUT_PRESENT_SRC_KHR layout, which is restored after the copy
+		* @param waitSemaphore Semaphore signaled once the image has been rendered
+		* @return Semaphore to wait on before presenting the image
+		*/
+		VkSemaphore capture(VkImage image, VkSemaphore waitSemaphore);
+		/** @brief Hands all frames that have finished copying to the encoder, called by capture but may also be called to flush earlier */
+		void poll();
+
+		/** @brief Parses a format name as used on the command line (ppm, png, exr or y4m) */
+		static bool parseFormat(const std::string& name, CaptureFormat& format);
+
+	private:
+		enum class SlotState { Free, Copying, Encoding };
+		struct Slot {
+			VkBuffer buffer{ VK_NULL_HANDLE };
+			VkDeviceMemory memory{ VK_NULL_HANDLE };
+			void* mapped{ nullptr };
+			VkCommandBuffer commandBuffer{ VK_NULL_HANDLE };
+			VkFence fence{ VK_NULL_HANDLE };
+			VkSemaphore semaphore{ VK_NULL_HANDLE };
+			uint32_t frameIndex{ 0 };
+			SlotState state{ SlotState::Free };
+		};
+
+		vks::VulkanDevice* vulkanDevice{ nullptr };
+		VkQueue queue{ VK_NULL_HANDLE };
+		VkCommandPool commandPool{ VK_NULL_HANDLE };
+		uint32_t width{ 0 };
+		uint32_t height{ 0 };
+		/** @brief Set for BGRA formats */
+		bool swizzle{ false };
+		bool coherent{ false };
+		VkDeviceSize bufferSize{ 0 };
+		std::vector<Slot> slots{};
+		uint32_t nextSlot{ 0 };
+		/** @brief Slots in submission order, frames are handed to the encoder in this order so streams stay in sequence */
+		std::deque<uint32_t> copying{};
+
+		std::thread worker;
+		std::mutex mutex;
+		std::condition_variable condition;
+		std::deque<uint32_t> jobs{};
+		bool stopWorker{ false };
+		std::ofstream stream;
+		uint32_t streamIndex{ 0 };
+
+		void createSlots();
+		void destroySlots();
+		/** @brief Waits until the encoder has written all frames handed to it */
+		void flush();
+		void encodeLoop();
+		void encode(Slot& slot);
+		void encodeFile(const uint8_t* pixels, uint32_t frameIndex);
+		void encodeStream(const uint8_t* pixels);
+	};
+}
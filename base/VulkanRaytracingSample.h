@@ -1,7 +1,7 @@
 /*
 * Extended sample base class for ray tracing based samples
 *
-* Copyright (C) 2020-2024 by Sascha Willems - www.saschawillems.de
+* Copyright (C) 2020-2025 by Sascha Willems - www.saschawillems.de
 *
 * This code is licensed under the MIT license (MIT) (http://opensource.org/licenses/MIT)
 */
@@ -12,6 +12,7 @@
 #include "vulkanexamplebase.h"
 #include "VulkanTools.h"
 #include "VulkanDevice.h"
+#include "VulkanAccelerationStructure.h"
 
 class VulkanRaytracingSample : public VulkanExampleBase
 {
@@ -74,6 +75,11 @@ public:
 	// Set to true, to denote that the sample only uses ray queries (changes extension and render pass handling)
 	bool rayQueryOnly = false;
 
+	// Batched BLAS builds with compaction, BLAS refits and TLAS rebuilds (see VulkanAccelerationStructure.h)
+	vks::AccelerationStructureManager accelerationStructureManager;
+
+	~VulkanRaytracingSample();
+
 	void enableExtensions();
 	ScratchBuffer createScratchBuffer(VkDeviceSize size);
 	void deleteScratchBuffer(ScratchBuffer& scratchBuffer);
@@ -84,8 +90,6 @@ public:
 	void deleteStorageImage();
 	VkStridedDeviceAddressRegionKHR getSbtEntryStridedDeviceAddressRegion(VkBuffer buffer, uint32_t handleCount);
 	void createShaderBindingTable(ShaderBindingTable& shaderBindingTable, uint32_t handleCount);
-	// Draw the ImGUI UI overlay using a render pass
-	void drawUI(VkCommandBuffer commandBuffer, VkFramebuffer framebuffer);
 
 	virtual void prepare();
 };
@@ -0,0 +1,565 @@
+/*
+* Vulkan render graph
+*
+* Copyright (C) 2025 by Sascha Willems - www.saschawillems.de
+*
+* This code is licensed under the MIT license (MIT) (http://opensource.org/licenses/MIT)
+*/
+
+#include "VulkanRenderGraph.h"
+
+#include <algorithm>
+#include <set>
+
+namespace vks
+{
+	bool RenderGraph::Attachment::isDepthStencil() const
+	{
+		const std::vector<VkFormat> formats = {
+			VK_FORMAT_D16_UNORM,
+			VK_FORMAT_X8_D24_UNORM_PACK32,
+			VK_FORMAT_D32_SFLOAT,
+			VK_FORMAT_S8_UINT,
+			VK_FORMAT_D16_UNORM_S8_UINT,
+			VK_FORMAT_D24_UNORM_S8_UINT,
+			VK_FORMAT_D32_SFLOAT_S8_UINT,
+		};
+		return std::find(formats.begin(), formats.end(), info.format) != formats.end();
+	}
+
+	VkImageAspectFlags RenderGraph::Attachment::aspectMask() const
+	{
+		if (!isDepthStencil()) {
+			return VK_IMAGE_ASPECT_COLOR_BIT;
+		}
+		if (info.format == VK_FORMAT_S8_UINT) {
+			return VK_IMAGE_ASPECT_STENCIL_BIT;
+		}
+		VkImageAspectFlags aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+		if (vks::tools::formatHasStencil(info.format)) {
+			aspectMask |= VK_IMAGE_ASPECT_STENCIL_BIT;
+		}
+		return aspectMask;
+	}
+
+	RenderGraph::RenderGraph(vks::VulkanDevice* vulkanDevice)
+	{
+		assert(vulkanDevice);
+		this->vulkanDevice = vulkanDevice;
+	}
+
+	RenderGraph::~RenderGraph()
+	{
+		destroyResources();
+	}
+
+	void RenderGraph::reset()
+	{
+		destroyResources();
+		passes.clear();
+		attachments.clear();
+		statistics = {};
+	}
+
+	uint32_t RenderGraph::addAttachment(const std::string& name, const RenderGraphAttachmentInfo& info)
+	{
+		Attachment attachment{};
+		attachment.name = name;
+		attachment.info = info;
+		attachments.push_back(attachment);
+		return static_cast<uint32_t>(attachments.size() - 1);
+	}
+
+	uint32_t RenderGraph::addPass(const std::string& name, std::function<void(VkCommandBuffer commandBuffer)> execute)
+	{
+		Pass pass{};
+		pass.name = name;
+		pass.execute = execute;
+		passes.push_back(pass);
+		return static_cast<uint32_t>(passes.size() - 1);
+	}
+
+	void RenderGraph::write(uint32_t pass, uint32_t attachment, const VkClearValue* clearValue)
+	{
+		assert(pass < passes.size() && attachment < attachments.size());
+		Access access{};
+		access.attachment = attachment;
+		access.type = AccessType::Write;
+		access.stageMask = attachments[attachment].isDepthStencil() ? VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT : VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		if (clearValue) {
+			access.clear = true;
+			access.clearValue = *clearValue;
+		}
+		passes[pass].accesses.push_back(access);
+	}
+
+	void RenderGraph::read(uint32_t pass, uint32_t attachment, VkPipelineStageFlags stageMask)
+	{
+		assert(pass < passes.size() && attachment < attachments.size());
+		Access access{};
+		access.attachment = attachment;
+		access.type = AccessType::Read;
+		access.stageMask = stageMask;
+		passes[pass].accesses.push_back(access);
+	}
+
+	void RenderGraph::setOutput(uint32_t pass)
+	{
+		assert(pass < passes.size());
+		passes[pass].output = true;
+	}
+
+	// Walks the passes backwards starting at the outputs and only keeps passes whose writes are consumed by a pass that is kept
+	void RenderGraph::cullPasses()
+	{
+		std::set<uint32_t> required;
+		for (int32_t i = static_cast<int32_t>(passes.size()) - 1; i >= 0; i--) {
+			Pass& pass = passes[i];
+			pass.active = pass.output;
+			for (auto& access : pass.accesses) {
+				if (access.type == AccessType::Write && required.count(access.attachment) > 0) {
+					pass.active = true;
+				}
+			}
+			if (!pass.active) {
+				continue;
+			}
+			for (auto& access : pass.accesses) {
+				// A cleared attachment doesn't depend on earlier writes, an attachment that is loaded does
+				if (access.type == AccessType::Write && access.clear) {
+					required.erase(access.attachment);
+				}
+			}
+			for (auto& access : pass.accesses) {
+				if (access.type == AccessType::Read || !access.clear) {
+					required.insert(access.attachment);
+				}
+			}
+		}
+		statistics.passCount = static_cast<uint32_t>(passes.size());
+		statistics.culledPassCount = static_cast<uint32_t>(std::count_if(passes.begin(), passes.end(), [](const Pass& pass) { return !pass.active; }));
+	}
+
+	void RenderGraph::computeLifetimes()
+	{
+		for (uint32_t i = 0; i < static_cast<uint32_t>(passes.size()); i++) {
+			if (!passes[i].active) {
+				continue;
+			}
+			for (auto& access : passes[i].accesses) {
+				Attachment& attachment = attachments[access.attachment];
+				if (!attachment.used) {
+					attachment.used = true;
+					attachment.firstUse = i;
+				}
+				attachment.lastUse = i;
+				if (access.type == AccessType::Write) {
+					attachment.usage |= attachment.isDepthStencil() ? VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT : VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+				} else {
+					attachment.usage |= VK_IMAGE_USAGE_SAMPLED_BIT;
+				}
+			}
+		}
+	}
+
+	void RenderGraph::createImages()
+	{
+		for (auto& attachment : attachments) {
+			if (!attachment.used) {
+				continue;
+			}
+			VkImageCreateInfo imageCI = vks::initializers::imageCreateInfo();
+			imageCI.imageType = VK_IMAGE_TYPE_2D;
+			imageCI.format = attachment.info.format;
+			imageCI.extent = { attachment.info.width, attachment.info.height, 1 };
+			imageCI.mipLevels = 1;
+			imageCI.arrayLayers = 1;
+			imageCI.samples = VK_SAMPLE_COUNT_1_BIT;
+			imageCI.tiling = VK_IMAGE_TILING_OPTIMAL;
+			imageCI.usage = attachment.usage;
+			imageCI.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			VK_CHECK_RESULT(vkCreateImage(vulkanDevice->logicalDevice, &imageCI, nullptr, &attachment.image));
+			vkGetImageMemoryRequirements(vulkanDevice->logicalDevice, attachment.image, &attachment.memReqs);
+			statistics.attachmentCount++;
+			statistics.memoryWithoutAliasing += attachment.memReqs.size;
+		}
+	}
+
+	// Attachments are assigned to memory blocks largest first, an attachment can share a block if its lifetime doesn't overlap with any attachment already placed there
+	// As all attachments of a block are bound at offset zero, the block needs to be as large as its largest attachment
+	void RenderGraph::allocateMemory()
+	{
+		std::vector<uint32_t> order;
+		for (uint32_t i = 0; i < static_cast<uint32_t>(attachments.size()); i++) {
+			if (attachments[i].used) {
+				order.push_back(i);
+			}
+		}
+		std::stable_sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) { return attachments[a].memReqs.size > attachments[b].memReqs.size; });
+
+		for (auto index : order) {
+			Attachment& attachment = attachments[index];
+			int32_t blockIndex = -1;
+			if (aliasing) {
+				for (uint32_t i = 0; i < static_cast<uint32_t>(memoryBlocks.size()); i++) {
+					const MemoryBlock& block = memoryBlocks[i];
+					if ((block.memoryTypeBits & attachment.memReqs.memoryTypeBits) == 0) {
+						continue;
+					}
+					VkBool32 memoryTypeFound = VK_FALSE;
+					vulkanDevice->getMemoryType(block.memoryTypeBits & attachment.memReqs.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &memoryTypeFound);
+					if (!memoryTypeFound) {
+						continue;
+					}
+					bool overlaps = false;
+					for (auto other : block.attachments) {
+						if (attachment.firstUse <= attachments[other].lastUse && attachments[other].firstUse <= attachment.lastUse) {
+							overlaps = true;
+							break;
+						}
+					}
+					if (!overlaps) {
+						blockIndex = static_cast<int32_t>(i);
+						break;
+					}
+				}
+			}
+			if (blockIndex < 0) {
+				memoryBlocks.push_back({});
+				blockIndex = static_cast<int32_t>(memoryBlocks.size() - 1);
+			}
+			MemoryBlock& block = memoryBlocks[blockIndex];
+			block.attachments.push_back(index);
+			block.memoryTypeBits &= attachment.memReqs.memoryTypeBits;
+			// Attachments are bound at offset zero, so only the size needs to cover the alignment of all attachments
+			block.size = std::max(block.size, vks::tools::alignedVkSize(attachment.memReqs.size, attachment.memReqs.alignment));
+			attachment.memoryBlock = static_cast<uint32_t>(blockIndex);
+		}
+
+		for (auto& block : memoryBlocks) {
+			VkMemoryAllocateInfo memAlloc = vks::initializers::memoryAllocateInfo();
+			memAlloc.allocationSize = block.size;
+			memAlloc.memoryTypeIndex = vulkanDevice->getMemoryType(block.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+			VK_CHECK_RESULT(vkAllocateMemory(vulkanDevice->logicalDevice, &memAlloc, nullptr, &block.memory));
+			for (auto index : block.attachments) {
+				Attachment& attachment = attachments[index];
+				VK_CHECK_RESULT(vkBindImageMemory(vulkanDevice->logicalDevice, attachment.image, block.memory, 0));
+
+				VkImageViewCreateInfo viewCI = vks::initializers::imageViewCreateInfo();
+				viewCI.viewType = VK_IMAGE_VIEW_TYPE_2D;
+				viewCI.format = attachment.info.format;
+				viewCI.subresourceRange = { attachment.aspectMask(), 0, 1, 0, 1 };
+				viewCI.image = attachment.image;
+				VK_CHECK_RESULT(vkCreateImageView(vulkanDevice->logicalDevice, &viewCI, nullptr, &attachment.view));
+				attachment.sampledView = attachment.view;
+				if ((attachment.usage & VK_IMAGE_USAGE_SAMPLED_BIT) && (viewCI.subresourceRange.aspectMask == (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT))) {
+					viewCI.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+					VK_CHECK_RESULT(vkCreateImageView(vulkanDevice->logicalDevice, &viewCI, nullptr, &attachment.sampledView));
+				}
+			}
+			statistics.memoryAllocated += block.size;
+		}
+		statistics.allocationCount = static_cast<uint32_t>(memoryBlocks.size());
+	}
+
+	void RenderGraph::layoutForAccess(const Attachment& attachment, const Access& access, VkImageLayout& layout, VkPipelineStageFlags& stageMask, VkAccessFlags& accessMask) const
+	{
+		stageMask = access.stageMask;
+		if (access.type == AccessType::Write) {
+			if (attachment.isDepthStencil()) {
+				layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+				accessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+			} else {
+				layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+				accessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | (access.clear ? 0 : VK_ACCESS_COLOR_ATTACHMENT_READ_BIT);
+			}
+		} else {
+			layout = attachment.isDepthStencil() ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			accessMask = VK_ACCESS_SHADER_READ_BIT;
+		}
+	}
+
+	// Render passes don't do any layout transitions, attachments are already in the attachment layout when the pass begins (see computeBarriers)
+	void RenderGraph::createRenderPasses()
+	{
+		for (uint32_t i = 0; i < static_cast<uint32_t>(passes.size()); i++) {
+			Pass& pass = passes[i];
+			if (!pass.active) {
+				continue;
+			}
+			std::vector<VkAttachmentDescription> attachmentDescriptions;
+			std::vector<VkAttachmentReference> colorReferences;
+			VkAttachmentReference depthReference{ VK_ATTACHMENT_UNUSED, VK_IMAGE_LAYOUT_UNDEFINED };
+			std::vector<VkImageView> views;
+			for (auto& access : pass.accesses) {
+				if (access.type != AccessType::Write) {
+					continue;
+				}
+				const Attachment& attachment = attachments[access.attachment];
+				// Contents are only loaded if an earlier pass rendered to the attachment, and only stored if a later pass uses them
+				VkAttachmentLoadOp loadOp = access.clear ? VK_ATTACHMENT_LOAD_OP_CLEAR : (attachment.firstUse < i ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_DONT_CARE);
+				VkAttachmentStoreOp storeOp = attachment.lastUse > i ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+				VkImageLayout layout;
+				VkPipelineStageFlags stageMask;
+				VkAccessFlags accessMask;
+				layoutForAccess(attachment, access, layout, stageMask, accessMask);
+
+				VkAttachmentDescription description{};
+				description.format = attachment.info.format;
+				description.samples = VK_SAMPLE_COUNT_1_BIT;
+				description.loadOp = loadOp;
+				description.storeOp = storeOp;
+				description.stencilLoadOp = vks::tools::formatHasStencil(attachment.info.format) ? loadOp : VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+				description.stencilStoreOp = vks::tools::formatHasStencil(attachment.info.format) ? storeOp : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+				description.initialLayout = layout;
+				description.finalLayout = layout;
+				const uint32_t index = static_cast<uint32_t>(attachmentDescriptions.size());
+				attachmentDescriptions.push_back(description);
+				if (attachment.isDepthStencil()) {
+					assert(depthReference.attachment == VK_ATTACHMENT_UNUSED && "A pass can only write to one depth stencil attachment");
+					depthReference = { index, layout };
+				} else {
+					colorReferences.push_back({ index, layout });
+				}
+				views.push_back(attachment.view);
+				pass.clearValues.push_back(access.clearValue);
+
+				if (index == 0) {
+					pass.extent = { attachment.info.width, attachment.info.height };
+				}
+				assert(pass.extent.width == attachment.info.width && pass.extent.height == attachment.info.height && "All attachments of a pass must have the same size");
+			}
+			// Passes without graph attachments record their own render pass
+			if (attachmentDescriptions.empty()) {
+				continue;
+			}
+
+			VkSubpassDescription subpass{};
+			subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+			subpass.colorAttachmentCount = static_cast<uint32_t>(colorReferences.size());
+			subpass.pColorAttachments = colorReferences.data();
+			subpass.pDepthStencilAttachment = (depthReference.attachment != VK_ATTACHMENT_UNUSED) ? &depthReference : nullptr;
+
+			VkRenderPassCreateInfo renderPassCI = vks::initializers::renderPassCreateInfo();
+			renderPassCI.attachmentCount = static_cast<uint32_t>(attachmentDescriptions.size());
+			renderPassCI.pAttachments = attachmentDescriptions.data();
+			renderPassCI.subpassCount = 1;
+			renderPassCI.pSubpasses = &subpass;
+			VK_CHECK_RESULT(vkCreateRenderPass(vulkanDevice->logicalDevice, &renderPassCI, nullptr, &pass.renderPass));
+
+			VkFramebufferCreateInfo framebufferCI = vks::initializers::framebufferCreateInfo();
+			framebufferCI.renderPass = pass.renderPass;
+			framebufferCI.attachmentCount = static_cast<uint32_t>(views.size());
+			framebufferCI.pAttachments = views.data();
+			framebufferCI.width = pass.extent.width;
+			framebufferCI.height = pass.extent.height;
+			framebufferCI.layers = 1;
+			VK_CHECK_RESULT(vkCreateFramebuffer(vulkanDevice->logicalDevice, &framebufferCI, nullptr, &pass.framebuffer));
+		}
+	}
+
+	// Walks the active passes in execution order and tracks layout and last access of each attachment
+	// A barrier is only added if the layout changes or the previous access wrote to the attachment, consecutive reads in the same layout don't need one
+	void RenderGraph::computeBarriers()
+	{
+		std::vector<AttachmentState> states(attachments.size());
+		// Index of the barrier that starts the first use of each attachment in the barrier list of its first pass
+		std::vector<size_t> firstUseBarriers(attachments.size(), 0);
+		const VkAccessFlags writeAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+		for (uint32_t i = 0; i < static_cast<uint32_t>(passes.size()); i++) {
+			Pass& pass = passes[i];
+			if (!pass.active) {
+				continue;
+			}
+			for (auto& access : pass.accesses) {
+				const Attachment& attachment = attachments[access.attachment];
+				AttachmentState& state = states[access.attachment];
+
+				VkImageLayout layout;
+				VkPipelineStageFlags stageMask;
+				VkAccessFlags accessMask;
+				layoutForAccess(attachment, access, layout, stageMask, accessMask);
+
+				const bool firstUse = (state.layout == VK_IMAGE_LAYOUT_UNDEFINED);
+				if (!firstUse && state.layout == layout && (state.accessMask & writeAccessMask) == 0 && (accessMask & writeAccessMask) == 0) {
+					// Read after read in the same layout, later writes need to wait for this read too
+					state.stageMask |= stageMask;
+					state.accessMask |= accessMask;
+					continue;
+				}
+
+				VkPipelineStageFlags srcStageMask = state.stageMask;
+				VkAccessFlags srcAccessMask = state.accessMask & writeAccessMask;
+				if (firstUse) {
+					// The previous content is discarded, but if the memory was used by another attachment before, its last access must have finished
+					srcStageMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+					srcAccessMask = 0;
+					for (auto other : memoryBlocks[attachment.memoryBlock].attachments) {
+						if (other != access.attachment && attachments[other].lastUse < attachment.firstUse) {
+							srcStageMask |= states[other].stageMask;
+							srcAccessMask |= states[other].accessMask & writeAccessMask;
+						}
+					}
+				}
+
+				VkImageMemoryBarrier barrier = vks::initializers::imageMemoryBarrier();
+				barrier.srcAccessMask = srcAccessMask;
+				barrier.dstAccessMask = accessMask;
+				barrier.oldLayout = firstUse ? VK_IMAGE_LAYOUT_UNDEFINED : state.layout;
+				barrier.newLayout = layout;
+				barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+				barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+				barrier.image = attachment.image;
+				barrier.subresourceRange = { attachment.aspectMask(), 0, 1, 0, 1 };
+				if (firstUse) {
+					firstUseBarriers[access.attachment] = pass.barriers.size();
+				}
+				pass.barriers.push_back(barrier);
+				pass.srcStageMask |= srcStageMask;
+				pass.dstStageMask |= stageMask;
+
+				state.layout = layout;
+				state.stageMask = stageMask;
+				state.accessMask = accessMask;
+			}
+			statistics.barrierCount += static_cast<uint32_t>(pass.barriers.size());
+			if (!pass.barriers.empty()) {
+				statistics.barrierBatchCount++;
+			}
+		}
+
+		// The graph is executed every frame, so the first use of an attachment also has to wait for the accesses of the previous execution
+		// to the same memory, i.e. the attachment itself and every attachment aliased with it that is used later on
+		for (uint32_t i = 0; i < static_cast<uint32_t>(passes.size()); i++) {
+			if (!passes[i].active) {
+				continue;
+			}
+			for (auto& access : passes[i].accesses) {
+				const Attachment& attachment = attachments[access.attachment];
+				if (attachment.firstUse != i) {
+					continue;
+				}
+				// Writes of the previous execution must also be made available before the memory is reused, the first use
+				// barrier already has the destination stage and access of this attachment
+				VkImageMemoryBarrier& barrier = passes[i].barriers[firstUseBarriers[access.attachment]];
+				for (auto other : memoryBlocks[attachment.memoryBlock].attachments) {
+					if (attachments[other].lastUse >= attachment.firstUse) {
+						passes[i].srcStageMask |= states[other].stageMask;
+						barrier.srcAccessMask |= states[other].accessMask & writeAccessMask;
+					}
+				}
+			}
+		}
+	}
+
+	void RenderGraph::compile()
+	{
+		destroyResources();
+		statistics = {};
+		for (auto& attachment : attachments) {
+			attachment.usage = 0;
+			attachment.used = false;
+		}
+		for (auto& pass : passes) {
+			pass.clearValues.clear();
+			pass.barriers.clear();
+			pass.srcStageMask = 0;
+			pass.dstStageMask = 0;
+		}
+		cullPasses();
+		computeLifetimes();
+		createImages();
+		allocateMemory();
+		createRenderPasses();
+		computeBarriers();
+	}
+
+	void RenderGraph::execute(VkCommandBuffer commandBuffer)
+	{
+		for (auto& pass : passes) {
+			if (!pass.active) {
+				continue;
+			}
+			if (!pass.barriers.empty()) {
+				vkCmdPipelineBarrier(commandBuffer, pass.srcStageMask, pass.dstStageMask, 0, 0, nullptr, 0, nullptr, static_cast<uint32_t>(pass.barriers.size()), pass.barriers.data());
+			}
+			if (pass.renderPass != VK_NULL_HANDLE) {
+				VkRenderPassBeginInfo renderPassBeginInfo = vks::initializers::renderPassBeginInfo();
+				renderPassBeginInfo.renderPass = pass.renderPass;
+				renderPassBeginInfo.framebuffer = pass.framebuffer;
+				renderPassBeginInfo.renderArea.extent = pass.extent;
+				renderPassBeginInfo.clearValueCount = static_cast<uint32_t>(pass.clearValues.size());
+				renderPassBeginInfo.pClearValues = pass.clearValues.data();
+				vkCmdBeginRenderPass(commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+				VkViewport viewport = vks::initializers::viewport((float)pass.extent.width, (float)pass.extent.height, 0.0f, 1.0f);
+				vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+				VkRect2D scissor = vks::initializers::rect2D(pass.extent.width, pass.extent.height, 0, 0);
+				vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+			}
+			if (pass.execute) {
+				pass.execute(commandBuffer);
+			}
+			if (pass.renderPass != VK_NULL_HANDLE) {
+				vkCmdEndRenderPass(commandBuffer);
+			}
+		}
+	}
+
+	VkRenderPass RenderGraph::getRenderPass(uint32_t pass) const
+	{
+		assert(pass < passes.size());
+		return passes[pass].renderPass;
+	}
+
+	VkImageView RenderGraph::getView(uint32_t attachment) const
+	{
+		assert(attachment < attachments.size());
+		return attachments[attachment].sampledView;
+	}
+
+	VkImageLayout RenderGraph::getReadLayout(uint32_t attachment) const
+	{
+		assert(attachment < attachments.size());
+		return attachments[attachment].isDepthStencil() ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	}
+
+	bool RenderGraph::isPassActive(uint32_t pass) const
+	{
+		assert(pass < passes.size());
+		return passes[pass].active;
+	}
+
+	void RenderGraph::destroyResources()
+	{
+		VkDevice device = vulkanDevice->logicalDevice;
+		for (auto& pass : passes) {
+			if (pass.framebuffer != VK_NULL_HANDLE) {
+				vkDestroyFramebuffer(device, pass.framebuffer, nullptr);
+				pass.framebuffer = VK_NULL_HANDLE;
+			}
+			if (pass.renderPass != VK_NULL_HANDLE) {
+				vkDestroyRenderPass(device, pass.renderPass, nullptr);
+				pass.renderPass = VK_NULL_HANDLE;
+			}
+		}
+		for (auto& attachment : attachments) {
+			if (attachment.sampledView != attachment.view) {
+				vkDestroyImageView(device, attachment.sampledView, nullptr);
+			}
+			attachment.sampledView = VK_NULL_HANDLE;
+			if (attachment.view != VK_NULL_HANDLE) {
+				vkDestroyImageView(device, attachment.view, nullptr);
+				attachment.view = VK_NULL_HANDLE;
+			}
+			if (attachment.image != VK_NULL_HANDLE) {
+				vkDestroyImage(device, attachment.image, nullptr);
+				attachment.image = VK_NULL_HANDLE;
+			}
+		}
+		for (auto& block : memoryBlocks) {
+			vkFreeMemory(device, block.memory, nullptr);
+		}
+		memoryBlocks.clear();
+	}
+}
@@ -0,0 +1,157 @@
+/*
+* Vulkan render graph
+*
+* Passes declare the attachments they write and the images they read, the graph derives render passes, image layout transitions
+* and barriers from that, culls passes that don't contribute to an output and aliases the memory of attachments whose lifetimes don't overlap
+*
+* Copyright (C) 2025 by Sascha Willems - www.saschawillems.de
+*
+* This code is licensed under the MIT license (MIT) (http://opensource.org/licenses/MIT)
+*/
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <functional>
+
+#include "vulkan/vulkan.h"
+#include "VulkanDevice.h"
+#include "VulkanTools.h"
+
+namespace vks
+{
+	/** @brief Describes a transient attachment owned by the render graph */
+	struct RenderGraphAttachmentInfo
+	{
+		VkFormat format{ VK_FORMAT_UNDEFINED };
+		uint32_t width{ 0 };
+		uint32_t height{ 0 };
+	};
+
+	/**
+	* @brief Render graph for single queue, single sample, 2D attachments
+	* @note Passes are executed in declaration order, so a pass can only read what earlier passes wrote
+	* @note Passes without graph attachments (e.g. the final pass into the swapchain) don't get a render pass from the graph and begin their own one in the execute callback
+	*/
+	class RenderGraph
+	{
+	public:
+		/** @brief Numbers of the last compile, used to compare against hand written setups */
+		struct Statistics {
+			uint32_t passCount{ 0 };
+			uint32_t culledPassCount{ 0 };
+			uint32_t attachmentCount{ 0 };
+			uint32_t allocationCount{ 0 };
+			/** @brief Image barriers recorded per execution of the graph */
+			uint32_t barrierCount{ 0 };
+			/** @brief Number of vkCmdPipelineBarrier calls per execution of the graph (barriers of a pass are batched) */
+			uint32_t barrierBatchCount{ 0 };
+			/** @brief Memory required if every attachment had its own allocation */
+			VkDeviceSize memoryWithoutAliasing{ 0 };
+			/** @brief Memory actually allocated with aliasing */
+			VkDeviceSize memoryAllocated{ 0 };
+		} statistics;
+
+		/** @brief Disable to give every attachment its own allocation (for comparison) */
+		bool aliasing{ true };
+
+		RenderGraph(vks::VulkanDevice* vulkanDevice);
+		~RenderGraph();
+
+		/** @brief Removes all passes and attachments and frees all Vulkan resources, so the graph can be declared again (e.g. after a resize) */
+		void reset();
+
+		/** @brief Declares a transient attachment, returns a handle used for reads and writes */
+		uint32_t addAttachment(const std::string& name, const RenderGraphAttachmentInfo& info);
+		/** @brief Declares a pass, the callback is invoked inside the pass' render pass (if it has graph attachments) */
+		uint32_t addPass(const std::string& name, std::function<void(VkCommandBuffer commandBuffer)> execute);
+		/** @brief Declares that the pass renders to an attachment, a clear value means the attachment is cleared at the start of the pass, otherwise its content is loaded */
+		void write(uint32_t pass, uint32_t attachment, const VkClearValue* clearValue = nullptr);
+		/** @brief Declares that the pass samples an attachment in the given shader stages */
+		void read(uint32_t pass, uint32_t attachment, VkPipelineStageFlags stageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+		/** @brief Marks a pass as producing an output of the graph (e.g. rendering to the swapchain), passes not contributing to an output are culled */
+		void setOutput(uint32_t pass);
+
+		/** @brief Culls passes, creates attachments and render passes and derives the barriers for all passes */
+		void compile();
+		/** @brief Records all passes that survived culling into the command buffer */
+		void execute(VkCommandBuffer commandBuffer);
+
+		/** @brief Returns the render pass of a pass (for pipeline creation), only valid after compile */
+		VkRenderPass getRenderPass(uint32_t pass) const;
+		/** @brief Returns the image view used to sample an attachment, VK_NULL_HANDLE if the attachment was culled (depth only for combined depth stencil formats, as a sampled view must not have both aspects) */
+		VkImageView getView(uint32_t attachment) const;
+		/** @brief Returns the layout an attachment is in when it's read by a pass */
+		VkImageLayout getReadLayout(uint32_t attachment) const;
+		/** @brief True if the pass survived culling */
+		bool isPassActive(uint32_t pass) const;
+
+	private:
+		enum class AccessType { Write, Read };
+		struct Access {
+			uint32_t attachment;
+			AccessType type;
+			VkPipelineStageFlags stageMask{ 0 };
+			bool clear{ false };
+			VkClearValue clearValue{};
+		};
+		struct Attachment {
+			std::string name;
+			RenderGraphAttachmentInfo info;
+			VkImageUsageFlags usage{ 0 };
+			VkImage image{ VK_NULL_HANDLE };
+			VkImageView view{ VK_NULL_HANDLE };
+			// Same as view, except for sampled depth stencil attachments, which get an additional depth only view
+			VkImageView sampledView{ VK_NULL_HANDLE };
+			VkMemoryRequirements memReqs{};
+			uint32_t memoryBlock{ 0 };
+			// First and last pass (in execution order) that use the attachment, only valid for used attachments
+			uint32_t firstUse{ 0 }, lastUse{ 0 };
+			bool used{ false };
+			bool isDepthStencil() const;
+			VkImageAspectFlags aspectMask() const;
+		};
+		struct Pass {
+			std::string name;
+			std::function<void(VkCommandBuffer)> execute;
+			std::vector<Access> accesses;
+			bool output{ false };
+			bool active{ true };
+			VkRenderPass renderPass{ VK_NULL_HANDLE };
+			VkFramebuffer framebuffer{ VK_NULL_HANDLE };
+			VkExtent2D extent{};
+			std::vector<VkClearValue> clearValues;
+			// Barriers recorded before the pass, derived at compile time and submitted with a single call
+			std::vector<VkImageMemoryBarrier> barriers;
+			VkPipelineStageFlags srcStageMask{ 0 };
+			VkPipelineStageFlags dstStageMask{ 0 };
+		};
+		struct MemoryBlock {
+			VkDeviceMemory memory{ VK_NULL_HANDLE };
+			VkDeviceSize size{ 0 };
+			uint32_t memoryTypeBits{ ~0u };
+			std::vector<uint32_t> attachments;
+		};
+		// State of an attachment while walking the passes in execution order
+		struct AttachmentState {
+			VkImageLayout layout{ VK_IMAGE_LAYOUT_UNDEFINED };
+			VkPipelineStageFlags stageMask{ 0 };
+			VkAccessFlags accessMask{ 0 };
+		};
+
+		vks::VulkanDevice* vulkanDevice{ nullptr };
+		std::vector<Attachment> attachments;
+		std::vector<Pass> passes;
+		std::vector<MemoryBlock> memoryBlocks;
+
+		void cullPasses();
+		void computeLifetimes();
+		void createImages();
+		void allocateMemory();
+		void createRenderPasses();
+		void computeBarriers();
+		void destroyResources();
+		void layoutForAccess(const Attachment& attachment, const Access& access, VkImageLayout& layout, VkPipelineStageFlags& stageMask, VkAccessFlags& accessMask) const;
+	};
+}
@@ -3,7 +3,7 @@
 * 
 * A swap chain is a collection of framebuffers used for rendering and presentation to the windowing system
 *
-* Copyright (C) 2016-2024 by Sascha Willems - www.saschawillems.de
+* Copyright (C) 2016-2025 by Sascha Willems - www.saschawillems.de
 *
 * This code is licensed under the MIT license (MIT) (http://opensource.org/licenses/MIT)
 */
@@ -208,8 +208,123 @@ void VulkanSwapChain::setContext(VkInstance instance, VkPhysicalDevice physicalD
 	this->device = device;
 }
 
+void VulkanSwapChain::initHeadless(VkQueue queue, uint32_t queueFamilyIndex)
+{
+	headless = true;
+	offscreen.queue = queue;
+	queueNodeIndex = queueFamilyIndex;
+	// The most commonly supported swap chain format, which is guaranteed to support color attachment usage
+	colorFormat = VK_FORMAT_B8G8R8A8_UNORM;
+	colorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
+}
+
+void VulkanSwapChain::createOffscreen(uint32_t width, uint32_t height)
+{
+	destroyOffscreen();
+
+	// Same number of images as a triple buffered swap chain
+	const uint32_t imageCount = 3;
+	images.resize(imageCount);
+	imageViews.resize(imageCount);
+	offscreen.memory.resize(imageCount);
+	offscreen.fences.resize(imageCount);
+	offscreen.nextImage = 0;
+	for (uint32_t i = 0; i < imageCount; i++) {
+		VkImageCreateInfo imageCI{};
+		imageCI.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		imageCI.imageType = VK_IMAGE_TYPE_2D;
+		imageCI.format = colorFormat;
+		imageCI.extent = { width, height, 1 };
+		imageCI.mipLevels = 1;
+		imageCI.arrayLayers = 1;
+		imageCI.samples = VK_SAMPLE_COUNT_1_BIT;
+		imageCI.tiling = VK_IMAGE_TILING_OPTIMAL;
+		imageCI.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+		imageUsage = imageCI.usage;
+		imageCI.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		VK_CHECK_RESULT(vkCreateImage(device, &imageCI, nullptr, &images[i]));
+
+		VkMemoryRequirements memReqs;
+		vkGetImageMemoryRequirements(device, images[i], &memReqs);
+		VkPhysicalDeviceMemoryProperties memoryProperties;
+		vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+		VkMemoryAllocateInfo memAlloc{};
+		memAlloc.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		memAlloc.allocationSize = memReqs.size;
+		memAlloc.memoryTypeIndex = UINT32_MAX;
+		for (uint32_t j = 0; j < memoryProperties.memoryTypeCount; j++) {
+			if ((memReqs.memoryTypeBits & (1 << j)) && (memoryProperties.memoryTypes[j].propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)) {
+				memAlloc.memoryTypeIndex = j;
+				break;
+			}
+		}
+		assert(memAlloc.memoryTypeIndex != UINT32_MAX);
+		VK_CHECK_RESULT(vkAllocateMemory(device, &memAlloc, nullptr, &offscreen.memory[i]));
+		VK_CHECK_RESULT(vkBindImageMemory(device, images[i], offscreen.memory[i], 0));
+
+		VkImageViewCreateInfo colorAttachmentView{};
+		colorAttachmentView.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		colorAttachmentView.format = colorFormat;
+		colorAttachmentView.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+		colorAttachmentView.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		colorAttachmentView.image = images[i];
+		VK_CHECK_RESULT(vkCreateImageView(device, &colorAttachmentView, nullptr, &imageViews[i]));
+
+		// Signaled until the image is first "presented"
+		VkFenceCreateInfo fenceCI{};
+		fenceCI.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+		fenceCI.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+		VK_CHECK_RESULT(vkCreateFence(device, &fenceCI, nullptr, &offscreen.fences[i]));
+	}
+
+	// Render passes of the examples expect presentable images to be in VK_IMAGE_LAYOUT_PRESENT_SRC_KHR after the first frame, so start out that way
+	VkCommandPool commandPool;
+	VkCommandPoolCreateInfo cmdPoolInfo{};
+	cmdPoolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	cmdPoolInfo.queueFamilyIndex = queueNodeIndex;
+	VK_CHECK_RESULT(vkCreateCommandPool(device, &cmdPoolInfo, nullptr, &commandPool));
+	VkCommandBuffer commandBuffer;
+	VkCommandBufferAllocateInfo cmdBufAllocateInfo{};
+	cmdBufAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	cmdBufAllocateInfo.commandPool = commandPool;
+	cmdBufAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	cmdBufAllocateInfo.commandBufferCount = 1;
+	VK_CHECK_RESULT(vkAllocateCommandBuffers(device, &cmdBufAllocateInfo, &commandBuffer));
+	VkCommandBufferBeginInfo cmdBufInfo{};
+	cmdBufInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	VK_CHECK_RESULT(vkBeginCommandBuffer(commandBuffer, &cmdBufInfo));
+	for (auto& image : images) {
+		vks::tools::setImageLayout(commandBuffer, image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 });
+	}
+	VK_CHECK_RESULT(vkEndCommandBuffer(commandBuffer));
+	VkSubmitInfo submitInfo{};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &commandBuffer;
+	VK_CHECK_RESULT(vkQueueSubmit(offscreen.queue, 1, &submitInfo, VK_NULL_HANDLE));
+	VK_CHECK_RESULT(vkQueueWaitIdle(offscreen.queue));
+	vkDestroyCommandPool(device, commandPool, nullptr);
+}
+
+void VulkanSwapChain::destroyOffscreen()
+{
+	for (size_t i = 0; i < offscreen.memory.size(); i++) {
+		vkDestroyImageView(device, imageViews[i], nullptr);
+		vkDestroyImage(device, images[i], nullptr);
+		vkFreeMemory(device, offscreen.memory[i], nullptr);
+		vkDestroyFence(device, offscreen.fences[i], nullptr);
+	}
+	offscreen.memory.clear();
+	offscreen.fences.clear();
+}
+
 void VulkanSwapChain::create(uint32_t& width, uint32_t& height, bool vsync, bool fullscreen)
 {
+	if (headless) {
+		createOffscreen(width, height);
+		return;
+	}
+
 	assert(physicalDevice);
 	assert(device);
 	assert(instance);
@@ -344,6 +459,7 @@ void VulkanSwapChain::create(uint32_t& width, uint32_t& height, bool vsync, bool
 	}
 
 	VK_CHECK_RESULT(vkCreateSwapchainKHR(device, &swapchainCI, nullptr, &swapChain));
+	imageUsage = swapchainCI.imageUsage;
 
 	// If an existing swap chain is re-created, destroy the old swap chain and the ressources owned by the application (image views, images are owned by the swap chain)
 	if (oldSwapchain != VK_NULL_HANDLE) { 
@@ -387,6 +503,21 @@ void VulkanSwapChain::create(uint32_t& width, uint32_t& height, bool vsync, bool
 
 VkResult VulkanSwapChain::acquireNextImage(VkSemaphore presentCompleteSemaphore, uint32_t& imageIndex)
 {
+	if (headless) {
+		// Images are handed out in order, and are available once their last presentation has finished
+		imageIndex = offscreen.nextImage;
+		offscreen.nextImage = (offscreen.nextImage + 1) % static_cast<uint32_t>(images.size());
+		VK_CHECK_RESULT(vkWaitForFences(device, 1, &offscreen.fences[imageIndex], VK_TRUE, UINT64_MAX));
+		VK_CHECK_RESULT(vkResetFences(device, 1, &offscreen.fences[imageIndex]));
+		// There is no presentation engine to signal the semaphore, so an empty submission does that instead
+		VkSubmitInfo submitInfo{};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		if (presentCompleteSemaphore != VK_NULL_HANDLE) {
+			submitInfo.signalSemaphoreCount = 1;
+			submitInfo.pSignalSemaphores = &presentCompleteSemaphore;
+		}
+		return vkQueueSubmit(offscreen.queue, 1, &submitInfo, VK_NULL_HANDLE);
+	}
 	// By setting timeout to UINT64_MAX we will always wait until the next image has been acquired or an actual error is thrown
 	// With that we don't have to handle VK_NOT_READY
 	return vkAcquireNextImageKHR(device, swapChain, UINT64_MAX, presentCompleteSemaphore, (VkFence)nullptr, &imageIndex);
@@ -394,6 +525,18 @@ VkResult VulkanSwapChain::acquireNextImage(VkSemaphore presentCompleteSemaphore,
 
 VkResult VulkanSwapChain::queuePresent(VkQueue queue, uint32_t imageIndex, VkSemaphore waitSemaphore)
 {
+	if (headless) {
+		// "Presenting" consumes the semaphore and signals the image's fence once rendering has finished
+		const VkPipelineStageFlags waitStageMask = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+		VkSubmitInfo submitInfo{};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		if (waitSemaphore != VK_NULL_HANDLE) {
+			submitInfo.waitSemaphoreCount = 1;
+			submitInfo.pWaitSemaphores = &waitSemaphore;
+			submitInfo.pWaitDstStageMask = &waitStageMask;
+		}
+		return vkQueueSubmit(queue, 1, &submitInfo, offscreen.fences[imageIndex]);
+	}
 	VkPresentInfoKHR presentInfo = {};
 	presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
 	presentInfo.pNext = NULL;
@@ -412,6 +555,7 @@ VkResult VulkanSwapChain::queuePresent(VkQueue queue, uint32_t imageIndex, VkSem
 
 void VulkanSwapChain::cleanup()
 {
+	destroyOffscreen();
 	if (swapChain != VK_NULL_HANDLE) {
 		for (auto i = 0; i < images.size(); i++) {
 			vkDestroyImageView(device, imageViews[i], nullptr);
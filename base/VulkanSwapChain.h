@@ -3,7 +3,7 @@
 * 
 * A swap chain is a collection of framebuffers used for rendering and presentation to the windowing system
 *
-* Copyright (C) 2016-2024 by Sascha Willems - www.saschawillems.de
+* Copyright (C) 2016-2025 by Sascha Willems - www.saschawillems.de
 *
 * This code is licensed under the MIT license (MIT) (http://opensource.org/licenses/MIT)
 */
@@ -34,6 +34,15 @@ private:
 	VkDevice device{ VK_NULL_HANDLE };
 	VkPhysicalDevice physicalDevice{ VK_NULL_HANDLE };
 	VkSurfaceKHR surface{ VK_NULL_HANDLE };
+	// Images, memory and fences that stand in for the swap chain when running without a surface
+	struct {
+		VkQueue queue{ VK_NULL_HANDLE };
+		std::vector<VkDeviceMemory> memory{};
+		std::vector<VkFence> fences{};
+		uint32_t nextImage{ 0 };
+	} offscreen;
+	void createOffscreen(uint32_t width, uint32_t height);
+	void destroyOffscreen();
 public:
 	VkFormat colorFormat{};
 	VkColorSpaceKHR colorSpace{};
@@ -41,6 +50,10 @@ public:
 	std::vector<VkImage> images{};
 	std::vector<VkImageView> imageViews{};
 	uint32_t queueNodeIndex{ UINT32_MAX };
+	/** @brief Usage flags the images were created with, transfer usage depends on surface support */
+	VkImageUsageFlags imageUsage{ 0 };
+	/** @brief Set if the swap chain is emulated with a ring of offscreen images, e.g. when running without a window (see initHeadless) */
+	bool headless{ false };
 
 #if defined(VK_USE_PLATFORM_WIN32_KHR)
 	void initSurface(void* platformHandle, void* platformWindow);
@@ -64,6 +77,15 @@ public:
 #elif defined(VK_USE_PLATFORM_SCREEN_QNX)
 	void initSurface(screen_context_t screen_context, screen_window_t screen_window);
 #endif
+	/**
+	* Use a ring of offscreen images instead of a surface, so no window is required
+	*
+	* @param queue Queue the semaphores passed to acquireNextImage and queuePresent are signaled and waited on with
+	* @param queueFamilyIndex Family of the queue, which will also be used for graphics
+	*
+	* @note Images are still transitioned to VK_IMAGE_LAYOUT_PRESENT_SRC_KHR by the examples, so the device needs to support VK_KHR_swapchain
+	*/
+	void initHeadless(VkQueue queue, uint32_t queueFamilyIndex);
 	/* Set the Vulkan objects required for swapchain creation and management, must be called before swapchain creation */
 	void setContext(VkInstance instance, VkPhysicalDevice physicalDevice, VkDevice device);
 	/**
@@ -92,59 +92,60 @@ namespace vks
 		VkMemoryAllocateInfo memAllocInfo = vks::initializers::memoryAllocateInfo();
 		VkMemoryRequirements memReqs;
 
-		// Use a separate command buffer for texture loading
-		VkCommandBuffer copyCmd = device->createCommandBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
-
 		if (useStaging)
 		{
-			// Create a host-visible staging buffer that contains the raw image data
-			VkBuffer stagingBuffer;
-			VkDeviceMemory stagingMemory;
-
-			VkBufferCreateInfo bufferCreateInfo = vks::initializers::bufferCreateInfo();
-			bufferCreateInfo.size = ktxTextureSize;
-			// This buffer is used as a transfer source for the buffer copy
-			bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-			bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-
-			VK_CHECK_RESULT(vkCreateBuffer(device->logicalDevice, &bufferCreateInfo, nullptr, &stagingBuffer));
-
-			// Get memory requirements for the staging buffer (alignment, memory type bits)
-			vkGetBufferMemoryRequirements(device->logicalDevice, stagingBuffer, &memReqs);
-
-			memAllocInfo.allocationSize = memReqs.size;
-			// Get memory type index for a host visible buffer
-			memAllocInfo.memoryTypeIndex = device->getMemoryType(memReqs.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
-			VK_CHECK_RESULT(vkAllocateMemory(device->logicalDevice, &memAllocInfo, nullptr, &stagingMemory));
-			VK_CHECK_RESULT(vkBindBufferMemory(device->logicalDevice, stagingBuffer, stagingMemory, 0));
-
-			// Copy texture data into staging buffer
-			uint8_t *data;
-			VK_CHECK_RESULT(vkMapMemory(device->logicalDevice, stagingMemory, 0, memReqs.size, 0, (void **)&data));
-			memcpy(data, ktxTextureData, ktxTextureSize);
-			vkUnmapMemory(device->logicalDevice, stagingMemory);
-
-			// Setup buffer copy regions for each mip level
+			// Images that support host image copies are written directly from the ktx data, otherwise the data is uploaded through a staging buffer
+			const bool hostImageCopy = device->hostImageCopyAvailable(format, VK_IMAGE_TYPE_2D, imageUsageFlags, 0, imageLayout);
+			VkBuffer stagingBuffer{ VK_NULL_HANDLE };
+			VkDeviceMemory stagingMemory{ VK_NULL_HANDLE };
 			std::vector<VkBufferImageCopy> bufferCopyRegions;
 
-			for (uint32_t i = 0; i < mipLevels; i++)
+			if (!hostImageCopy)
 			{
-				ktx_size_t offset;
-				KTX_error_code result = ktxTexture_GetImageOffset(ktxTexture, i, 0, 0, &offset);
-				assert(result == KTX_SUCCESS);
-
-				VkBufferImageCopy bufferCopyRegion = {};
-				bufferCopyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-				bufferCopyRegion.imageSubresource.mipLevel = i;
-				bufferCopyRegion.imageSubresource.baseArrayLayer = 0;
-				bufferCopyRegion.imageSubresource.layerCount = 1;
-				bufferCopyRegion.imageExtent.width = std::max(1u, ktxTexture->baseWidth >> i);
-				bufferCopyRegion.imageExtent.height = std::max(1u, ktxTexture->baseHeight >> i);
-				bufferCopyRegion.imageExtent.depth = 1;
-				bufferCopyRegion.bufferOffset = offset;
-
-				bufferCopyRegions.push_back(bufferCopyRegion);
+				// Create a host-visible staging buffer that contains the raw image data
+				VkBufferCreateInfo bufferCreateInfo = vks::initializers::bufferCreateInfo();
+				bufferCreateInfo.size = ktxTextureSize;
+				// This buffer is used as a transfer source for the buffer copy
+				bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+				bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+				VK_CHECK_RESULT(vkCreateBuffer(device->logicalDevice, &bufferCreateInfo, nullptr, &stagingBuffer));
+
+				// Get memory requirements for the staging buffer (alignment, memory type bits)
+				vkGetBufferMemoryRequirements(device->logicalDevice, stagingBuffer, &memReqs);
+
+				memAllocInfo.allocationSize = memReqs.size;
+				// Get memory type index for a host visible buffer
+				memAllocInfo.memoryTypeIndex = device->getMemoryType(memReqs.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+				VK_CHECK_RESULT(vkAllocateMemory(device->logicalDevice, &memAllocInfo, nullptr, &stagingMemory));
+				VK_CHECK_RESULT(vkBindBufferMemory(device->logicalDevice, stagingBuffer, stagingMemory, 0));
+
+				// Copy texture data into staging buffer
+				uint8_t *data;
+				VK_CHECK_RESULT(vkMapMemory(device->logicalDevice, stagingMemory, 0, memReqs.size, 0, (void **)&data));
+				memcpy(data, ktxTextureData, ktxTextureSize);
+				vkUnmapMemory(device->logicalDevice, stagingMemory);
+
+				// Setup buffer copy regions for each mip level
+				for (uint32_t i = 0; i < mipLevels; i++)
+				{
+					ktx_size_t offset;
+					KTX_error_code result = ktxTexture_GetImageOffset(ktxTexture, i, 0, 0, &offset);
+					assert(result == KTX_SUCCESS);
+
+					VkBufferImageCopy bufferCopyRegion = {};
+					bufferCopyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+					bufferCopyRegion.imageSubresource.mipLevel = i;
+					bufferCopyRegion.imageSubresource.baseArrayLayer = 0;
+					bufferCopyRegion.imageSubresource.layerCount = 1;
+					bufferCopyRegion.imageExtent.width = std::max(1u, ktxTexture->baseWidth >> i);
+					bufferCopyRegion.imageExtent.height = std::max(1u, ktxTexture->baseHeight >> i);
+					bufferCopyRegion.imageExtent.depth = 1;
+					bufferCopyRegion.bufferOffset = offset;
+
+					bufferCopyRegions.push_back(bufferCopyRegion);
+				}
 			}
 
 			// Create optimal tiled target image
@@ -159,11 +160,8 @@ namespace vks
 			imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 			imageCreateInfo.extent = { width, height, 1 };
 			imageCreateInfo.usage = imageUsageFlags;
-			// Ensure that the TRANSFER_DST bit is set for staging
-			if (!(imageCreateInfo.usage & VK_IMAGE_USAGE_TRANSFER_DST_BIT))
-			{
-				imageCreateInfo.usage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
-			}
+			// Ensure that the TRANSFER_DST bit is set for staging, or the HOST_TRANSFER bit for host image copies
+			imageCreateInfo.usage |= hostImageCopy ? VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT : VK_IMAGE_USAGE_TRANSFER_DST_BIT;
 			VK_CHECK_RESULT(vkCreateImage(device->logicalDevice, &imageCreateInfo, nullptr, &image));
 
 			vkGetImageMemoryRequirements(device->logicalDevice, image, &memReqs);
@@ -172,6 +170,7 @@ namespace vks
 
 			memAllocInfo.memoryTypeIndex = device->getMemoryType(memReqs.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 			VK_CHECK_RESULT(vkAllocateMemory(device->logicalDevice, &memAllocInfo, nullptr, &deviceMemory));
+			memorySize = memAllocInfo.allocationSize;
 			VK_CHECK_RESULT(vkBindImageMemory(device->logicalDevice, image, deviceMemory, 0));
 
 			VkImageSubresourceRange subresourceRange = {};
@@ -180,35 +179,49 @@ namespace vks
 			subresourceRange.levelCount = mipLevels;
 			subresourceRange.layerCount = 1;
 
-			// Image barrier for optimal image (target)
-			// Optimal image will be used as destination for the copy
-			vks::tools::setImageLayout(
-				copyCmd,
-				image,
-				VK_IMAGE_LAYOUT_UNDEFINED,
-				VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-				subresourceRange);
-
-			// Copy mip levels from staging buffer
-			vkCmdCopyBufferToImage(
-				copyCmd,
-				stagingBuffer,
-				image,
-				VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-				static_cast<uint32_t>(bufferCopyRegions.size()),
-				bufferCopyRegions.data()
-			);
-
-			// Change texture image layout to shader read after all mip levels have been copied
-			this->imageLayout = imageLayout;
-			vks::tools::setImageLayout(
-				copyCmd,
-				image,
-				VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-				imageLayout,
-				subresourceRange);
-
-			device->flushCommandBuffer(copyCmd, copyQueue);
+			if (hostImageCopy)
+			{
+				// No command buffer is required, so this path can run on any thread without synchronization
+				vks::copyKTXFromHost(device, image, ktxTexture, imageLayout);
+				this->imageLayout = imageLayout;
+			}
+			else
+			{
+				// Command buffers are allocated from the device's default pool, which must not be accessed by multiple threads at once
+				std::lock_guard<std::mutex> lock(device->transferMutex);
+				// Use a separate command buffer for texture loading
+				VkCommandBuffer copyCmd = device->createCommandBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
+
+				// Image barrier for optimal image (target)
+				// Optimal image will be used as destination for the copy
+				vks::tools::setImageLayout(
+					copyCmd,
+					image,
+					VK_IMAGE_LAYOUT_UNDEFINED,
+					VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+					subresourceRange);
+
+				// Copy mip levels from staging buffer
+				vkCmdCopyBufferToImage(
+					copyCmd,
+					stagingBuffer,
+					image,
+					VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+					static_cast<uint32_t>(bufferCopyRegions.size()),
+					bufferCopyRegions.data()
+				);
+
+				// Change texture image layout to shader read after all mip levels have been copied
+				this->imageLayout = imageLayout;
+				vks::tools::setImageLayout(
+					copyCmd,
+					image,
+					VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+					imageLayout,
+					subresourceRange);
+
+				device->flushCommandBuffer(copyCmd, copyQueue);
+			}
 
 			// Clean up staging resources
 			vkDestroyBuffer(device->logicalDevice, stagingBuffer, nullptr);
@@ -223,6 +236,10 @@ namespace vks
 			// Check if this support is supported for linear tiling
 			assert(formatProperties.linearTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT);
 
+			std::lock_guard<std::mutex> lock(device->transferMutex);
+			// Use a separate command buffer for texture loading
+			VkCommandBuffer copyCmd = device->createCommandBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
+
 			VkImage mappableImage;
 			VkDeviceMemory mappableMemory;
 
@@ -252,6 +269,7 @@ namespace vks
 
 			// Allocate host memory
 			VK_CHECK_RESULT(vkAllocateMemory(device->logicalDevice, &memAllocInfo, nullptr, &mappableMemory));
+			memorySize = memAllocInfo.allocationSize;
 
 			// Bind allocated image for use
 			VK_CHECK_RESULT(vkBindImageMemory(device->logicalDevice, mappableImage, mappableMemory, 0));
@@ -422,6 +440,7 @@ namespace vks
 
 		memAllocInfo.memoryTypeIndex = device->getMemoryType(memReqs.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 		VK_CHECK_RESULT(vkAllocateMemory(device->logicalDevice, &memAllocInfo, nullptr, &deviceMemory));
+		memorySize = memAllocInfo.allocationSize;
 		VK_CHECK_RESULT(vkBindImageMemory(device->logicalDevice, image, deviceMemory, 0));
 
 		VkImageSubresourceRange subresourceRange = {};
@@ -524,56 +543,61 @@ namespace vks
 		VkMemoryAllocateInfo memAllocInfo = vks::initializers::memoryAllocateInfo();
 		VkMemoryRequirements memReqs;
 
-		// Create a host-visible staging buffer that contains the raw image data
-		VkBuffer stagingBuffer;
-		VkDeviceMemory stagingMemory;
+		// Images that support host image copies are written directly from the ktx data, otherwise the data is uploaded through a staging buffer
+		const bool hostImageCopy = device->hostImageCopyAvailable(format, VK_IMAGE_TYPE_2D, imageUsageFlags, 0, imageLayout);
+		VkBuffer stagingBuffer{ VK_NULL_HANDLE };
+		VkDeviceMemory stagingMemory{ VK_NULL_HANDLE };
+		std::vector<VkBufferImageCopy> bufferCopyRegions;
 
-		VkBufferCreateInfo bufferCreateInfo = vks::initializers::bufferCreateInfo();
-		bufferCreateInfo.size = ktxTextureSize;
-		// This buffer is used as a transfer source for the buffer copy
-		bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-		bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		if (!hostImageCopy)
+		{
+			// Create a host-visible staging buffer that contains the raw image data
+			VkBufferCreateInfo bufferCreateInfo = vks::initializers::bufferCreateInfo();
+			bufferCreateInfo.size = ktxTextureSize;
+			// This buffer is used as a transfer source for the buffer copy
+			bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+			bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-		VK_CHECK_RESULT(vkCreateBuffer(device->logicalDevice, &bufferCreateInfo, nullptr, &stagingBuffer));
+			VK_CHECK_RESULT(vkCreateBuffer(device->logicalDevice, &bufferCreateInfo, nullptr, &stagingBuffer));
 
-		// Get memory requirements for the staging buffer (alignment, memory type bits)
-		vkGetBufferMemoryRequirements(device->logicalDevice, stagingBuffer, &memReqs);
+			// Get memory requirements for the staging buffer (alignment, memory type bits)
+			vkGetBufferMemoryRequirements(device->logicalDevice, stagingBuffer, &memReqs);
 
-		memAllocInfo.allocationSize = memReqs.size;
-		// Get memory type index for a host visible buffer
-		memAllocInfo.memoryTypeIndex = device->getMemoryType(memReqs.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+			memAllocInfo.allocationSize = memReqs.size;
+			// Get memory type index for a host visible buffer
+			memAllocInfo.memoryTypeIndex = device->getMemoryType(memReqs.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
 
-		VK_CHECK_RESULT(vkAllocateMemory(device->logicalDevice, &memAllocInfo, nullptr, &stagingMemory));
-		VK_CHECK_RESULT(vkBindBufferMemory(device->logicalDevice, stagingBuffer, stagingMemory, 0));
+			VK_CHECK_RESULT(vkAllocateMemory(device->logicalDevice, &memAllocInfo, nullptr, &stagingMemory));
+			VK_CHECK_RESULT(vkBindBufferMemory(device->logicalDevice, stagingBuffer, stagingMemory, 0));
 
-		// Copy texture data into staging buffer
-		uint8_t *data;
-		VK_CHECK_RESULT(vkMapMemory(device->logicalDevice, stagingMemory, 0, memReqs.size, 0, (void **)&data));
-		memcpy(data, ktxTextureData, ktxTextureSize);
-		vkUnmapMemory(device->logicalDevice, stagingMemory);
+			// Copy texture data into staging buffer
+			uint8_t *data;
+			VK_CHECK_RESULT(vkMapMemory(device->logicalDevice, stagingMemory, 0, memReqs.size, 0, (void **)&data));
+			memcpy(data, ktxTextureData, ktxTextureSize);
+			vkUnmapMemory(device->logicalDevice, stagingMemory);
 
-		// Setup buffer copy regions for each layer including all of its miplevels
-		std::vector<VkBufferImageCopy> bufferCopyRegions;
+			// Setup buffer copy regions for each layer including all of its miplevels
 
-		for (uint32_t layer = 0; layer < layerCount; layer++)
-		{
-			for (uint32_t level = 0; level < mipLevels; level++)
+			for (uint32_t layer = 0; layer < layerCount; layer++)
 			{
-				ktx_size_t offset;
-				KTX_error_code result = ktxTexture_GetImageOffset(ktxTexture, level, layer, 0, &offset);
-				assert(result == KTX_SUCCESS);
-
-				VkBufferImageCopy bufferCopyRegion = {};
-				bufferCopyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-				bufferCopyRegion.imageSubresource.mipLevel = level;
-				bufferCopyRegion.imageSubresource.baseArrayLayer = layer;
-				bufferCopyRegion.imageSubresource.layerCount = 1;
-				bufferCopyRegion.imageExtent.width = ktxTexture->baseWidth >> level;
-				bufferCopyRegion.imageExtent.height = ktxTexture->baseHeight >> level;
-				bufferCopyRegion.imageExtent.depth = 1;
-				bufferCopyRegion.bufferOffset = offset;
-
-				bufferCopyRegions.push_back(bufferCopyRegion);
+				for (uint32_t level = 0; level < mipLevels; level++)
+				{
+					ktx_size_t offset;
+					KTX_error_code result = ktxTexture_GetImageOffset(ktxTexture, level, layer, 0, &offset);
+					assert(result == KTX_SUCCESS);
+
+					VkBufferImageCopy bufferCopyRegion = {};
+					bufferCopyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+					bufferCopyRegion.imageSubresource.mipLevel = level;
+					bufferCopyRegion.imageSubresource.baseArrayLayer = layer;
+					bufferCopyRegion.imageSubresource.layerCount = 1;
+					bufferCopyRegion.imageExtent.width = ktxTexture->baseWidth >> level;
+					bufferCopyRegion.imageExtent.height = ktxTexture->baseHeight >> level;
+					bufferCopyRegion.imageExtent.depth = 1;
+					bufferCopyRegion.bufferOffset = offset;
+
+					bufferCopyRegions.push_back(bufferCopyRegion);
+				}
 			}
 		}
 
@@ -587,11 +611,8 @@ namespace vks
 		imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 		imageCreateInfo.extent = { width, height, 1 };
 		imageCreateInfo.usage = imageUsageFlags;
-		// Ensure that the TRANSFER_DST bit is set for staging
-		if (!(imageCreateInfo.usage & VK_IMAGE_USAGE_TRANSFER_DST_BIT))
-		{
-			imageCreateInfo.usage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
-		}
+		// Ensure that the TRANSFER_DST bit is set for staging, or the HOST_TRANSFER bit for host image copies
+		imageCreateInfo.usage |= hostImageCopy ? VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT : VK_IMAGE_USAGE_TRANSFER_DST_BIT;
 		imageCreateInfo.arrayLayers = layerCount;
 		imageCreateInfo.mipLevels = mipLevels;
 
@@ -603,11 +624,9 @@ namespace vks
 		memAllocInfo.memoryTypeIndex = device->getMemoryType(memReqs.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
 		VK_CHECK_RESULT(vkAllocateMemory(device->logicalDevice, &memAllocInfo, nullptr, &deviceMemory));
+		memorySize = memAllocInfo.allocationSize;
 		VK_CHECK_RESULT(vkBindImageMemory(device->logicalDevice, image, deviceMemory, 0));
 
-		// Use a separate command buffer for texture loading
-		VkCommandBuffer copyCmd = device->createCommandBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
-
 		// Image barrier for optimal image (target)
 		// Set initial layout for all array layers (faces) of the optimal (target) tiled texture
 		VkImageSubresourceRange subresourceRange = {};
@@ -616,32 +635,46 @@ namespace vks
 		subresourceRange.levelCount = mipLevels;
 		subresourceRange.layerCount = layerCount;
 
-		vks::tools::setImageLayout(
-			copyCmd,
-			image,
-			VK_IMAGE_LAYOUT_UNDEFINED,
-			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-			subresourceRange);
+		if (hostImageCopy)
+		{
+			// No command buffer is required, so this path can run on any thread without synchronization
+			vks::copyKTXFromHost(device, image, ktxTexture, imageLayout);
+			this->imageLayout = imageLayout;
+		}
+		else
+		{
+			// Command buffers are allocated from the device's default pool, which must not be accessed by multiple threads at once
+			std::lock_guard<std::mutex> lock(device->transferMutex);
+			// Use a separate command buffer for texture loading
+			VkCommandBuffer copyCmd = device->createCommandBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
 
-		// Copy the layers and mip levels from the staging buffer to the optimal tiled image
-		vkCmdCopyBufferToImage(
-			copyCmd,
-			stagingBuffer,
-			image,
-			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-			static_cast<uint32_t>(bufferCopyRegions.size()),
-			bufferCopyRegions.data());
+			vks::tools::setImageLayout(
+				copyCmd,
+				image,
+				VK_IMAGE_LAYOUT_UNDEFINED,
+				VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+				subresourceRange);
 
-		// Change texture image layout to shader read after all faces have been copied
-		this->imageLayout = imageLayout;
-		vks::tools::setImageLayout(
-			copyCmd,
-			image,
-			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-			imageLayout,
-			subresourceRange);
+			// Copy the layers and mip levels from the staging buffer to the optimal tiled image
+			vkCmdCopyBufferToImage(
+				copyCmd,
+				stagingBuffer,
+				image,
+				VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+				static_cast<uint32_t>(bufferCopyRegions.size()),
+				bufferCopyRegions.data());
 
-		device->flushCommandBuffer(copyCmd, copyQueue);
+			// Change texture image layout to shader read after all faces have been copied
+			this->imageLayout = imageLayout;
+			vks::tools::setImageLayout(
+				copyCmd,
+				image,
+				VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+				imageLayout,
+				subresourceRange);
+
+			device->flushCommandBuffer(copyCmd, copyQueue);
+		}
 
 		// Create sampler
 		VkSamplerCreateInfo samplerCreateInfo = vks::initializers::samplerCreateInfo();
@@ -707,56 +740,61 @@ namespace vks
 		VkMemoryAllocateInfo memAllocInfo = vks::initializers::memoryAllocateInfo();
 		VkMemoryRequirements memReqs;
 
-		// Create a host-visible staging buffer that contains the raw image data
-		VkBuffer stagingBuffer;
-		VkDeviceMemory stagingMemory;
+		// Images that support host image copies are written directly from the ktx data, otherwise the data is uploaded through a staging buffer
+		const bool hostImageCopy = device->hostImageCopyAvailable(format, VK_IMAGE_TYPE_2D, imageUsageFlags, VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT, imageLayout);
+		VkBuffer stagingBuffer{ VK_NULL_HANDLE };
+		VkDeviceMemory stagingMemory{ VK_NULL_HANDLE };
+		std::vector<VkBufferImageCopy> bufferCopyRegions;
 
-		VkBufferCreateInfo bufferCreateInfo = vks::initializers::bufferCreateInfo();
-		bufferCreateInfo.size = ktxTextureSize;
-		// This buffer is used as a transfer source for the buffer copy
-		bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-		bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		if (!hostImageCopy)
+		{
+			// Create a host-visible staging buffer that contains the raw image data
+			VkBufferCreateInfo bufferCreateInfo = vks::initializers::bufferCreateInfo();
+			bufferCreateInfo.size = ktxTextureSize;
+			// This buffer is used as a transfer source for the buffer copy
+			bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+			bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-		VK_CHECK_RESULT(vkCreateBuffer(device->logicalDevice, &bufferCreateInfo, nullptr, &stagingBuffer));
+			VK_CHECK_RESULT(vkCreateBuffer(device->logicalDevice, &bufferCreateInfo, nullptr, &stagingBuffer));
 
-		// Get memory requirements for the staging buffer (alignment, memory type bits)
-		vkGetBufferMemoryRequirements(device->logicalDevice, stagingBuffer, &memReqs);
+			// Get memory requirements for the staging buffer (alignment, memory type bits)
+			vkGetBufferMemoryRequirements(device->logicalDevice, stagingBuffer, &memReqs);
 
-		memAllocInfo.allocationSize = memReqs.size;
-		// Get memory type index for a host visible buffer
-		memAllocInfo.memoryTypeIndex = device->getMemoryType(memReqs.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+			memAllocInfo.allocationSize = memReqs.size;
+			// Get memory type index for a host visible buffer
+			memAllocInfo.memoryTypeIndex = device->getMemoryType(memReqs.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
 
-		VK_CHECK_RESULT(vkAllocateMemory(device->logicalDevice, &memAllocInfo, nullptr, &stagingMemory));
-		VK_CHECK_RESULT(vkBindBufferMemory(device->logicalDevice, stagingBuffer, stagingMemory, 0));
+			VK_CHECK_RESULT(vkAllocateMemory(device->logicalDevice, &memAllocInfo, nullptr, &stagingMemory));
+			VK_CHECK_RESULT(vkBindBufferMemory(device->logicalDevice, stagingBuffer, stagingMemory, 0));
 
-		// Copy texture data into staging buffer
-		uint8_t *data;
-		VK_CHECK_RESULT(vkMapMemory(device->logicalDevice, stagingMemory, 0, memReqs.size, 0, (void **)&data));
-		memcpy(data, ktxTextureData, ktxTextureSize);
-		vkUnmapMemory(device->logicalDevice, stagingMemory);
+			// Copy texture data into staging buffer
+			uint8_t *data;
+			VK_CHECK_RESULT(vkMapMemory(device->logicalDevice, stagingMemory, 0, memReqs.size, 0, (void **)&data));
+			memcpy(data, ktxTextureData, ktxTextureSize);
+			vkUnmapMemory(device->logicalDevice, stagingMemory);
 
-		// Setup buffer copy regions for each face including all of its mip levels
-		std::vector<VkBufferImageCopy> bufferCopyRegions;
+			// Setup buffer copy regions for each face including all of its mip levels
 
-		for (uint32_t face = 0; face < 6; face++)
-		{
-			for (uint32_t level = 0; level < mipLevels; level++)
+			for (uint32_t face = 0; face < 6; face++)
 			{
-				ktx_size_t offset;
-				KTX_error_code result = ktxTexture_GetImageOffset(ktxTexture, level, 0, face, &offset);
-				assert(result == KTX_SUCCESS);
-
-				VkBufferImageCopy bufferCopyRegion = {};
-				bufferCopyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-				bufferCopyRegion.imageSubresource.mipLevel = level;
-				bufferCopyRegion.imageSubresource.baseArrayLayer = face;
-				bufferCopyRegion.imageSubresource.layerCount = 1;
-				bufferCopyRegion.imageExtent.width = ktxTexture->baseWidth >> level;
-				bufferCopyRegion.imageExtent.height = ktxTexture->baseHeight >> level;
-				bufferCopyRegion.imageExtent.depth = 1;
-				bufferCopyRegion.bufferOffset = offset;
-
-				bufferCopyRegions.push_back(bufferCopyRegion);
+				for (uint32_t level = 0; level < mipLevels; level++)
+				{
+					ktx_size_t offset;
+					KTX_error_code result = ktxTexture_GetImageOffset(ktxTexture, level, 0, face, &offset);
+					assert(result == KTX_SUCCESS);
+
+					VkBufferImageCopy bufferCopyRegion = {};
+					bufferCopyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+					bufferCopyRegion.imageSubresource.mipLevel = level;
+					bufferCopyRegion.imageSubresource.baseArrayLayer = face;
+					bufferCopyRegion.imageSubresource.layerCount = 1;
+					bufferCopyRegion.imageExtent.width = ktxTexture->baseWidth >> level;
+					bufferCopyRegion.imageExtent.height = ktxTexture->baseHeight >> level;
+					bufferCopyRegion.imageExtent.depth = 1;
+					bufferCopyRegion.bufferOffset = offset;
+
+					bufferCopyRegions.push_back(bufferCopyRegion);
+				}
 			}
 		}
 
@@ -771,11 +809,8 @@ namespace vks
 		imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 		imageCreateInfo.extent = { width, height, 1 };
 		imageCreateInfo.usage = imageUsageFlags;
-		// Ensure that the TRANSFER_DST bit is set for staging
-		if (!(imageCreateInfo.usage & VK_IMAGE_USAGE_TRANSFER_DST_BIT))
-		{
-			imageCreateInfo.usage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
-		}
+		// Ensure that the TRANSFER_DST bit is set for staging, or the HOST_TRANSFER bit for host image copies
+		imageCreateInfo.usage |= hostImageCopy ? VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT : VK_IMAGE_USAGE_TRANSFER_DST_BIT;
 		// Cube faces count as array layers in Vulkan
 		imageCreateInfo.arrayLayers = 6;
 		// This flag is required for cube map images
@@ -790,11 +825,9 @@ namespace vks
 		memAllocInfo.memoryTypeIndex = device->getMemoryType(memReqs.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
 		VK_CHECK_RESULT(vkAllocateMemory(device->logicalDevice, &memAllocInfo, nullptr, &deviceMemory));
+		memorySize = memAllocInfo.allocationSize;
 		VK_CHECK_RESULT(vkBindImageMemory(device->logicalDevice, image, deviceMemory, 0));
 
-		// Use a separate command buffer for texture loading
-		VkCommandBuffer copyCmd = device->createCommandBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
-
 		// Image barrier for optimal image (target)
 		// Set initial layout for all array layers (faces) of the optimal (target) tiled texture
 		VkImageSubresourceRange subresourceRange = {};
@@ -803,32 +836,46 @@ namespace vks
 		subresourceRange.levelCount = mipLevels;
 		subresourceRange.layerCount = 6;
 
-		vks::tools::setImageLayout(
-			copyCmd,
-			image,
-			VK_IMAGE_LAYOUT_UNDEFINED,
-			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-			subresourceRange);
+		if (hostImageCopy)
+		{
+			// No command buffer is required, so this path can run on any thread without synchronization
+			vks::copyKTXFromHost(device, image, ktxTexture, imageLayout);
+			this->imageLayout = imageLayout;
+		}
+		else
+		{
+			// Command buffers are allocated from the device's default pool, which must not be accessed by multiple threads at once
+			std::lock_guard<std::mutex> lock(device->transferMutex);
+			// Use a separate command buffer for texture loading
+			VkCommandBuffer copyCmd = device->createCommandBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
 
-		// Copy the cube map faces from the staging buffer to the optimal tiled image
-		vkCmdCopyBufferToImage(
-			copyCmd,
-			stagingBuffer,
-			image,
-			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-			static_cast<uint32_t>(bufferCopyRegions.size()),
-			bufferCopyRegions.data());
+			vks::tools::setImageLayout(
+				copyCmd,
+				image,
+				VK_IMAGE_LAYOUT_UNDEFINED,
+				VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+				subresourceRange);
 
-		// Change texture image layout to shader read after all faces have been copied
-		this->imageLayout = imageLayout;
-		vks::tools::setImageLayout(
-			copyCmd,
-			image,
-			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-			imageLayout,
-			subresourceRange);
+			// Copy the cube map faces from the staging buffer to the optimal tiled image
+			vkCmdCopyBufferToImage(
+				copyCmd,
+				stagingBuffer,
+				image,
+				VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+				static_cast<uint32_t>(bufferCopyRegions.size()),
+				bufferCopyRegions.data());
 
-		device->flushCommandBuffer(copyCmd, copyQueue);
+			// Change texture image layout to shader read after all faces have been copied
+			this->imageLayout = imageLayout;
+			vks::tools::setImageLayout(
+				copyCmd,
+				image,
+				VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+				imageLayout,
+				subresourceRange);
+
+			device->flushCommandBuffer(copyCmd, copyQueue);
+		}
 
 		// Create sampler
 		VkSamplerCreateInfo samplerCreateInfo = vks::initializers::samplerCreateInfo();
@@ -866,4 +913,107 @@ namespace vks
 		updateDescriptor();
 	}
 
+
+	CompressedTextureFormat getCompressedTextureFormat(vks::VulkanDevice *device)
+	{
+		// Ordered by preference, BC7 and ASTC 4x4 have the best quality at 8 bits per texel, BC3 and ETC2 are more widely supported
+		const std::vector<std::pair<CompressedTextureFormat, VkBool32>> candidates = {
+			{ { VK_FORMAT_BC7_UNORM_BLOCK, "_bc7" }, device->enabledFeatures.textureCompressionBC },
+			{ { VK_FORMAT_ASTC_4x4_UNORM_BLOCK, "_astc" }, device->enabledFeatures.textureCompressionASTC_LDR },
+			{ { VK_FORMAT_BC3_UNORM_BLOCK, "_bc3" }, device->enabledFeatures.textureCompressionBC },
+			{ { VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK, "_etc2" }, device->enabledFeatures.textureCompressionETC2 },
+		};
+		for (auto& candidate : candidates) {
+			if (!candidate.second) {
+				continue;
+			}
+			VkFormatProperties formatProperties;
+			vkGetPhysicalDeviceFormatProperties(device->physicalDevice, candidate.first.format, &formatProperties);
+			const VkFormatFeatureFlags requiredFeatures = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT | VK_FORMAT_FEATURE_TRANSFER_DST_BIT;
+			if ((formatProperties.optimalTilingFeatures & requiredFeatures) == requiredFeatures) {
+				return candidate.first;
+			}
+		}
+		return CompressedTextureFormat();
+	}
+
+	std::string getCookedTextureFilename(const std::string &filename, const CompressedTextureFormat &format)
+	{
+		if (format.format == VK_FORMAT_UNDEFINED) {
+			return "";
+		}
+		const size_t extensionPos = filename.find_last_of('.');
+		const std::string cookedFilename = filename.substr(0, extensionPos) + format.suffix + ".ktx";
+#if defined(__ANDROID__)
+		AAsset *asset = AAssetManager_open(androidApp->activity->assetManager, cookedFilename.c_str(), AASSET_MODE_UNKNOWN);
+		if (!asset) {
+			return "";
+		}
+		AAsset_close(asset);
+		return cookedFilename;
+#else
+		return vks::tools::fileExists(cookedFilename) ? cookedFilename : "";
+#endif
+	}
+
+	/**
+	* Upload all mip levels, array layers and faces of a ktx texture with host image copies
+	*
+	* @param device Vulkan device the image has been created on (host image copies need to be enabled)
+	* @param image Image created with VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT in VK_IMAGE_LAYOUT_UNDEFINED
+	* @param ktxTexture Texture to copy the image data from
+	* @param imageLayout Layout the image is transitioned to on the host and copied in, must be one of the device's host image copy destination layouts
+	*
+	* @note Doesn't use a queue or a command buffer, so it can be called from any thread as long as no other thread accesses the image
+	*/
+	void copyKTXFromHost(vks::VulkanDevice *device, VkImage image, ktxTexture *ktxTexture, VkImageLayout imageLayout)
+	{
+		// Cube faces are stored as array layers
+		const uint32_t layerCount = ktxTexture->numLayers * ktxTexture->numFaces;
+
+		// The image is copied in its final layout, so a single transition on the host replaces the barriers around the copy
+		VkHostImageLayoutTransitionInfoEXT transitionInfo{};
+		transitionInfo.sType = VK_STRUCTURE_TYPE_HOST_IMAGE_LAYOUT_TRANSITION_INFO_EXT;
+		transitionInfo.image = image;
+		transitionInfo.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		transitionInfo.newLayout = imageLayout;
+		transitionInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, ktxTexture->numLevels, 0, layerCount };
+		VK_CHECK_RESULT(device->vkTransitionImageLayoutEXT(device->logicalDevice, 1, &transitionInfo));
+
+		// Ktx image data is tightly packed, so each region can point directly into the texture's data
+		ktx_uint8_t *ktxTextureData = ktxTexture_GetData(ktxTexture);
+		std::vector<VkMemoryToImageCopyEXT> memoryToImageCopies;
+		for (uint32_t layer = 0; layer < ktxTexture->numLayers; layer++)
+		{
+			for (uint32_t face = 0; face < ktxTexture->numFaces; face++)
+			{
+				for (uint32_t level = 0; level < ktxTexture->numLevels; level++)
+				{
+					ktx_size_t offset;
+					KTX_error_code result = ktxTexture_GetImageOffset(ktxTexture, level, layer, face, &offset);
+					assert(result == KTX_SUCCESS);
+
+					VkMemoryToImageCopyEXT memoryToImageCopy{};
+					memoryToImageCopy.sType = VK_STRUCTURE_TYPE_MEMORY_TO_IMAGE_COPY_EXT;
+					memoryToImageCopy.pHostPointer = ktxTextureData + offset;
+					memoryToImageCopy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+					memoryToImageCopy.imageSubresource.mipLevel = level;
+					memoryToImageCopy.imageSubresource.baseArrayLayer = layer * ktxTexture->numFaces + face;
+					memoryToImageCopy.imageSubresource.layerCount = 1;
+					memoryToImageCopy.imageExtent.width = std::max(1u, ktxTexture->baseWidth >> level);
+					memoryToImageCopy.imageExtent.height = std::max(1u, ktxTexture->baseHeight >> level);
+					memoryToImageCopy.imageExtent.depth = 1;
+					memoryToImageCopies.push_back(memoryToImageCopy);
+				}
+			}
+		}
+
+		VkCopyMemoryToImageInfoEXT copyMemoryInfo{};
+		copyMemoryInfo.sType = VK_STRUCTURE_TYPE_COPY_MEMORY_TO_IMAGE_INFO_EXT;
+		copyMemoryInfo.dstImage = image;
+		copyMemoryInfo.dstImageLayout = imageLayout;
+		copyMemoryInfo.regionCount = static_cast<uint32_t>(memoryToImageCopies.size());
+		copyMemoryInfo.pRegions = memoryToImageCopies.data();
+		VK_CHECK_RESULT(device->vkCopyMemoryToImageEXT(device->logicalDevice, &copyMemoryInfo));
+	}
 }
@@ -41,6 +41,8 @@ class Texture
 	uint32_t              layerCount;
 	VkDescriptorImageInfo descriptor;
 	VkSampler             sampler;
+	// Size of the device memory allocated for the image
+	VkDeviceSize          memorySize{ 0 };
 
 	void      updateDescriptor();
 	void      destroy();
@@ -94,4 +96,21 @@ class TextureCubeMap : public Texture
 	    VkImageUsageFlags  imageUsageFlags = VK_IMAGE_USAGE_SAMPLED_BIT,
 	    VkImageLayout      imageLayout     = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 };
+
+/*
+ * Textures can be cooked offline into block compressed ktx files with precomputed mip maps, which are stored next to the source
+ * texture with a format specific suffix (e.g. "stone_bc7.ktx" for "stone.ktx" or "stone.png")
+ */
+struct CompressedTextureFormat
+{
+	VkFormat    format{ VK_FORMAT_UNDEFINED };
+	std::string suffix;
+};
+
+/** @brief Returns the preferred block compressed format that is enabled and supports filtered sampling on the device (BC7, ASTC 4x4, BC3, ETC2), format is undefined if none is available */
+CompressedTextureFormat getCompressedTextureFormat(vks::VulkanDevice *device);
+/** @brief Returns the file name of the cooked variant of a texture for the given format, or an empty string if the texture hasn't been cooked for that format */
+std::string getCookedTextureFilename(const std::string &filename, const CompressedTextureFormat &format);
+/** @brief Uploads all levels, layers and faces of a ktx texture with host image copies, used by the loaders if VulkanDevice::hostImageCopyAvailable returns true for the image */
+void copyKTXFromHost(vks::VulkanDevice *device, VkImage image, ktxTexture *ktxTexture, VkImageLayout imageLayout);
 }        // namespace vks
@@ -2,7 +2,7 @@
 /*
 * UI overlay class using ImGui
 *
-* Copyright (C) 2017-2024 by Sascha Willems - www.saschawillems.de
+* Copyright (C) 2017-2025 by Sascha Willems - www.saschawillems.de
 *
 * This code is licensed under the MIT license (MIT) (http://opensource.org/licenses/MIT)
 */
@@ -216,9 +216,52 @@ namespace vks
 		vkUpdateDescriptorSets(device->logicalDevice, static_cast<uint32_t>(writeDescriptorSets.size()), writeDescriptorSets.data(), 0, nullptr);
 	}
 
-	/** Prepare a separate pipeline for the UI overlay rendering decoupled from the main application */
-	void UIOverlay::preparePipeline(const VkPipelineCache pipelineCache, const VkRenderPass renderPass, const VkFormat colorFormat, const VkFormat depthFormat)
+	/** Prepare a separate render pass and pipeline for the UI overlay rendering decoupled from the main application */
+	void UIOverlay::preparePipeline(const VkPipelineCache pipelineCache, const VkFormat colorFormat)
 	{
+		// Render pass
+		// The overlay is drawn on top of the presentable image the example rendered to, so its contents are loaded and the image is handed back for presentation
+		VkAttachmentDescription attachment{};
+		attachment.format = colorFormat;
+		attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+		attachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+		attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+		attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+		attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		attachment.initialLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+		attachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+		VkAttachmentReference colorReference = { 0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
+
+		VkSubpassDescription subpassDescription{};
+		subpassDescription.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+		subpassDescription.colorAttachmentCount = 1;
+		subpassDescription.pColorAttachments = &colorReference;
+
+		// Wait for the example's color attachment writes, which are made available by the semaphore the overlay submission waits on
+		std::array<VkSubpassDependency, 2> dependencies{};
+		dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+		dependencies[0].dstSubpass = 0;
+		dependencies[0].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		dependencies[0].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		dependencies[1].srcSubpass = 0;
+		dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+		dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		dependencies[1].dstStageMask = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+		dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		dependencies[1].dstAccessMask = 0;
+
+		VkRenderPassCreateInfo renderPassInfo = vks::initializers::renderPassCreateInfo();
+		renderPassInfo.attachmentCount = 1;
+		renderPassInfo.pAttachments = &attachment;
+		renderPassInfo.subpassCount = 1;
+		renderPassInfo.pSubpasses = &subpassDescription;
+		renderPassInfo.dependencyCount = static_cast<uint32_t>(dependencies.size());
+		renderPassInfo.pDependencies = dependencies.data();
+		VK_CHECK_RESULT(vkCreateRenderPass(device->logicalDevice, &renderPassInfo, nullptr, &renderPass));
+
 		// Pipeline layout
 		// Push constants for UI rendering parameters
 		VkPushConstantRange pushConstantRange = vks::initializers::pushConstantRange(VK_SHADER_STAGE_VERTEX_BIT, sizeof(PushConstBlock), 0);
@@ -255,7 +298,7 @@ namespace vks
 			vks::initializers::pipelineViewportStateCreateInfo(1, 1, 0);
 
 		VkPipelineMultisampleStateCreateInfo multisampleState =
-			vks::initializers::pipelineMultisampleStateCreateInfo(rasterizationSamples);
+			vks::initializers::pipelineMultisampleStateCreateInfo(VK_SAMPLE_COUNT_1_BIT);
 
 		std::vector<VkDynamicState> dynamicStateEnables = {
 			VK_DYNAMIC_STATE_VIEWPORT,
@@ -275,20 +318,6 @@ namespace vks
 		pipelineCreateInfo.pDynamicState = &dynamicState;
 		pipelineCreateInfo.stageCount = static_cast<uint32_t>(shaders.size());
 		pipelineCreateInfo.pStages = shaders.data();
-		pipelineCreateInfo.subpass = subpass;
-		
-#if defined(VK_KHR_dynamic_rendering)
-		// SRS - if we are using dynamic rendering (i.e. renderPass null), must define color, depth and stencil attachments at pipeline create time
-		VkPipelineRenderingCreateInfo pipelineRenderingCreateInfo = {};
-		if (renderPass == VK_NULL_HANDLE) {
-			pipelineRenderingCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
-			pipelineRenderingCreateInfo.colorAttachmentCount = 1;
-			pipelineRenderingCreateInfo.pColorAttachmentFormats = &colorFormat;
-			pipelineRenderingCreateInfo.depthAttachmentFormat = depthFormat;
-			pipelineRenderingCreateInfo.stencilAttachmentFormat = depthFormat;
-			pipelineCreateInfo.pNext = &pipelineRenderingCreateInfo;
-		}
-#endif
 
 		// Vertex bindings an attributes based on ImGui vertex definition
 		std::vector<VkVertexInputBindingDescription> vertexInputBindings = {
@@ -310,48 +339,77 @@ namespace vks
 		VK_CHECK_RESULT(vkCreateGraphicsPipelines(device->logicalDevice, pipelineCache, 1, &pipelineCreateInfo, nullptr, &pipeline));
 	}
 
-	/** Update vertex and index buffer containing the imGui elements when required */
-	bool UIOverlay::update()
+	void UIOverlay::prepareFrames(VkCommandPool commandPool, const std::vector<VkImageView>& imageViews, uint32_t width, uint32_t height)
 	{
-		ImDrawData* imDrawData = ImGui::GetDrawData();
-		bool updateCmdBuffers = false;
+		this->commandPool = commandPool;
+		this->width = width;
+		this->height = height;
+
+		// The number of swap chain images may change on resize
+		for (size_t i = imageViews.size(); i < frames.size(); i++) {
+			frames[i].vertexBuffer.destroy();
+			frames[i].indexBuffer.destroy();
+			vkDestroyFramebuffer(device->logicalDevice, frames[i].framebuffer, nullptr);
+			vkFreeCommandBuffers(device->logicalDevice, commandPool, 1, &frames[i].commandBuffer);
+		}
+		frames.resize(imageViews.size());
+
+		for (size_t i = 0; i < frames.size(); i++) {
+			Frame& frame = frames[i];
+			vkDestroyFramebuffer(device->logicalDevice, frame.framebuffer, nullptr);
+			VkFramebufferCreateInfo frameBufferCreateInfo = vks::initializers::framebufferCreateInfo();
+			frameBufferCreateInfo.renderPass = renderPass;
+			frameBufferCreateInfo.attachmentCount = 1;
+			frameBufferCreateInfo.pAttachments = &imageViews[i];
+			frameBufferCreateInfo.width = width;
+			frameBufferCreateInfo.height = height;
+			frameBufferCreateInfo.layers = 1;
+			VK_CHECK_RESULT(vkCreateFramebuffer(device->logicalDevice, &frameBufferCreateInfo, nullptr, &frame.framebuffer));
+			if (frame.commandBuffer == VK_NULL_HANDLE) {
+				VkCommandBufferAllocateInfo cmdBufAllocateInfo = vks::initializers::commandBufferAllocateInfo(commandPool, VK_COMMAND_BUFFER_LEVEL_PRIMARY, 1);
+				VK_CHECK_RESULT(vkAllocateCommandBuffers(device->logicalDevice, &cmdBufAllocateInfo, &frame.commandBuffer));
+			}
+			// Force a re-record, as the command buffer references the old frame buffer
+			frame.drawDataVersion = 0;
+		}
+	}
 
-		if (!imDrawData) { return false; };
+	void UIOverlay::update()
+	{
+		drawDataVersion++;
+	}
 
+	void UIOverlay::reserveBuffer(vks::Buffer& buffer, VkBufferUsageFlags usage, VkDeviceSize size)
+	{
+		if ((buffer.buffer != VK_NULL_HANDLE) && (buffer.size >= size)) {
+			return;
+		}
 		// Note: Alignment is done inside buffer creation
-		VkDeviceSize vertexBufferSize = imDrawData->TotalVtxCount * sizeof(ImDrawVert);
-		VkDeviceSize indexBufferSize = imDrawData->TotalIdxCount * sizeof(ImDrawIdx);
+		const VkDeviceSize bufferSize = std::max(size, buffer.size * 2);
+		buffer.destroy();
+		VK_CHECK_RESULT(device->createBuffer(usage, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &buffer, bufferSize));
+		VK_CHECK_RESULT(buffer.map());
+	}
 
-		// Update buffers only if vertex or index count has been changed compared to current buffer size
-		if ((vertexBufferSize == 0) || (indexBufferSize == 0)) {
-			return false;
+	VkCommandBuffer UIOverlay::getCommandBuffer(uint32_t frameIndex)
+	{
+		ImDrawData* imDrawData = ImGui::GetDrawData();
+		if ((!visible) || (!imDrawData) || (imDrawData->TotalVtxCount == 0) || (imDrawData->TotalIdxCount == 0)) {
+			return VK_NULL_HANDLE;
 		}
 
-		// Vertex buffer
-		if ((vertexBuffer.buffer == VK_NULL_HANDLE) || (vertexCount != imDrawData->TotalVtxCount)) {
-			vertexBuffer.unmap();
-			vertexBuffer.destroy();
-			VK_CHECK_RESULT(device->createBuffer(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, &vertexBuffer, vertexBufferSize));
-			vertexCount = imDrawData->TotalVtxCount;
-			vertexBuffer.unmap();
-			vertexBuffer.map();
-			updateCmdBuffers = true;
+		Frame& frame = frames[frameIndex];
+		if (frame.drawDataVersion == drawDataVersion) {
+			return frame.commandBuffer;
 		}
 
-		// Index buffer
-		if ((indexBuffer.buffer == VK_NULL_HANDLE) || (indexCount < imDrawData->TotalIdxCount)) {
-			indexBuffer.unmap();
-			indexBuffer.destroy();
-			VK_CHECK_RESULT(device->createBuffer(VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, &indexBuffer, indexBufferSize));
-			indexCount = imDrawData->TotalIdxCount;
-			indexBuffer.map();
-			updateCmdBuffers = true;
-		}
+		// The previous submission of this frame has finished, as the base waits for the queue to become idle after presenting
+		reserveBuffer(frame.vertexBuffer, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, imDrawData->TotalVtxCount * sizeof(ImDrawVert));
+		reserveBuffer(frame.indexBuffer, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, imDrawData->TotalIdxCount * sizeof(ImDrawIdx));
 
 		// Upload data
-		ImDrawVert* vtxDst = (ImDrawVert*)vertexBuffer.mapped;
-		ImDrawIdx* idxDst = (ImDrawIdx*)indexBuffer.mapped;
-
+		ImDrawVert* vtxDst = (ImDrawVert*)frame.vertexBuffer.mapped;
+		ImDrawIdx* idxDst = (ImDrawIdx*)frame.indexBuffer.mapped;
 		for (int n = 0; n < imDrawData->CmdListsCount; n++) {
 			const ImDrawList* cmd_list = imDrawData->CmdLists[n];
 			memcpy(vtxDst, cmd_list->VtxBuffer.Data, cmd_list->VtxBuffer.Size * sizeof(ImDrawVert));
@@ -360,23 +418,30 @@ namespace vks
 			idxDst += cmd_list->IdxBuffer.Size;
 		}
 
-		// Flush to make writes visible to GPU
-		vertexBuffer.flush();
-		indexBuffer.flush();
-
-		return updateCmdBuffers;
+		VkCommandBufferBeginInfo cmdBufInfo = vks::initializers::commandBufferBeginInfo();
+		VK_CHECK_RESULT(vkBeginCommandBuffer(frame.commandBuffer, &cmdBufInfo));
+		VkRenderPassBeginInfo renderPassBeginInfo = vks::initializers::renderPassBeginInfo();
+		renderPassBeginInfo.renderPass = renderPass;
+		renderPassBeginInfo.framebuffer = frame.framebuffer;
+		renderPassBeginInfo.renderArea.extent.width = width;
+		renderPassBeginInfo.renderArea.extent.height = height;
+		vkCmdBeginRenderPass(frame.commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+		const VkViewport viewport = vks::initializers::viewport((float)width, (float)height, 0.0f, 1.0f);
+		vkCmdSetViewport(frame.commandBuffer, 0, 1, &viewport);
+		draw(frame.commandBuffer, frame);
+		vkCmdEndRenderPass(frame.commandBuffer);
+		VK_CHECK_RESULT(vkEndCommandBuffer(frame.commandBuffer));
+
+		frame.drawDataVersion = drawDataVersion;
+		return frame.commandBuffer;
 	}
 
-	void UIOverlay::draw(const VkCommandBuffer commandBuffer)
+	void UIOverlay::draw(const VkCommandBuffer commandBuffer, const Frame& frame)
 	{
 		ImDrawData* imDrawData = ImGui::GetDrawData();
 		int32_t vertexOffset = 0;
 		int32_t indexOffset = 0;
 
-		if ((!imDrawData) || (imDrawData->CmdListsCount == 0)) {
-			return;
-		}
-
 		ImGuiIO& io = ImGui::GetIO();
 
 		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
@@ -387,8 +452,8 @@ namespace vks
 		vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PushConstBlock), &pushConstBlock);
 
 		VkDeviceSize offsets[1] = { 0 };
-		vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer.buffer, offsets);
-		vkCmdBindIndexBuffer(commandBuffer, indexBuffer.buffer, 0, VK_INDEX_TYPE_UINT16);
+		vkCmdBindVertexBuffers(commandBuffer, 0, 1, &frame.vertexBuffer.buffer, offsets);
+		vkCmdBindIndexBuffer(commandBuffer, frame.indexBuffer.buffer, 0, VK_INDEX_TYPE_UINT16);
 
 		for (int32_t i = 0; i < imDrawData->CmdListsCount; i++)
 		{
@@ -417,8 +482,14 @@ namespace vks
 
 	void UIOverlay::freeResources()
 	{
-		vertexBuffer.destroy();
-		indexBuffer.destroy();
+		for (auto& frame : frames) {
+			frame.vertexBuffer.destroy();
+			frame.indexBuffer.destroy();
+			vkDestroyFramebuffer(device->logicalDevice, frame.framebuffer, nullptr);
+			vkFreeCommandBuffers(device->logicalDevice, commandPool, 1, &frame.commandBuffer);
+		}
+		frames.clear();
+		vkDestroyRenderPass(device->logicalDevice, renderPass, nullptr);
 		vkDestroyImageView(device->logicalDevice, fontView, nullptr);
 		vkDestroyImage(device->logicalDevice, fontImage, nullptr);
 		vkFreeMemory(device->logicalDevice, fontMemory, nullptr);
@@ -1,7 +1,7 @@
 /*
 * UI overlay class using ImGui
 *
-* Copyright (C) 2017-2024 by Sascha Willems - www.saschawillems.de
+* Copyright (C) 2017-2025 by Sascha Willems - www.saschawillems.de
 *
 * This code is licensed under the MIT license (MIT) (http://opensource.org/licenses/MIT)
 */
@@ -12,6 +12,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <array>
 #include <vector>
 #include <sstream>
 #include <iomanip>
@@ -36,13 +37,23 @@ namespace vks
 		vks::VulkanDevice* device{ nullptr };
 		VkQueue queue{ VK_NULL_HANDLE };
 
-		VkSampleCountFlagBits rasterizationSamples{ VK_SAMPLE_COUNT_1_BIT };
-		uint32_t subpass{ 0 };
-
-		vks::Buffer vertexBuffer;
-		vks::Buffer indexBuffer;
-		int32_t vertexCount{ 0 };
-		int32_t indexCount{ 0 };
+		/**
+		* @brief Resources for every swap chain image
+		* @note The overlay is drawn on top of the swap chain image in a separate pass after the example's own command buffer,
+		* so changes to the overlay never require the example's command buffers to be re-recorded
+		*/
+		struct Frame {
+			/** @brief Persistently mapped and only ever grown, so updating the overlay doesn't allocate */
+			vks::Buffer vertexBuffer;
+			vks::Buffer indexBuffer;
+			VkFramebuffer framebuffer{ VK_NULL_HANDLE };
+			VkCommandBuffer commandBuffer{ VK_NULL_HANDLE };
+			/** @brief Version of the draw data the command buffer was recorded with */
+			uint64_t drawDataVersion{ 0 };
+		};
+		std::vector<Frame> frames;
+		/** @brief Incremented by update whenever ImGui generated new draw data */
+		uint64_t drawDataVersion{ 1 };
 
 		std::vector<VkPipelineShaderStageCreateInfo> shaders;
 
@@ -51,6 +62,8 @@ namespace vks
 		VkDescriptorSet descriptorSet{ VK_NULL_HANDLE };
 		VkPipelineLayout pipelineLayout{ VK_NULL_HANDLE };
 		VkPipeline pipeline{ VK_NULL_HANDLE };
+		VkRenderPass renderPass{ VK_NULL_HANDLE };
+		VkCommandPool commandPool{ VK_NULL_HANDLE };
 
 		VkDeviceMemory fontMemory{ VK_NULL_HANDLE };
 		VkImage fontImage{ VK_NULL_HANDLE };
@@ -63,6 +76,7 @@ namespace vks
 		} pushConstBlock;
 
 		bool visible{ true };
+		/** @brief Set if a widget changed a value, which the example may have baked into its command buffers */
 		bool updated{ false };
 		float scale{ 1.0f };
 		float updateTimer{ 0.0f };
@@ -70,11 +84,20 @@ namespace vks
 		UIOverlay();
 		~UIOverlay();
 
-		void preparePipeline(const VkPipelineCache pipelineCache, const VkRenderPass renderPass, const VkFormat colorFormat, const VkFormat depthFormat);
+		/** @brief Creates the render pass that loads the swap chain image and the pipeline the overlay is drawn with */
+		void preparePipeline(const VkPipelineCache pipelineCache, const VkFormat colorFormat);
 		void prepareResources();
-
-		bool update();
-		void draw(const VkCommandBuffer commandBuffer);
+		/** @brief (Re)creates the per frame resources for the given swap chain image views, buffers of existing frames are kept */
+		void prepareFrames(VkCommandPool commandPool, const std::vector<VkImageView>& imageViews, uint32_t width, uint32_t height);
+
+		/** @brief Marks the draw data of the last ImGui::Render call as new, so each frame uploads and records it the next time it is submitted */
+		void update();
+		/**
+		* @brief Returns the command buffer that draws the overlay onto the given swap chain image
+		* @note Vertex data is uploaded and the command buffer re-recorded only if the draw data changed since that frame was last submitted
+		* @return VK_NULL_HANDLE if there is nothing to draw
+		*/
+		VkCommandBuffer getCommandBuffer(uint32_t frameIndex);
 		void resize(uint32_t width, uint32_t height);
 
 		void freeResources();
@@ -90,5 +113,13 @@ namespace vks
 		bool button(const char* caption);
 		bool colorPicker(const char* caption, float* color);
 		void text(const char* formatstr, ...);
+
+	private:
+		uint32_t width{ 0 };
+		uint32_t height{ 0 };
+
+		/** @brief Recreates the buffer if it is smaller than the requested size, growing by at least a factor of two */
+		void reserveBuffer(vks::Buffer& buffer, VkBufferUsageFlags usage, VkDeviceSize size);
+		void draw(const VkCommandBuffer commandBuffer, const Frame& frame);
 	};
 }
@@ -0,0 +1,125 @@
+/*
+* Vulkan transient uniform allocator
+*
+* Copyright (C) 2025 by Sascha Willems - www.saschawillems.de
+*
+* This code is licensed under the MIT license (MIT) (http://opensource.org/licenses/MIT)
+*/
+
+#include "VulkanUniformAllocator.h"
+
+#include <algorithm>
+
+namespace vks
+{
+	void UniformAllocator::create(vks::VulkanDevice* vulkanDevice, uint32_t frameCount, VkDeviceSize frameSize, bool deviceAddress)
+	{
+		assert(frameCount > 0);
+		this->vulkanDevice = vulkanDevice;
+		this->frameCount = frameCount;
+		alignment = std::max(vulkanDevice->properties.limits.minUniformBufferOffsetAlignment, VkDeviceSize(16));
+		this->frameSize = vks::tools::alignedVkSize(frameSize, alignment);
+		// Host coherent memory, so writes don't need to be flushed, which keeps allocations free of any API calls
+		VkBufferUsageFlags usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+		if (deviceAddress) {
+			usage |= VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+		}
+		VK_CHECK_RESULT(vulkanDevice->createBuffer(usage, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &buffer, this->frameSize * frameCount));
+		VK_CHECK_RESULT(buffer.map());
+		if (deviceAddress) {
+			VkBufferDeviceAddressInfoKHR bufferDeviceAddressInfo{};
+			bufferDeviceAddressInfo.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
+			bufferDeviceAddressInfo.buffer = buffer.buffer;
+			PFN_vkGetBufferDeviceAddressKHR vkGetBufferDeviceAddressKHR = reinterpret_cast<PFN_vkGetBufferDeviceAddressKHR>(vkGetDeviceProcAddr(vulkanDevice->logicalDevice, "vkGetBufferDeviceAddressKHR"));
+			bufferDeviceAddress = vkGetBufferDeviceAddressKHR(vulkanDevice->logicalDevice, &bufferDeviceAddressInfo);
+		}
+		frameIndex = 0;
+		reservedSize = 0;
+		frameOffset = 0;
+		peakUsage = 0;
+	}
+
+	void UniformAllocator::destroy()
+	{
+		if (!vulkanDevice) {
+			return;
+		}
+		buffer.destroy();
+		bufferDeviceAddress = 0;
+		vulkanDevice = nullptr;
+	}
+
+	bool UniformAllocator::created() const
+	{
+		return vulkanDevice != nullptr;
+	}
+
+	uint32_t UniformAllocator::getFrameCount() const
+	{
+		return frameCount;
+	}
+
+	UniformAllocator::Slot UniformAllocator::reserve(VkDeviceSize size)
+	{
+		assert(frameOffset == reservedSize);
+		if (reservedSize + size > frameSize) {
+			vks::tools::exitFatal("Uniform allocator ran out of space, " + std::to_string(reservedSize + size) + " bytes reserved in a frame of " + std::to_string(frameSize) + " bytes", -1);
+		}
+		Slot slot{};
+		slot.offset = reservedSize;
+		slot.size = size;
+		reservedSize = std::min(vks::tools::alignedVkSize(reservedSize + size, alignment), frameSize);
+		frameOffset = reservedSize;
+		return slot;
+	}
+
+	uint32_t UniformAllocator::getOffset(const Slot& slot, uint32_t frameIndex) const
+	{
+		assert(frameIndex < frameCount);
+		return static_cast<uint32_t>(frameIndex * frameSize + slot.offset);
+	}
+
+	void* UniformAllocator::getMapped(const Slot& slot) const
+	{
+		return static_cast<uint8_t*>(buffer.mapped) + frameIndex * frameSize + slot.offset;
+	}
+
+	void UniformAllocator::beginFrame(uint32_t frameIndex)
+	{
+		assert(frameIndex < frameCount);
+		peakUsage = std::max(peakUsage, frameOffset);
+		this->frameIndex = frameIndex;
+		frameOffset = reservedSize;
+	}
+
+	UniformAllocator::Allocation UniformAllocator::allocate(VkDeviceSize size)
+	{
+		if (frameOffset + size > frameSize) {
+			vks::tools::exitFatal("Uniform allocator ran out of space, " + std::to_string(frameOffset + size) + " bytes requested in a frame of " + std::to_string(frameSize) + " bytes", -1);
+		}
+		const VkDeviceSize offset = frameIndex * frameSize + frameOffset;
+		frameOffset = std::min(vks::tools::alignedVkSize(frameOffset + size, alignment), frameSize);
+		Allocation allocation{};
+		allocation.mapped = static_cast<uint8_t*>(buffer.mapped) + offset;
+		allocation.offset = static_cast<uint32_t>(offset);
+		allocation.size = size;
+		allocation.deviceAddress = (bufferDeviceAddress != 0) ? bufferDeviceAddress + offset : 0;
+		return allocation;
+	}
+
+	VkDescriptorBufferInfo UniformAllocator::getDescriptor(VkDeviceSize range) const
+	{
+		assert(range <= vulkanDevice->properties.limits.maxUniformBufferRange);
+		return { buffer.buffer, 0, range };
+	}
+
+	VkDeviceSize UniformAllocator::getFrameUsage() const
+	{
+		return frameOffset;
+	}
+
+	VkDeviceSize UniformAllocator::getPeakUsage() const
+	{
+		return std::max(peakUsage, frameOffset);
+	}
+}
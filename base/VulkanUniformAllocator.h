@@ -0,0 +1,120 @@
+/*
+* Vulkan transient uniform allocator
+*
+* One persistently mapped uniform buffer split into a region per frame
+* Uniform data for a frame is written to that frame's region, so there are no per object buffers, allocations or descriptors:
+* A single descriptor of type VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC covers the whole buffer, and the offset of the data is passed
+* as the dynamic offset when binding it (or its device address is passed to the shader if the buffer was created with device address support)
+*
+* Data that is updated every frame but bound by prerecorded command buffers is written to slots, which are reserved once and have a fixed
+* offset in every frame's region. The remainder of a region is handed out with a bump pointer that is reset at the start of each frame,
+* for data of command buffers that are recorded every frame.
+*
+* Copyright (C) 2025 by Sascha Willems - www.saschawillems.de
+*
+* This code is licensed under the MIT license (MIT) (http://opensource.org/licenses/MIT)
+*/
+
+#pragma once
+
+#include <vector>
+
+#include "vulkan/vulkan.h"
+#include "VulkanDevice.h"
+#include "VulkanBuffer.h"
+#include "VulkanTools.h"
+
+namespace vks
+{
+	class UniformAllocator
+	{
+	public:
+		/** @brief Space reserved in every frame's region, see reserve */
+		struct Slot {
+			/** @brief Offset from the start of a frame's region */
+			VkDeviceSize offset{ 0 };
+			VkDeviceSize size{ 0 };
+		};
+
+		struct Allocation {
+			/** @brief Host pointer the uniform data is written to */
+			void* mapped{ nullptr };
+			/** @brief Offset from the start of the buffer, to be passed as the dynamic offset for the allocator's descriptor */
+			uint32_t offset{ 0 };
+			VkDeviceSize size{ 0 };
+			/** @brief Device address of the allocation, only set if the allocator was created with device address support */
+			VkDeviceAddress deviceAddress{ 0 };
+		};
+
+		/**
+		* @brief Creates the buffer
+		* @param frameCount Number of frames that can be in flight, each frame gets its own region (usually one per command buffer)
+		* @param frameSize Size of a frame's region in bytes, rounded up to the device's uniform buffer offset alignment
+		* @param deviceAddress Create the buffer with device address support (requires the bufferDeviceAddress feature to be enabled)
+		*/
+		void create(vks::VulkanDevice* vulkanDevice, uint32_t frameCount, VkDeviceSize frameSize, bool deviceAddress = false);
+		/** @brief Destroys the buffer, safe to call if create has not been called */
+		void destroy();
+		bool created() const;
+		/** @brief Number of frame regions, examples that use one region per command buffer recreate the allocator if this no longer matches (e.g. after a swap chain recreation changed the image count) */
+		uint32_t getFrameCount() const;
+
+		/**
+		* @brief Reserves size bytes at the same offset in every frame's region
+		* @note Slots have to be reserved before any transient allocations are made in the current frame
+		*/
+		Slot reserve(VkDeviceSize size);
+		/** @brief Dynamic offset of the slot in the region of the given frame, e.g. to bind it in the command buffer recorded for that frame */
+		uint32_t getOffset(const Slot& slot, uint32_t frameIndex) const;
+		/** @brief Host pointer to the slot in the current frame's region */
+		void* getMapped(const Slot& slot) const;
+		/** @brief Copies the data to the slot in the current frame's region */
+		template<typename T> void write(const Slot& slot, const T& data)
+		{
+			assert(sizeof(T) <= slot.size);
+			memcpy(getMapped(slot), &data, sizeof(T));
+		}
+
+		/**
+		* @brief Selects the region of the given frame for writes to slots and transient allocations, previous transient allocations from that region become invalid
+		* @note The frame's previous submission must have finished executing
+		*/
+		void beginFrame(uint32_t frameIndex);
+		/**
+		* @brief Allocates size bytes from the current frame's region that are valid until the region is selected again
+		* @note The offset is only known once the frame has begun, so this is meant for command buffers that are recorded every frame; use slots for prerecorded command buffers
+		*/
+		Allocation allocate(VkDeviceSize size);
+		/** @brief Allocates space for the data and copies it */
+		template<typename T> Allocation push(const T& data)
+		{
+			Allocation allocation = allocate(sizeof(T));
+			memcpy(allocation.mapped, &data, sizeof(T));
+			return allocation;
+		}
+
+		/**
+		* @brief Descriptor for a binding of type VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC that reads range bytes starting at the dynamic offset
+		* @note Range may not exceed the device's maxUniformBufferRange, and the range read at an allocation's offset must not be larger than the allocation
+		*/
+		VkDescriptorBufferInfo getDescriptor(VkDeviceSize range) const;
+		/** @brief Bytes used in the current frame, including the reserved slots */
+		VkDeviceSize getFrameUsage() const;
+		/** @brief Largest number of bytes allocated in a frame since the allocator was created */
+		VkDeviceSize getPeakUsage() const;
+
+	private:
+		vks::VulkanDevice* vulkanDevice{ nullptr };
+		vks::Buffer buffer;
+		VkDeviceAddress bufferDeviceAddress{ 0 };
+		VkDeviceSize alignment{ 0 };
+		VkDeviceSize frameSize{ 0 };
+		uint32_t frameCount{ 0 };
+		uint32_t frameIndex{ 0 };
+		// Size of the slots at the start of each region
+		VkDeviceSize reservedSize{ 0 };
+		// Bump pointer relative to the start of the current frame's region
+		VkDeviceSize frameOffset{ 0 };
+		VkDeviceSize peakUsage{ 0 };
+	};
+}
@@ -1,7 +1,7 @@
 /*
 * Vulkan glTF model and texture loading class based on tinyglTF (https://github.com/syoyo/tinygltf)
 *
-* Copyright (C) 2018-2024 by Sascha Willems - www.saschawillems.de
+* Copyright (C) 2018-2025 by Sascha Willems - www.saschawillems.de
 *
 * This code is licensed under the MIT license (MIT) (http://opensource.org/licenses/MIT)
 */
@@ -18,12 +18,20 @@
 #define TINYGLTF_NO_STB_IMAGE_WRITE
 
 #include "VulkanglTFModel.h"
+#include <atomic>
+#include <thread>
 
 VkDescriptorSetLayout vkglTF::descriptorSetLayoutImage = VK_NULL_HANDLE;
 VkDescriptorSetLayout vkglTF::descriptorSetLayoutUbo = VK_NULL_HANDLE;
 VkMemoryPropertyFlags vkglTF::memoryPropertyFlags = 0;
 uint32_t vkglTF::descriptorBindingFlags = vkglTF::DescriptorBindingFlags::ImageBaseColor;
 
+// Passed to the image loading function, so it can check for offline cooked variants of the images
+struct ImageLoaderContext {
+	std::string path;
+	vks::CompressedTextureFormat compressedFormat;
+};
+
 /*
 	We use a custom image loading function with tinyglTF, so we can do custom stuff loading ktx textures
 */
@@ -36,6 +44,12 @@ bool loadImageDataFunc(tinygltf::Image* image, const int imageIndex, std::string
 		}
 	}
 
+	// Images with a cooked block compressed variant don't need to be decoded, the variant is loaded instead
+	ImageLoaderContext* context = static_cast<ImageLoaderContext*>(userData);
+	if (context && !image->uri.empty() && !vks::getCookedTextureFilename(context->path + "/" + image->uri, context->compressedFormat).empty()) {
+		return true;
+	}
+
 	return tinygltf::LoadImageData(image, imageIndex, error, warning, req_width, req_height, bytes, size, userData);
 }
 
@@ -68,11 +82,12 @@ void vkglTF::Texture::destroy()
 	}
 }
 
-void vkglTF::Texture::fromglTfImage(tinygltf::Image &gltfimage, std::string path, vks::VulkanDevice *device, VkQueue copyQueue)
+void vkglTF::Texture::fromglTfImage(tinygltf::Image &gltfimage, std::string path, vks::VulkanDevice *device, VkQueue copyQueue, const vks::CompressedTextureFormat &compressedFormat)
 {
 	this->device = device;
 
 	bool isKtx = false;
+	std::string ktxFilename = path + "/" + gltfimage.uri;
 	// Image points to an external ktx file
 	if (gltfimage.uri.find_last_of(".") != std::string::npos) {
 		if (gltfimage.uri.substr(gltfimage.uri.find_last_of(".") + 1) == "ktx") {
@@ -80,6 +95,16 @@ void vkglTF::Texture::fromglTfImage(tinygltf::Image &gltfimage, std::string path
 		}
 	}
 
+	// Prefer a block compressed variant with precomputed mip maps if the image has been cooked offline for a format supported by the device
+	if (!gltfimage.uri.empty()) {
+		const std::string cookedFilename = vks::getCookedTextureFilename(path + "/" + gltfimage.uri, compressedFormat);
+		if (!cookedFilename.empty()) {
+			ktxFilename = cookedFilename;
+			isKtx = true;
+			cooked = true;
+		}
+	}
+
 	VkFormat format;
 
 	if (!isKtx) {
@@ -163,8 +188,11 @@ void vkglTF::Texture::fromglTfImage(tinygltf::Image &gltfimage, std::string path
 		memAllocInfo.allocationSize = memReqs.size;
 		memAllocInfo.memoryTypeIndex = device->getMemoryType(memReqs.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 		VK_CHECK_RESULT(vkAllocateMemory(device->logicalDevice, &memAllocInfo, nullptr, &deviceMemory));
+		memorySize = memAllocInfo.allocationSize;
 		VK_CHECK_RESULT(vkBindImageMemory(device->logicalDevice, image, deviceMemory, 0));
 
+		// The mip chain is generated with blits on the GPU, so this path always uses the device's command pool and queue
+		std::lock_guard<std::mutex> lock(device->transferMutex);
 		VkCommandBuffer copyCmd = device->createCommandBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
 
 		VkImageSubresourceRange subresourceRange = {};
@@ -280,7 +308,7 @@ void vkglTF::Texture::fromglTfImage(tinygltf::Image &gltfimage, std::string path
 	}
 	else {
 		// Texture is stored in an external ktx file
-		std::string filename = path + "/" + gltfimage.uri;
+		std::string filename = ktxFilename;
 
 		ktxTexture* ktxTexture;
 
@@ -318,46 +346,49 @@ void vkglTF::Texture::fromglTfImage(tinygltf::Image &gltfimage, std::string path
 		VkFormatProperties formatProperties;
 		vkGetPhysicalDeviceFormatProperties(device->physicalDevice, format, &formatProperties);
 
-		VkCommandBuffer copyCmd = device->createCommandBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
-		VkBuffer stagingBuffer;
-		VkDeviceMemory stagingMemory;
-
-		VkBufferCreateInfo bufferCreateInfo = vks::initializers::bufferCreateInfo();
-		bufferCreateInfo.size = ktxTextureSize;
-		// This buffer is used as a transfer source for the buffer copy
-		bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-		bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-		VK_CHECK_RESULT(vkCreateBuffer(device->logicalDevice, &bufferCreateInfo, nullptr, &stagingBuffer));
-
+		// Images are written directly from the ktx data with host image copies if the device supports them for this format
+		const bool hostImageCopy = device->hostImageCopyAvailable(format, VK_IMAGE_TYPE_2D, VK_IMAGE_USAGE_SAMPLED_BIT, 0, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+		VkBuffer stagingBuffer{ VK_NULL_HANDLE };
+		VkDeviceMemory stagingMemory{ VK_NULL_HANDLE };
 		VkMemoryAllocateInfo memAllocInfo = vks::initializers::memoryAllocateInfo();
 		VkMemoryRequirements memReqs;
-		vkGetBufferMemoryRequirements(device->logicalDevice, stagingBuffer, &memReqs);
-		memAllocInfo.allocationSize = memReqs.size;
-		memAllocInfo.memoryTypeIndex = device->getMemoryType(memReqs.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-		VK_CHECK_RESULT(vkAllocateMemory(device->logicalDevice, &memAllocInfo, nullptr, &stagingMemory));
-		VK_CHECK_RESULT(vkBindBufferMemory(device->logicalDevice, stagingBuffer, stagingMemory, 0));
-
-		uint8_t* data;
-		VK_CHECK_RESULT(vkMapMemory(device->logicalDevice, stagingMemory, 0, memReqs.size, 0, (void**)&data));
-		memcpy(data, ktxTextureData, ktxTextureSize);
-		vkUnmapMemory(device->logicalDevice, stagingMemory);
-
 		std::vector<VkBufferImageCopy> bufferCopyRegions;
-		for (uint32_t i = 0; i < mipLevels; i++)
-		{
-			ktx_size_t offset;
-			KTX_error_code result = ktxTexture_GetImageOffset(ktxTexture, i, 0, 0, &offset);
-			assert(result == KTX_SUCCESS);
-			VkBufferImageCopy bufferCopyRegion = {};
-			bufferCopyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-			bufferCopyRegion.imageSubresource.mipLevel = i;
-			bufferCopyRegion.imageSubresource.baseArrayLayer = 0;
-			bufferCopyRegion.imageSubresource.layerCount = 1;
-			bufferCopyRegion.imageExtent.width = std::max(1u, ktxTexture->baseWidth >> i);
-			bufferCopyRegion.imageExtent.height = std::max(1u, ktxTexture->baseHeight >> i);
-			bufferCopyRegion.imageExtent.depth = 1;
-			bufferCopyRegion.bufferOffset = offset;
-			bufferCopyRegions.push_back(bufferCopyRegion);
+
+		if (!hostImageCopy) {
+			VkBufferCreateInfo bufferCreateInfo = vks::initializers::bufferCreateInfo();
+			bufferCreateInfo.size = ktxTextureSize;
+			// This buffer is used as a transfer source for the buffer copy
+			bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+			bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+			VK_CHECK_RESULT(vkCreateBuffer(device->logicalDevice, &bufferCreateInfo, nullptr, &stagingBuffer));
+
+			vkGetBufferMemoryRequirements(device->logicalDevice, stagingBuffer, &memReqs);
+			memAllocInfo.allocationSize = memReqs.size;
+			memAllocInfo.memoryTypeIndex = device->getMemoryType(memReqs.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+			VK_CHECK_RESULT(vkAllocateMemory(device->logicalDevice, &memAllocInfo, nullptr, &stagingMemory));
+			VK_CHECK_RESULT(vkBindBufferMemory(device->logicalDevice, stagingBuffer, stagingMemory, 0));
+
+			uint8_t* data;
+			VK_CHECK_RESULT(vkMapMemory(device->logicalDevice, stagingMemory, 0, memReqs.size, 0, (void**)&data));
+			memcpy(data, ktxTextureData, ktxTextureSize);
+			vkUnmapMemory(device->logicalDevice, stagingMemory);
+
+			for (uint32_t i = 0; i < mipLevels; i++)
+			{
+				ktx_size_t offset;
+				KTX_error_code result = ktxTexture_GetImageOffset(ktxTexture, i, 0, 0, &offset);
+				assert(result == KTX_SUCCESS);
+				VkBufferImageCopy bufferCopyRegion = {};
+				bufferCopyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+				bufferCopyRegion.imageSubresource.mipLevel = i;
+				bufferCopyRegion.imageSubresource.baseArrayLayer = 0;
+				bufferCopyRegion.imageSubresource.layerCount = 1;
+				bufferCopyRegion.imageExtent.width = std::max(1u, ktxTexture->baseWidth >> i);
+				bufferCopyRegion.imageExtent.height = std::max(1u, ktxTexture->baseHeight >> i);
+				bufferCopyRegion.imageExtent.depth = 1;
+				bufferCopyRegion.bufferOffset = offset;
+				bufferCopyRegions.push_back(bufferCopyRegion);
+			}
 		}
 
 		// Create optimal tiled target image
@@ -371,13 +402,14 @@ void vkglTF::Texture::fromglTfImage(tinygltf::Image &gltfimage, std::string path
 		imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 		imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 		imageCreateInfo.extent = { width, height, 1 };
-		imageCreateInfo.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+		imageCreateInfo.usage = VK_IMAGE_USAGE_SAMPLED_BIT | (hostImageCopy ? VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT : VK_IMAGE_USAGE_TRANSFER_DST_BIT);
 		VK_CHECK_RESULT(vkCreateImage(device->logicalDevice, &imageCreateInfo, nullptr, &image));
 
 		vkGetImageMemoryRequirements(device->logicalDevice, image, &memReqs);
 		memAllocInfo.allocationSize = memReqs.size;
 		memAllocInfo.memoryTypeIndex = device->getMemoryType(memReqs.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 		VK_CHECK_RESULT(vkAllocateMemory(device->logicalDevice, &memAllocInfo, nullptr, &deviceMemory));
+		memorySize = memAllocInfo.allocationSize;
 		VK_CHECK_RESULT(vkBindImageMemory(device->logicalDevice, image, deviceMemory, 0));
 
 		VkImageSubresourceRange subresourceRange = {};
@@ -386,15 +418,22 @@ void vkglTF::Texture::fromglTfImage(tinygltf::Image &gltfimage, std::string path
 		subresourceRange.levelCount = mipLevels;
 		subresourceRange.layerCount = 1;
 
-		vks::tools::setImageLayout(copyCmd, image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, subresourceRange);
-		vkCmdCopyBufferToImage(copyCmd, stagingBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(bufferCopyRegions.size()), bufferCopyRegions.data());
-		vks::tools::setImageLayout(copyCmd, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, subresourceRange);
-		device->flushCommandBuffer(copyCmd, copyQueue);
+		if (hostImageCopy) {
+			vks::copyKTXFromHost(device, image, ktxTexture, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+		}
+		else {
+			std::lock_guard<std::mutex> lock(device->transferMutex);
+			VkCommandBuffer copyCmd = device->createCommandBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
+			vks::tools::setImageLayout(copyCmd, image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, subresourceRange);
+			vkCmdCopyBufferToImage(copyCmd, stagingBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(bufferCopyRegions.size()), bufferCopyRegions.data());
+			vks::tools::setImageLayout(copyCmd, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, subresourceRange);
+			device->flushCommandBuffer(copyCmd, copyQueue);
+
+			vkDestroyBuffer(device->logicalDevice, stagingBuffer, nullptr);
+			vkFreeMemory(device->logicalDevice, stagingMemory, nullptr);
+		}
 		this->imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
-		vkDestroyBuffer(device->logicalDevice, stagingBuffer, nullptr);
-		vkFreeMemory(device->logicalDevice, stagingMemory, nullptr);
-
 		ktxTexture_Destroy(ktxTexture);
 	}
 
@@ -989,11 +1028,32 @@ void vkglTF::Model::loadSkins(tinygltf::Model &gltfModel)
 
 void vkglTF::Model::loadImages(tinygltf::Model &gltfModel, vks::VulkanDevice *device, VkQueue transferQueue)
 {
-	for (tinygltf::Image &image : gltfModel.images) {
-		vkglTF::Texture texture;
-		texture.fromglTfImage(image, path, device, transferQueue);
-		texture.index = static_cast<uint32_t>(textures.size());
-		textures.push_back(texture);
+	textures.resize(gltfModel.images.size());
+	auto loadImage = [&](size_t index) {
+		textures[index].fromglTfImage(gltfModel.images[index], path, device, transferQueue, compressedTextureFormat);
+		textures[index].index = static_cast<uint32_t>(index);
+	};
+	// With host image copies, images are uploaded without a queue, so they can be decoded and uploaded on multiple threads
+	// Images that still require a staging upload are serialized by the device's transfer mutex
+	const uint32_t threadCount = std::min(static_cast<uint32_t>(textures.size()), std::max(std::thread::hardware_concurrency(), 1u));
+	if (device->hostImageCopySupported && device->useHostImageCopy && threadCount > 1) {
+		std::atomic<size_t> nextImage{ 0 };
+		std::vector<std::thread> threads;
+		for (uint32_t i = 0; i < threadCount; i++) {
+			threads.emplace_back([&]() {
+				for (size_t index = nextImage++; index < textures.size(); index = nextImage++) {
+					loadImage(index);
+				}
+			});
+		}
+		for (std::thread &thread : threads) {
+			thread.join();
+		}
+	}
+	else {
+		for (size_t i = 0; i < textures.size(); i++) {
+			loadImage(i);
+		}
 	}
 	// Create an empty texture to be used for empty material images
 	createEmptyTexture(transferQueue);
@@ -1167,10 +1227,13 @@ void vkglTF::Model::loadFromFile(std::string filename, vks::VulkanDevice *device
 {
 	tinygltf::Model gltfModel;
 	tinygltf::TinyGLTF gltfContext;
+	// Cooked textures are only used if the device has block compression enabled
+	compressedTextureFormat = vks::getCompressedTextureFormat(device);
+	ImageLoaderContext imageLoaderContext{ filename.substr(0, filename.find_last_of('/')), compressedTextureFormat };
 	if (fileLoadingFlags & FileLoadingFlags::DontLoadImages) {
 		gltfContext.SetImageLoader(loadImageDataFuncEmpty, nullptr);
 	} else {
-		gltfContext.SetImageLoader(loadImageDataFunc, nullptr);
+		gltfContext.SetImageLoader(loadImageDataFunc, &imageLoaderContext);
 	}
 #if defined(__ANDROID__)
 	// On Android all assets are packed with the apk in a compressed form, so we need to open them using the asset manager
@@ -22,6 +22,7 @@
 
 #include "vulkan/vulkan.h"
 #include "VulkanDevice.h"
+#include "VulkanTexture.h"
 
 #include <ktx.h>
 #include <ktxvulkan.h>
@@ -71,9 +72,13 @@ namespace vkglTF
 		VkDescriptorImageInfo descriptor;
 		VkSampler sampler;
 		uint32_t index;
+		// Size of the device memory allocated for the image
+		VkDeviceSize memorySize = 0;
+		// True if the texture was loaded from an offline cooked block compressed variant
+		bool cooked = false;
 		void updateDescriptor();
 		void destroy();
-		void fromglTfImage(tinygltf::Image& gltfimage, std::string path, vks::VulkanDevice* device, VkQueue copyQueue);
+		void fromglTfImage(tinygltf::Image& gltfimage, std::string path, vks::VulkanDevice* device, VkQueue copyQueue, const vks::CompressedTextureFormat& compressedFormat = vks::CompressedTextureFormat());
 	};
 
 	/*
@@ -280,6 +285,8 @@ namespace vkglTF
 		std::vector<Skin*> skins;
 
 		std::vector<Texture> textures;
+		// Block compressed format used for offline cooked texture variants (undefined if none is supported)
+		vks::CompressedTextureFormat compressedTextureFormat;
 		std::vector<Material> materials;
 		std::vector<Animation> animations;
 
@@ -75,6 +75,15 @@ VkResult VulkanExampleBase::createInstance()
 	}
 #endif
 
+	// Optional device features like host image copies can only be checked and enabled with VK_KHR_get_physical_device_properties2 on Vulkan 1.0
+	if ((apiVersion < VK_API_VERSION_1_1) && (std::find(supportedInstanceExtensions.begin(), supportedInstanceExtensions.end(), VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME) != supportedInstanceExtensions.end()))
+	{
+		if (std::find_if(enabledInstanceExtensions.begin(), enabledInstanceExtensions.end(), [](const char* extension) { return strcmp(extension, VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME) == 0; }) == enabledInstanceExtensions.end())
+		{
+			enabledInstanceExtensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+		}
+	}
+
 	// Enabled requested instance extensions
 	if (enabledInstanceExtensions.size() > 0)
 	{
@@ -214,7 +223,8 @@ void VulkanExampleBase::prepare()
 	setupRenderPass();
 	createPipelineCache();
 	setupFrameBuffer();
-	settings.overlay = settings.overlay && (!benchmark.active);
+	// The overlay shows timings that differ between runs, which is not wanted for benchmarks and frames rendered without a window
+	settings.overlay = settings.overlay && (!benchmark.active) && (!settings.headless);
 	if (settings.overlay) {
 		ui.device = vulkanDevice;
 		ui.queue = queue;
@@ -223,7 +233,17 @@ void VulkanExampleBase::prepare()
 			loadShader(getShadersPath() + "base/uioverlay.frag.spv", VK_SHADER_STAGE_FRAGMENT_BIT),
 		};
 		ui.prepareResources();
-		ui.preparePipeline(pipelineCache, renderPass, swapChain.colorFormat, depthFormat);
+		ui.preparePipeline(pipelineCache, swapChain.colorFormat);
+		ui.prepareFrames(cmdPool, swapChain.imageViews, width, height);
+	}
+	// Frames were explicitly requested, so a run that can't store them must not exit as if it succeeded
+	if (!frameCapture.outputPath.empty()) {
+		if (!(swapChain.imageUsage & VK_IMAGE_USAGE_TRANSFER_SRC_BIT)) {
+			vks::tools::exitFatal("Swap chain images can't be copied from on this surface, frames can't be stored", VK_ERROR_FORMAT_NOT_SUPPORTED);
+		}
+		if (!frameCapture.prepare(vulkanDevice, queue, swapChain.colorFormat, width, height)) {
+			vks::tools::exitFatal("Frames can't be stored for the swap chain color format " + std::to_string(swapChain.colorFormat), VK_ERROR_FORMAT_NOT_SUPPORTED);
+		}
 	}
 }
 
@@ -260,7 +280,7 @@ void VulkanExampleBase::nextFrame()
 #else
 	auto tDiff = std::chrono::duration<double, std::milli>(tEnd - tStart).count();
 #endif
-	frameTimer = (float)tDiff / 1000.0f;
+	frameTimer = settings.headless ? headless.frameTime : (float)tDiff / 1000.0f;
 	camera.update(frameTimer);
 	if (camera.moving())
 	{
@@ -280,7 +300,7 @@ void VulkanExampleBase::nextFrame()
 	{
 		lastFPS = static_cast<uint32_t>((float)frameCounter * (1000.0f / fpsTimer));
 #if defined(_WIN32)
-		if (!settings.overlay)	{
+		if ((!settings.overlay) && (!settings.headless)) {
 			std::string windowTitle = getWindowTitle();
 			SetWindowText(window, windowTitle.c_str());
 		}
@@ -300,20 +320,22 @@ void VulkanExampleBase::renderLoop()
 #if !(defined(VK_USE_PLATFORM_IOS_MVK) || defined(VK_USE_PLATFORM_MACOS_MVK) || defined(VK_USE_PLATFORM_METAL_EXT))
 	if (benchmark.active) {
 #if defined(VK_USE_PLATFORM_WAYLAND_KHR)
-		while (!configured)
-		{
-			if (wl_display_dispatch(display) == -1)
-				break;
-		}
-		while (wl_display_prepare_read(display) != 0)
-		{
+		if (!settings.headless) {
+			while (!configured)
+			{
+				if (wl_display_dispatch(display) == -1)
+					break;
+			}
+			while (wl_display_prepare_read(display) != 0)
+			{
+				if (wl_display_dispatch_pending(display) == -1)
+					break;
+			}
+			wl_display_flush(display);
+			wl_display_read_events(display);
 			if (wl_display_dispatch_pending(display) == -1)
-				break;
+				return;
 		}
-		wl_display_flush(display);
-		wl_display_read_events(display);
-		if (wl_display_dispatch_pending(display) == -1)
-			return;
 #endif
 
 		benchmark.run([=] { render(); }, vulkanDevice->properties);
@@ -323,6 +345,16 @@ void VulkanExampleBase::renderLoop()
 		}
 		return;
 	}
+	if (settings.headless) {
+		// There are no window events to handle, so frames are rendered back to back
+		lastTimestamp = std::chrono::high_resolution_clock::now();
+		tPrevEnd = lastTimestamp;
+		for (uint32_t i = 0; i < headless.frameCount; i++) {
+			nextFrame();
+		}
+		vkDeviceWaitIdle(device);
+		return;
+	}
 #endif
 
 	destWidth = width;
@@ -725,8 +757,10 @@ void VulkanExampleBase::updateOverlay()
 	ImGui::End();
 	ImGui::PopStyleVar();
 	ImGui::Render();
+	ui.update();
 
-	if (ui.update() || ui.updated) {
+	// The overlay is recorded separately, but widgets may have changed settings the example records into its command buffers
+	if (ui.updated) {
 		buildCommandBuffers();
 		ui.updated = false;
 	}
@@ -738,18 +772,6 @@ void VulkanExampleBase::updateOverlay()
 #endif
 }
 
-void VulkanExampleBase::drawUI(const VkCommandBuffer commandBuffer)
-{
-	if (settings.overlay && ui.visible) {
-		const VkViewport viewport = vks::initializers::viewport((float)width, (float)height, 0.0f, 1.0f);
-		const VkRect2D scissor = vks::initializers::rect2D(width, height, 0, 0);
-		vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
-		vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
-
-		ui.draw(commandBuffer);
-	}
-}
-
 void VulkanExampleBase::prepareFrame()
 {
 	// Acquire the next image from the swap chain
@@ -759,17 +781,44 @@ void VulkanExampleBase::prepareFrame()
 	if ((result == VK_ERROR_OUT_OF_DATE_KHR) || (result == VK_SUBOPTIMAL_KHR)) {
 		if (result == VK_ERROR_OUT_OF_DATE_KHR) {
 			windowResize();
+			// No image has been acquired, and the swap chain may now have a different number of images than the uniform allocator had regions
+			return;
 		}
-		return;
 	}
 	else {
 		VK_CHECK_RESULT(result);
 	}
+	if (uniformAllocator.created()) {
+		// The previous frame has finished executing (see submitFrame), so the region of the command buffer for this image can be reused
+		uniformAllocator.beginFrame(currentBuffer);
+	}
 }
 
 void VulkanExampleBase::submitFrame()
 {
-	VkResult result = swapChain.queuePresent(queue, currentBuffer, semaphores.renderComplete);
+	VkSemaphore waitSemaphore = semaphores.renderComplete;
+	if (settings.overlay) {
+		// The overlay is drawn on top of the image the example rendered to in its own submission
+		VkCommandBuffer overlayCommandBuffer = ui.getCommandBuffer(currentBuffer);
+		if (overlayCommandBuffer != VK_NULL_HANDLE) {
+			const VkPipelineStageFlags waitStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+			VkSubmitInfo overlaySubmitInfo = vks::initializers::submitInfo();
+			overlaySubmitInfo.waitSemaphoreCount = 1;
+			overlaySubmitInfo.pWaitSemaphores = &semaphores.renderComplete;
+			overlaySubmitInfo.pWaitDstStageMask = &waitStageMask;
+			overlaySubmitInfo.commandBufferCount = 1;
+			overlaySubmitInfo.pCommandBuffers = &overlayCommandBuffer;
+			overlaySubmitInfo.signalSemaphoreCount = 1;
+			overlaySubmitInfo.pSignalSemaphores = &semaphores.overlayComplete;
+			VK_CHECK_RESULT(vkQueueSubmit(queue, 1, &overlaySubmitInfo, VK_NULL_HANDLE));
+			waitSemaphore = semaphores.overlayComplete;
+		}
+	}
+	if (frameCapture.active()) {
+		// The copy is submitted between rendering and presentation, its results are written out once it has finished in a later frame
+		waitSemaphore = frameCapture.capture(swapChain.images[currentBuffer], waitSemaphore);
+	}
+	VkResult result = swapChain.queuePresent(queue, currentBuffer, waitSemaphore);
 	// Recreate the swapchain if it's no longer compatible with the surface (OUT_OF_DATE) or no longer optimal for presentation (SUBOPTIMAL)
 	if ((result == VK_ERROR_OUT_OF_DATE_KHR) || (result == VK_SUBOPTIMAL_KHR)) {
 		windowResize();
@@ -801,6 +850,14 @@ VulkanExampleBase::VulkanExampleBase()
 	commandLineParser.add("benchmarkresultfile", { "-bf", "--benchfilename" }, 1, "Set file name for benchmark results");
 	commandLineParser.add("benchmarkresultframes", { "-bt", "--benchframetimes" }, 0, "Save frame times to benchmark results file");
 	commandLineParser.add("benchmarkframes", { "-bfs", "--benchmarkframes" }, 1, "Only render the given number of frames");
+	commandLineParser.add("nohostimagecopy", { "-nhic", "--nohostimagecopy" }, 0, "Upload textures through staging buffers even if host image copies are supported");
+#if !(defined(VK_USE_PLATFORM_ANDROID_KHR) || defined(VK_USE_PLATFORM_IOS_MVK) || defined(VK_USE_PLATFORM_MACOS_MVK) || defined(VK_USE_PLATFORM_METAL_EXT))
+	commandLineParser.add("headless", { "--headless" }, 0, "Render into offscreen images without a window");
+	commandLineParser.add("headlessframes", { "-hf", "--headlessframes" }, 1, "Number of frames to render without a window (defaults to 1)");
+	commandLineParser.add("frametime", { "-ft", "--frametime" }, 1, "Time step in seconds between frames rendered without a window (defaults to 1/60)");
+	commandLineParser.add("dumpframes", { "-df", "--dumpframes" }, 1, "Store all rendered frames in the given directory");
+	commandLineParser.add("dumpformat", { "-dfm", "--dumpformat" }, 1, "File format for stored frames (ppm, png, exr or y4m)");
+#endif
 #if (!(defined(VK_USE_PLATFORM_IOS_MVK) || defined(VK_USE_PLATFORM_MACOS_MVK) || defined(VK_USE_PLATFORM_METAL_EXT)))
 	commandLineParser.add("resourcepath", { "-rp", "--resourcepath" }, 1, "Set path for dir where assets and shaders folder is present");
 #endif
@@ -856,6 +913,38 @@ VulkanExampleBase::VulkanExampleBase()
 	if (commandLineParser.isSet("benchmarkframes")) {
 		benchmark.outputFrames = commandLineParser.getValueAsInt("benchmarkframes", benchmark.outputFrames);
 	}
+	if (commandLineParser.isSet("nohostimagecopy")) {
+		settings.hostImageCopy = false;
+	}
+#if !(defined(VK_USE_PLATFORM_ANDROID_KHR) || defined(VK_USE_PLATFORM_IOS_MVK) || defined(VK_USE_PLATFORM_MACOS_MVK) || defined(VK_USE_PLATFORM_METAL_EXT))
+	if (commandLineParser.isSet("headless")) {
+		settings.headless = true;
+		// Errors are not shown in message boxes, as there may be nobody to close them
+		vks::tools::errorModeSilent = true;
+	}
+	if (commandLineParser.isSet("headlessframes")) {
+		headless.frameCount = commandLineParser.getValueAsInt("headlessframes", headless.frameCount);
+	}
+	if (commandLineParser.isSet("dumpframes")) {
+		frameCapture.outputPath = commandLineParser.getValueAsString("dumpframes", "");
+		std::error_code errorCode;
+		std::filesystem::create_directories(frameCapture.outputPath, errorCode);
+	}
+	if (commandLineParser.isSet("frametime")) {
+		headless.frameTime = commandLineParser.getValueAsFloat("frametime", headless.frameTime);
+	}
+	if (settings.headless) {
+		// Set before preparing and rendering the first frame, so that frame advances by the fixed step too (later frames get it from nextFrame)
+		frameTimer = headless.frameTime;
+	}
+	if (commandLineParser.isSet("dumpformat")) {
+		if (!vks::FrameCapture::parseFormat(commandLineParser.getValueAsString("dumpformat", "ppm"), frameCapture.format)) {
+			std::cerr << "Unknown frame dump format, using ppm\n";
+		}
+	}
+#endif
+	// Random seeds and timers are fixed, so benchmark runs are comparable and headless runs can be compared against reference images
+	settings.deterministic = benchmark.active || settings.headless;
 #if (!(defined(VK_USE_PLATFORM_IOS_MVK) || defined(VK_USE_PLATFORM_MACOS_MVK) || defined(VK_USE_PLATFORM_METAL_EXT)))
 	if(commandLineParser.isSet("resourcepath")) {
 		vks::tools::resourcePath = commandLineParser.getValueAsString("resourcepath", "");
@@ -889,9 +978,13 @@ VulkanExampleBase::VulkanExampleBase()
 #elif defined(_DIRECT2DISPLAY)
 
 #elif defined(VK_USE_PLATFORM_WAYLAND_KHR)
-	initWaylandConnection();
+	if (!settings.headless) {
+		initWaylandConnection();
+	}
 #elif defined(VK_USE_PLATFORM_XCB_KHR)
-	initxcbConnection();
+	if (!settings.headless) {
+		initxcbConnection();
+	}
 #endif
 
 #if defined(_WIN32)
@@ -907,6 +1000,8 @@ VulkanExampleBase::VulkanExampleBase()
 VulkanExampleBase::~VulkanExampleBase()
 {
 	// Clean up Vulkan resources
+	frameCapture.destroy();
+	uniformAllocator.destroy();
 	swapChain.cleanup();
 	if (descriptorPool != VK_NULL_HANDLE)
 	{
@@ -932,18 +1027,19 @@ VulkanExampleBase::~VulkanExampleBase()
 
 	vkDestroyPipelineCache(device, pipelineCache, nullptr);
 
+	if (settings.overlay) {
+		ui.freeResources();
+	}
+
 	vkDestroyCommandPool(device, cmdPool, nullptr);
 
 	vkDestroySemaphore(device, semaphores.presentComplete, nullptr);
 	vkDestroySemaphore(device, semaphores.renderComplete, nullptr);
+	vkDestroySemaphore(device, semaphores.overlayComplete, nullptr);
 	for (auto& fence : waitFences) {
 		vkDestroyFence(device, fence, nullptr);
 	}
 
-	if (settings.overlay) {
-		ui.freeResources();
-	}
-
 	delete vulkanDevice;
 
 	if (settings.validation)
@@ -967,22 +1063,26 @@ VulkanExampleBase::~VulkanExampleBase()
 	if (dfb)
 		dfb->Release(dfb);
 #elif defined(VK_USE_PLATFORM_WAYLAND_KHR)
-	xdg_toplevel_destroy(xdg_toplevel);
-	xdg_surface_destroy(xdg_surface);
-	wl_surface_destroy(surface);
-	if (keyboard)
-		wl_keyboard_destroy(keyboard);
-	if (pointer)
-		wl_pointer_destroy(pointer);
-	if (seat)
-		wl_seat_destroy(seat);
-	xdg_wm_base_destroy(shell);
-	wl_compositor_destroy(compositor);
-	wl_registry_destroy(registry);
-	wl_display_disconnect(display);
+	if (!settings.headless) {
+		xdg_toplevel_destroy(xdg_toplevel);
+		xdg_surface_destroy(xdg_surface);
+		wl_surface_destroy(surface);
+		if (keyboard)
+			wl_keyboard_destroy(keyboard);
+		if (pointer)
+			wl_pointer_destroy(pointer);
+		if (seat)
+			wl_seat_destroy(seat);
+		xdg_wm_base_destroy(shell);
+		wl_compositor_destroy(compositor);
+		wl_registry_destroy(registry);
+		wl_display_disconnect(display);
+	}
 #elif defined(VK_USE_PLATFORM_XCB_KHR)
-	xcb_destroy_window(connection, window);
-	xcb_disconnect(connection);
+	if (!settings.headless) {
+		xcb_destroy_window(connection, window);
+		xcb_disconnect(connection);
+	}
 #elif defined(VK_USE_PLATFORM_SCREEN_QNX)
 	screen_destroy_event(screen_event);
 	screen_destroy_window(screen_window);
@@ -1076,6 +1176,13 @@ bool VulkanExampleBase::initVulkan()
 	// Derived examples can enable extensions based on the list of supported extensions read from the physical device
 	getEnabledExtensions();
 
+	// Texture loaders upload without staging buffers if the device supports host image copies
+	const bool physicalDeviceProperties2 = (apiVersion >= VK_API_VERSION_1_1) || (std::find_if(enabledInstanceExtensions.begin(), enabledInstanceExtensions.end(), [](const char* extension) { return strcmp(extension, VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME) == 0; }) != enabledInstanceExtensions.end());
+	if (physicalDeviceProperties2) {
+		vulkanDevice->enableHostImageCopy(instance, enabledDeviceExtensions, deviceCreatepNextChain);
+	}
+	vulkanDevice->useHostImageCopy = settings.hostImageCopy;
+
 	result = vulkanDevice->createLogicalDevice(enabledFeatures, enabledDeviceExtensions, deviceCreatepNextChain);
 	if (result != VK_SUCCESS) {
 		vks::tools::exitFatal("Could not create Vulkan device: \n" + vks::tools::errorString(result), result);
@@ -1106,6 +1213,8 @@ bool VulkanExampleBase::initVulkan()
 	// Create a semaphore used to synchronize command submission
 	// Ensures that the image is not presented until all commands have been submitted and executed
 	VK_CHECK_RESULT(vkCreateSemaphore(device, &semaphoreCreateInfo, nullptr, &semaphores.renderComplete));
+	// Create a semaphore used to synchronize the UI overlay submission with presentation
+	VK_CHECK_RESULT(vkCreateSemaphore(device, &semaphoreCreateInfo, nullptr, &semaphores.overlayComplete));
 
 	// Set up submit info structure
 	// Semaphores will stay the same during application lifetime
@@ -1161,6 +1270,9 @@ void VulkanExampleBase::setupDPIAwareness()
 HWND VulkanExampleBase::setupWindow(HINSTANCE hinstance, WNDPROC wndproc)
 {
 	this->windowInstance = hinstance;
+	if (settings.headless) {
+		return nullptr;
+	}
 
 	WNDCLASSEX wndClass{};
 
@@ -1294,7 +1406,6 @@ void VulkanExampleBase::handleMessages(HWND hWnd, UINT uMsg, WPARAM wParam, LPAR
 			break;
 		case KEY_F1:
 			ui.visible = !ui.visible;
-			ui.updated = true;
 			break;
 		case KEY_F2:
 			if (camera.type == Camera::CameraType::lookat) {
@@ -1534,7 +1645,6 @@ int32_t VulkanExampleBase::handleAppInput(struct android_app* app, AInputEvent*
 		case AKEYCODE_F1:
 		case AKEYCODE_BUTTON_L1:
 			vulkanExample->ui.visible = !vulkanExample->ui.visible;
-			vulkanExample->ui.updated = true;
 			break;
 		case AKEYCODE_BUTTON_R1:
 			vulkanExample->keyPressed(GAMEPAD_BUTTON_R1);
@@ -1738,7 +1848,6 @@ static CVReturn displayLinkOutputCallback(CVDisplayLinkRef displayLink, const CV
 		case KEY_1:										// support keyboards with no function keys
 		case KEY_F1:
 			vulkanExample->ui.visible = !vulkanExample->ui.visible;
-			vulkanExample->ui.updated = true;
 			break;
 		case KEY_DELETE:								// support keyboards with no escape key
 		case KEY_ESCAPE:
@@ -2134,7 +2243,6 @@ void VulkanExampleBase::handleEvent(const DFBWindowEvent *event)
 				break;
 			case KEY_F1:
 				ui.visible = !ui.visible;
-				ui.updated = true;
 				break;
 			default:
 				break;
@@ -2309,7 +2417,6 @@ void VulkanExampleBase::keyboardKey(struct wl_keyboard *keyboard,
 	case KEY_F1:
 		if (state) {
 			ui.visible = !ui.visible;
-			ui.updated = true;
 		}
 		break;
 	case KEY_ESCAPE:
@@ -2486,6 +2593,9 @@ static const struct xdg_toplevel_listener xdg_toplevel_listener = {
 
 struct xdg_surface *VulkanExampleBase::setupWindow()
 {
+	if (settings.headless) {
+		return nullptr;
+	}
 	surface = wl_compositor_create_surface(compositor);
 	xdg_surface = xdg_wm_base_get_xdg_surface(shell, surface);
 
@@ -2516,6 +2626,10 @@ static inline xcb_intern_atom_reply_t* intern_atom_helper(xcb_connection_t *conn
 // Set up a window using XCB and request event types
 xcb_window_t VulkanExampleBase::setupWindow()
 {
+	if (settings.headless) {
+		return 0;
+	}
+
 	uint32_t value_mask, value_list[32];
 
 	window = xcb_generate_id(connection);
@@ -2677,7 +2791,6 @@ void VulkanExampleBase::handleEvent(const xcb_generic_event_t *event)
 				break;
 			case KEY_F1:
 				ui.visible = !ui.visible;
-				ui.updated = true;
 				break;
 		}
 	}
@@ -2803,7 +2916,6 @@ void VulkanExampleBase::handleEvent()
 							break;
 						case KEYCODE_F1:
 							ui.visible = !ui.visible;
-							ui.updated = true;
 							break;
 						default:
 							break;
@@ -3191,6 +3303,7 @@ void VulkanExampleBase::windowResize()
 	width = destWidth;
 	height = destHeight;
 	createSwapChain();
+	frameCapture.resize(width, height);
 
 	// Recreate the frame buffers
 	vkDestroyImageView(device, depthStencil.view, nullptr);
@@ -3205,6 +3318,7 @@ void VulkanExampleBase::windowResize()
 	if ((width > 0.0f) && (height > 0.0f)) {
 		if (settings.overlay) {
 			ui.resize(width, height);
+			ui.prepareFrames(cmdPool, swapChain.imageViews, width, height);
 		}
 	}
 
@@ -3269,6 +3383,10 @@ void VulkanExampleBase::windowResized() {}
 
 void VulkanExampleBase::createSurface()
 {
+	if (settings.headless) {
+		swapChain.initHeadless(queue, vulkanDevice->queueFamilyIndices.graphics);
+		return;
+	}
 #if defined(_WIN32)
 	swapChain.initSurface(windowInstance, window);
 #elif defined(VK_USE_PLATFORM_ANDROID_KHR)
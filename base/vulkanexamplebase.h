@@ -45,6 +45,8 @@
 #include <random>
 #include <algorithm>
 #include <sys/stat.h>
+#include <fstream>
+#include <filesystem>
 
 #define GLM_FORCE_RADIANS
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
@@ -65,6 +67,8 @@
 #include "VulkanDebug.h"
 #include "VulkanUIOverlay.h"
 #include "VulkanSwapChain.h"
+#include "VulkanFrameCapture.h"
+#include "VulkanUniformAllocator.h"
 #include "VulkanBuffer.h"
 #include "VulkanDevice.h"
 #include "VulkanTexture.h"
@@ -153,6 +157,8 @@ protected:
 		VkSemaphore presentComplete;
 		// Command buffer submission and execution
 		VkSemaphore renderComplete;
+		// UI overlay drawn on top of the example's output
+		VkSemaphore overlayComplete;
 	} semaphores;
 	std::vector<VkFence> waitFences;
 	bool requiresStencil{ false };
@@ -184,8 +190,32 @@ public:
 		bool vsync = false;
 		/** @brief Enable UI overlay */
 		bool overlay = true;
+		/** @brief Render into a ring of offscreen images instead of a window, set via command line */
+		bool headless = false;
+		/** @brief Use fixed random seeds so runs produce the same images, set for benchmarks and headless runs (which also advance time in fixed steps) */
+		bool deterministic = false;
+		/** @brief Upload textures with host image copies if supported by the device, can be disabled via command line to compare against staging uploads */
+		bool hostImageCopy = true;
 	} settings;
 
+	/** @brief Options for running without a window */
+	struct {
+		/** @brief Number of frames to render before exiting (ignored in benchmark mode) */
+		uint32_t frameCount{ 1 };
+		/** @brief Time step in seconds frames advance timers and cameras by, so the rendered frames don't depend on how fast the device is */
+		float frameTime{ 1.0f / 60.0f };
+	} headless;
+
+	/** @brief Stores presented frames to disk if an output directory has been set via command line */
+	vks::FrameCapture frameCapture;
+
+	/**
+	* @brief Transient per frame uniform data, created by examples that use it with one frame per command buffer (drawCmdBuffers)
+	* @note The region of the acquired swap chain image's command buffer is selected in prepareFrame, so uniform data has to be written after that
+	* @note A swap chain recreation can change the number of command buffers, examples recreate the allocator in buildCommandBuffers if it no longer matches
+	*/
+	vks::UniformAllocator uniformAllocator;
+
 	/** @brief State of gamepad input (only used on Android) */
 	struct {
 		glm::vec2 axisLeft = glm::vec2(0.0f);
@@ -398,12 +428,9 @@ public:
 	/** @brief Entry point for the main render loop */
 	void renderLoop();
 
-	/** @brief Adds the drawing commands for the ImGui overlay to the given command buffer */
-	void drawUI(const VkCommandBuffer commandBuffer);
-
 	/** Prepare the next frame for workload submission by acquiring the next swap chain image */
 	void prepareFrame();
-	/** @brief Presents the current image to the swap chain */
+	/** @brief Submits the UI overlay and presents the current image to the swap chain */
 	void submitFrame();
 	/** @brief (Virtual) Default image acquire + submission and command buffer submission function */
 	virtual void renderFrame();
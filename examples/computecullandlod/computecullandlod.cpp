@@ -205,8 +205,6 @@ public:
 				}
 			}
 
-			drawUI(drawCmdBuffers[i]);
-
 			vkCmdEndRenderPass(drawCmdBuffers[i]);
 
 			// Release barrier
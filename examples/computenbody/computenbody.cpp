@@ -186,8 +186,6 @@ public:
 			vkCmdBindVertexBuffers(drawCmdBuffers[i], 0, 1, &storageBuffer.buffer, offsets);
 			vkCmdDraw(drawCmdBuffers[i], numParticles, 1, 0, 0);
 
-			drawUI(drawCmdBuffers[i]);
-
 			vkCmdEndRenderPass(drawCmdBuffers[i]);
 
 			// Release barrier
@@ -330,7 +328,7 @@ public:
 		// Initial particle positions
 		std::vector<Particle> particleBuffer(numParticles);
 
-		std::default_random_engine rndEngine(benchmark.active ? 0 : (unsigned)time(nullptr));
+		std::default_random_engine rndEngine(settings.deterministic ? 0 : (unsigned)time(nullptr));
 		std::normal_distribution<float> rndDist(0.0f, 1.0f);
 
 		for (uint32_t i = 0; i < static_cast<uint32_t>(attractors.size()); i++)
@@ -550,10 +550,6 @@ public:
 					cmdEndLabel(drawCmdBuffers[i]);
 				}
 
-				cmdBeginLabel(drawCmdBuffers[i], "UI overlay", { 0.23f, 0.65f, 0.28f, 1.0f });
-				drawUI(drawCmdBuffers[i]);
-				cmdEndLabel(drawCmdBuffers[i]);
-
 				vkCmdEndRenderPass(drawCmdBuffers[i]);
 
 				cmdEndLabel(drawCmdBuffers[i]);
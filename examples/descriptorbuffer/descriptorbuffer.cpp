@@ -1,66 +1,79 @@
 /*
  * Vulkan Example - Using descriptor buffers via VK_EXT_descriptor_buffer
  *
- * Copyright (C) 2022-2024 by Sascha Willems - www.saschawillems.de
+ * Descriptors are written into descriptor buffers with vks::DescriptorBuffer (see base/VulkanDescriptorBuffer.h)
+ * The number of cubes can be raised from the UI to get a high draw count scene, where each cube has its own uniform buffer range and image descriptor
+ * For comparison the same scene can be rendered using descriptor sets, and the CPU time for writing the descriptors and recording the command buffers is displayed
+ *
+ * Copyright (C) 2022-2025 by Sascha Willems - www.saschawillems.de
  *
  * This code is licensed under the MIT license (MIT) (http://opensource.org/licenses/MIT)
  */
 
 #include "vulkanexamplebase.h"
 #include "VulkanglTFModel.h"
-
+#include "VulkanDescriptorBuffer.h"
+#include <thread>
 
 class VulkanExample : public VulkanExampleBase
 {
 public:
 	bool animate = true;
+	bool useDescriptorBuffers = true;
 
 	struct Cube {
 		glm::mat4 matrix;
-		vks::Texture2D texture;
-		vks::Buffer uniformBuffer;
 		glm::vec3 rotation;
+		glm::vec3 position;
+		uint32_t textureIndex;
+		// Sets in the descriptor buffers
+		uint32_t uniformSet;
+		uint32_t imageSet;
+		// Sets used when rendering with descriptor sets
+		VkDescriptorSet uniformDescriptorSet;
+		VkDescriptorSet imageDescriptorSet;
 	};
-	std::array<Cube, 2> cubes;
+	std::vector<Cube> cubes;
+	const std::vector<uint32_t> gridSizes = { 0, 32, 64 };
+	const std::vector<std::string> gridNames = { "2 cubes", "32 x 32 cubes", "64 x 64 cubes" };
+	int32_t gridIndex = 0;
+
+	std::array<vks::Texture2D, 2> textures;
 
+	// Camera matrices and the matrices of all cubes, each cube's matrix is aligned to the uniform buffer offset alignment
 	vks::Buffer uniformBufferCamera;
+	vks::Buffer uniformBufferCubes;
+	VkDeviceSize cubeUniformStride{ 0 };
 
 	vkglTF::Model model;
 
-	VkPipeline pipeline;
-	VkPipelineLayout pipelineLayout;
-
-	PFN_vkGetBufferDeviceAddressKHR vkGetBufferDeviceAddressKHR;
+	// Descriptor buffers require pipelines and set layouts created for them, so both paths have their own
+	struct Path {
+		VkDescriptorSetLayout uniformSetLayout{ VK_NULL_HANDLE };
+		VkDescriptorSetLayout imageSetLayout{ VK_NULL_HANDLE };
+		VkPipelineLayout pipelineLayout{ VK_NULL_HANDLE };
+		VkPipeline pipeline{ VK_NULL_HANDLE };
+	};
+	Path descriptorBufferPath;
+	Path descriptorSetPath;
 
 	VkPhysicalDeviceDescriptorBufferFeaturesEXT enabledDeviceDescriptorBufferFeaturesEXT{};
 	VkPhysicalDeviceBufferDeviceAddressFeatures enabledBufferDeviceAddresFeatures{};
 	VkPhysicalDeviceDescriptorBufferPropertiesEXT descriptorBufferProperties{};
 
-	PFN_vkGetDescriptorSetLayoutSizeEXT vkGetDescriptorSetLayoutSizeEXT;
-	PFN_vkGetDescriptorSetLayoutBindingOffsetEXT vkGetDescriptorSetLayoutBindingOffsetEXT;
-	PFN_vkCmdBindDescriptorBuffersEXT vkCmdBindDescriptorBuffersEXT;
-	PFN_vkCmdSetDescriptorBufferOffsetsEXT vkCmdSetDescriptorBufferOffsetsEXT;
-	PFN_vkGetDescriptorEXT vkGetDescriptorEXT;
-	PFN_vkCmdBindDescriptorBufferEmbeddedSamplersEXT vkCmdBindDescriptorBufferEmbeddedSamplersEXT;
-
-	// Stores all values that are required to setup a descriptor buffer for a resource buffer
-	struct DescriptorInfo {
-		VkDeviceSize layoutOffset;
-		VkDeviceSize layoutSize;
-		VkDescriptorSetLayout setLayout;
-		VkDeviceOrHostAddressConstKHR bufferDeviceAddress;
-		vks::Buffer buffer;
-	};
-	DescriptorInfo uniformDescriptor{};
-	DescriptorInfo combinedImageDescriptor{};
+	// Camera and per cube uniform buffer descriptors
+	vks::DescriptorBuffer uniformDescriptorBuffer;
+	// Per cube combined image sampler descriptors
+	vks::DescriptorBuffer imageDescriptorBuffer;
+	VkDescriptorSet cameraDescriptorSet{ VK_NULL_HANDLE };
+	uint32_t cameraSet{ 0 };
 
-	uint64_t getBufferDeviceAddress(VkBuffer buffer)
-	{
-		VkBufferDeviceAddressInfoKHR bufferDeviceAI{};
-		bufferDeviceAI.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
-		bufferDeviceAI.buffer = buffer;
-		return vkGetBufferDeviceAddressKHR(vulkanDevice->logicalDevice, &bufferDeviceAI);
-	}
+	// CPU times in milliseconds
+	struct {
+		float descriptorUpdate{ 0.0f };
+		// Average per command buffer
+		float commandBufferRecording{ 0.0f };
+	} timings;
 
 	VulkanExample() : VulkanExampleBase()
 	{
@@ -73,37 +86,39 @@ public:
 		apiVersion = VK_API_VERSION_1_1;
 
 		enabledInstanceExtensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
-		
+
 		enabledDeviceExtensions.push_back(VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME);
 		enabledDeviceExtensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
 		enabledDeviceExtensions.push_back(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
 		enabledDeviceExtensions.push_back(VK_KHR_MAINTENANCE3_EXTENSION_NAME);
 
-		enabledDeviceExtensions.push_back(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME);
-
 		enabledBufferDeviceAddresFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_BUFFER_DEVICE_ADDRESS_FEATURES;
 		enabledBufferDeviceAddresFeatures.bufferDeviceAddress = VK_TRUE;
 
 		enabledDeviceDescriptorBufferFeaturesEXT.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT;
 		enabledDeviceDescriptorBufferFeaturesEXT.descriptorBuffer = VK_TRUE;
 		enabledDeviceDescriptorBufferFeaturesEXT.pNext = &enabledBufferDeviceAddresFeatures;
-		
+
 		deviceCreatepNextChain = &enabledDeviceDescriptorBufferFeaturesEXT;
 	}
 
 	~VulkanExample()
 	{
-		vkDestroyDescriptorSetLayout(device, uniformDescriptor.setLayout, nullptr);
-		vkDestroyDescriptorSetLayout(device, combinedImageDescriptor.setLayout, nullptr);
-		vkDestroyPipeline(device, pipeline, nullptr);
-		vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
-		for (auto& cube : cubes) {
-			cube.uniformBuffer.destroy();
-			cube.texture.destroy();
+		if (device) {
+			for (Path* path : { &descriptorBufferPath, &descriptorSetPath }) {
+				vkDestroyDescriptorSetLayout(device, path->uniformSetLayout, nullptr);
+				vkDestroyDescriptorSetLayout(device, path->imageSetLayout, nullptr);
+				vkDestroyPipeline(device, path->pipeline, nullptr);
+				vkDestroyPipelineLayout(device, path->pipelineLayout, nullptr);
+			}
+			for (auto& texture : textures) {
+				texture.destroy();
+			}
+			uniformBufferCamera.destroy();
+			uniformBufferCubes.destroy();
+			uniformDescriptorBuffer.destroy();
+			imageDescriptorBuffer.destroy();
 		}
-		uniformBufferCamera.destroy();
-		uniformDescriptor.buffer.destroy();
-		combinedImageDescriptor.buffer.destroy();
 	}
 
 	virtual void getEnabledFeatures()
@@ -113,46 +128,51 @@ public:
 		};
 	}
 
-	void setupDescriptors()
+	virtual void getEnabledExtensions()
 	{
-		VkDescriptorSetLayoutCreateInfo descriptorLayoutCI{};
-		descriptorLayoutCI.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-		descriptorLayoutCI.bindingCount = 1;
-		descriptorLayoutCI.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
-
-		VkDescriptorSetLayoutBinding setLayoutBinding = {};
-
-		setLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-		setLayoutBinding.binding = 0;
-		setLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
-		setLayoutBinding.descriptorCount = 1;
-
-		descriptorLayoutCI.pBindings = &setLayoutBinding;
-		VK_CHECK_RESULT(vkCreateDescriptorSetLayout(device, &descriptorLayoutCI, nullptr, &uniformDescriptor.setLayout));
+		// Checked before device creation, as the extension may be exposed without the required features
+		if (!vks::DescriptorBuffer::supported(vulkanDevice)) {
+			vks::tools::exitFatal("Selected GPU does not support descriptor buffers!", VK_ERROR_FEATURE_NOT_PRESENT);
+		}
+		enabledDeviceExtensions.push_back(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME);
+	}
 
-		setLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-		setLayoutBinding.binding = 0;
-		setLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
-		setLayoutBinding.descriptorCount = 1;
+	uint32_t getMaxCubeCount()
+	{
+		return gridSizes.back() * gridSizes.back();
+	}
 
-		descriptorLayoutCI.pBindings = &setLayoutBinding;
-		VK_CHECK_RESULT(vkCreateDescriptorSetLayout(device, &descriptorLayoutCI, nullptr, &combinedImageDescriptor.setLayout));
+	void setupDescriptorSetLayouts()
+	{
+		// The layouts are the same for both paths, except for the flag that's required to use them with descriptor buffers
+		for (Path* path : { &descriptorBufferPath, &descriptorSetPath }) {
+			VkDescriptorSetLayoutCreateInfo descriptorLayoutCI{};
+			descriptorLayoutCI.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+			descriptorLayoutCI.bindingCount = 1;
+			descriptorLayoutCI.flags = (path == &descriptorBufferPath) ? VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT : 0;
+
+			VkDescriptorSetLayoutBinding setLayoutBinding = {};
+
+			setLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+			setLayoutBinding.binding = 0;
+			setLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+			setLayoutBinding.descriptorCount = 1;
+
+			descriptorLayoutCI.pBindings = &setLayoutBinding;
+			VK_CHECK_RESULT(vkCreateDescriptorSetLayout(device, &descriptorLayoutCI, nullptr, &path->uniformSetLayout));
+
+			setLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			setLayoutBinding.binding = 0;
+			setLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+			setLayoutBinding.descriptorCount = 1;
+
+			descriptorLayoutCI.pBindings = &setLayoutBinding;
+			VK_CHECK_RESULT(vkCreateDescriptorSetLayout(device, &descriptorLayoutCI, nullptr, &path->imageSetLayout));
+		}
 	}
 
 	void preparePipelines()
 	{
-		// Set 0 = Camera UBO
-		// Set 1 = Model UBO
-		// Set 2 = Model image
-		const std::array<VkDescriptorSetLayout, 3> setLayouts = { uniformDescriptor.setLayout, uniformDescriptor.setLayout, combinedImageDescriptor.setLayout };
-
-		VkPipelineLayoutCreateInfo pipelineLayoutCI{};
-		pipelineLayoutCI.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-		// The pipeline layout is based on the descriptor set layout we created above
-		pipelineLayoutCI.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
-		pipelineLayoutCI.pSetLayouts = setLayouts.data();
-		VK_CHECK_RESULT(vkCreatePipelineLayout(device, &pipelineLayoutCI, nullptr, &pipelineLayout));
-
 		const std::vector<VkDynamicState> dynamicStateEnables = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
 
 		VkPipelineInputAssemblyStateCreateInfo inputAssemblyStateCI = vks::initializers::pipelineInputAssemblyStateCreateInfo(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, 0, VK_FALSE);
@@ -168,105 +188,116 @@ public:
 			loadShader(getShadersPath() + "descriptorbuffer/cube.frag.spv", VK_SHADER_STAGE_FRAGMENT_BIT)
 		};
 
-		VkGraphicsPipelineCreateInfo pipelineCI = vks::initializers::pipelineCreateInfo(pipelineLayout, renderPass, 0);
-		pipelineCI.pInputAssemblyState = &inputAssemblyStateCI;
-		pipelineCI.pRasterizationState = &rasterizationStateCI;
-		pipelineCI.pColorBlendState = &colorBlendStateCI;
-		pipelineCI.pMultisampleState = &multisampleStateCI;
-		pipelineCI.pViewportState = &viewportStateCI;
-		pipelineCI.pDepthStencilState = &depthStencilStateCI;
-		pipelineCI.pDynamicState = &dynamicStateCI;
-		pipelineCI.stageCount = static_cast<uint32_t>(shaderStages.size());
-		pipelineCI.pStages = shaderStages.data();
-		pipelineCI.pVertexInputState = vkglTF::Vertex::getPipelineVertexInputState({ vkglTF::VertexComponent::Position, vkglTF::VertexComponent::Normal, vkglTF::VertexComponent::UV, vkglTF::VertexComponent::Color });
-		pipelineCI.flags = VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
-		VK_CHECK_RESULT(vkCreateGraphicsPipelines(device, pipelineCache, 1, &pipelineCI, nullptr, &pipeline));
+		for (Path* path : { &descriptorBufferPath, &descriptorSetPath }) {
+			// Set 0 = Camera UBO
+			// Set 1 = Model UBO
+			// Set 2 = Model image
+			const std::array<VkDescriptorSetLayout, 3> setLayouts = { path->uniformSetLayout, path->uniformSetLayout, path->imageSetLayout };
+
+			VkPipelineLayoutCreateInfo pipelineLayoutCI{};
+			pipelineLayoutCI.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+			pipelineLayoutCI.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+			pipelineLayoutCI.pSetLayouts = setLayouts.data();
+			VK_CHECK_RESULT(vkCreatePipelineLayout(device, &pipelineLayoutCI, nullptr, &path->pipelineLayout));
+
+			VkGraphicsPipelineCreateInfo pipelineCI = vks::initializers::pipelineCreateInfo(path->pipelineLayout, renderPass, 0);
+			pipelineCI.pInputAssemblyState = &inputAssemblyStateCI;
+			pipelineCI.pRasterizationState = &rasterizationStateCI;
+			pipelineCI.pColorBlendState = &colorBlendStateCI;
+			pipelineCI.pMultisampleState = &multisampleStateCI;
+			pipelineCI.pViewportState = &viewportStateCI;
+			pipelineCI.pDepthStencilState = &depthStencilStateCI;
+			pipelineCI.pDynamicState = &dynamicStateCI;
+			pipelineCI.stageCount = static_cast<uint32_t>(shaderStages.size());
+			pipelineCI.pStages = shaderStages.data();
+			pipelineCI.pVertexInputState = vkglTF::Vertex::getPipelineVertexInputState({ vkglTF::VertexComponent::Position, vkglTF::VertexComponent::Normal, vkglTF::VertexComponent::UV, vkglTF::VertexComponent::Color });
+			pipelineCI.flags = (path == &descriptorBufferPath) ? VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT : 0;
+			VK_CHECK_RESULT(vkCreateGraphicsPipelines(device, pipelineCache, 1, &pipelineCI, nullptr, &path->pipeline));
+		}
 	}
 
-	void prepareDescriptorBuffer()
+	void prepareDescriptorBuffers()
 	{
-		// We need to get sizes and offsets for the descriptor layouts
-
-		// This is done using a new extension structures and features
-		PFN_vkGetPhysicalDeviceProperties2KHR vkGetPhysicalDeviceProperties2KHR = reinterpret_cast<PFN_vkGetPhysicalDeviceProperties2KHR>(vkGetInstanceProcAddr(instance, "vkGetPhysicalDeviceProperties2KHR"));
-		assert(vkGetPhysicalDeviceProperties2KHR);
+		// Some devices have very low limits for the no. of max descriptor buffer bindings, so we need to check
 		VkPhysicalDeviceProperties2KHR deviceProps2{};
 		descriptorBufferProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT;
 		deviceProps2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2_KHR;
 		deviceProps2.pNext = &descriptorBufferProperties;
-		vkGetPhysicalDeviceProperties2KHR(physicalDevice, &deviceProps2);
-
-		// Some devices have very low limits for the no. of max descriptor buffer bindings, so we need to check
+		vkGetPhysicalDeviceProperties2(physicalDevice, &deviceProps2);
 		if (descriptorBufferProperties.maxResourceDescriptorBufferBindings < 2) {
-			vks::tools::exitFatal("This sample requires at least 2 descriptor bindings to run, the selected device only supports " + std::to_string(descriptorBufferProperties.maxResourceDescriptorBufferBindings), - 1);
+			vks::tools::exitFatal("This sample requires at least 2 descriptor bindings to run, the selected device only supports " + std::to_string(descriptorBufferProperties.maxResourceDescriptorBufferBindings), VK_ERROR_FEATURE_NOT_PRESENT);
 		}
 
-		vkGetDescriptorSetLayoutSizeEXT(device, uniformDescriptor.setLayout, &uniformDescriptor.layoutSize);
-		vkGetDescriptorSetLayoutSizeEXT(device, combinedImageDescriptor.setLayout, &combinedImageDescriptor.layoutSize);
-
-		vkGetDescriptorSetLayoutBindingOffsetEXT(device, uniformDescriptor.setLayout, 0, &uniformDescriptor.layoutOffset);
-		vkGetDescriptorSetLayoutBindingOffsetEXT(device, combinedImageDescriptor.setLayout, 0, &combinedImageDescriptor.layoutOffset);
-
-		// In order to copy resource descriptors to the correct place, we need to calculate aligned sizes
-		uniformDescriptor.layoutSize = vks::tools::alignedVkSize(uniformDescriptor.layoutSize, descriptorBufferProperties.descriptorBufferOffsetAlignment);
-		combinedImageDescriptor.layoutSize = vks::tools::alignedVkSize(combinedImageDescriptor.layoutSize, descriptorBufferProperties.descriptorBufferOffsetAlignment);
-
-		// This buffer will contain resource descriptors for all the uniform buffers (one per cube and one with global matrices)
-		VK_CHECK_RESULT(vulkanDevice->createBuffer(
-			VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
-			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-			&uniformDescriptor.buffer,
-			(static_cast<uint32_t>(cubes.size()) + 1) * uniformDescriptor.layoutSize));
-		uniformDescriptor.buffer.map();
-
-		// This buffer contains resource descriptors for the combined images (one per cube)
-		VK_CHECK_RESULT(vulkanDevice->createBuffer(
-			VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT, // Flags 1 & 2 are required for combined images
-			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-			&combinedImageDescriptor.buffer,
-			static_cast<uint32_t>(cubes.size()) * combinedImageDescriptor.layoutSize));
-		combinedImageDescriptor.buffer.map();
-
-		uniformDescriptor.bufferDeviceAddress.deviceAddress = getBufferDeviceAddress(uniformDescriptor.buffer.buffer);
-		combinedImageDescriptor.bufferDeviceAddress.deviceAddress = getBufferDeviceAddress(combinedImageDescriptor.buffer.buffer);
-
-		VkDescriptorGetInfoEXT descriptorInfo{};
-		descriptorInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT;
+		// Buffers are created for the largest grid, smaller grids only use a part of them
+		// The uniform buffer descriptors (one per cube and one with global matrices)
+		uniformDescriptorBuffer.create(vulkanDevice, descriptorBufferPath.uniformSetLayout, 1, getMaxCubeCount() + 1, false);
+		// The combined image descriptors (one per cube)
+		imageDescriptorBuffer.create(vulkanDevice, descriptorBufferPath.imageSetLayout, 1, getMaxCubeCount(), true);
+	}
 
-		// Put image descriptors into the corresponding resource buffer
-		char* imageDescriptorBufPtr = (char*)combinedImageDescriptor.buffer.mapped;
-		descriptorInfo.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-		for (uint32_t i = 0; i < static_cast<uint32_t>(cubes.size()); i++) {
-			descriptorInfo.data.pCombinedImageSampler = &cubes[i].texture.descriptor;
-			vkGetDescriptorEXT(device, &descriptorInfo, descriptorBufferProperties.combinedImageSamplerDescriptorSize, imageDescriptorBufPtr + i * combinedImageDescriptor.layoutSize + combinedImageDescriptor.layoutOffset);
+	// Writes the descriptors for all cubes with the selected path and measures the time it takes
+	void updateDescriptors()
+	{
+		auto tStart = std::chrono::high_resolution_clock::now();
+		VkDescriptorBufferInfo cameraBufferInfo = { uniformBufferCamera.buffer, 0, uniformBufferCamera.size };
+		if (useDescriptorBuffers) {
+			uniformDescriptorBuffer.reset();
+			imageDescriptorBuffer.reset();
+			cameraSet = uniformDescriptorBuffer.allocate();
+			uniformDescriptorBuffer.writeUniformBuffer(cameraSet, 0, cameraBufferInfo);
+			// Sets are allocated with an atomic counter and written to separate parts of the buffers, so the cubes are split across threads without any locking
+			const uint32_t cubeCount = static_cast<uint32_t>(cubes.size());
+			const uint32_t threadCount = std::max(std::min(std::thread::hardware_concurrency(), cubeCount / 256), 1u);
+			auto writeCubeDescriptors = [&](uint32_t first, uint32_t last) {
+				for (uint32_t i = first; i < last; i++) {
+					Cube& cube = cubes[i];
+					cube.uniformSet = uniformDescriptorBuffer.allocate();
+					uniformDescriptorBuffer.writeUniformBuffer(cube.uniformSet, 0, { uniformBufferCubes.buffer, i * cubeUniformStride, sizeof(glm::mat4) });
+					cube.imageSet = imageDescriptorBuffer.allocate();
+					imageDescriptorBuffer.writeCombinedImageSampler(cube.imageSet, 0, textures[cube.textureIndex].descriptor);
+				}
+			};
+			std::vector<std::thread> threads;
+			for (uint32_t t = 1; t < threadCount; t++) {
+				threads.push_back(std::thread(writeCubeDescriptors, t * cubeCount / threadCount, (t + 1) * cubeCount / threadCount));
+			}
+			writeCubeDescriptors(0, cubeCount / threadCount);
+			for (auto& thread : threads) {
+				thread.join();
+			}
 		}
-
-		// For uniform buffers we only need buffer device addresses
-		// Global uniform buffer
-		char* uniformDescriptorBufPtr = (char*)uniformDescriptor.buffer.mapped;
-
-		VkDescriptorAddressInfoEXT descriptorAddressInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT };
-		descriptorAddressInfo.address = getBufferDeviceAddress(uniformBufferCamera.buffer);
-		descriptorAddressInfo.range = uniformBufferCamera.size;
-		descriptorAddressInfo.format = VK_FORMAT_UNDEFINED;
-
-		descriptorInfo.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-		descriptorInfo.data.pCombinedImageSampler = nullptr;
-		descriptorInfo.data.pUniformBuffer = &descriptorAddressInfo;
-		vkGetDescriptorEXT(device, &descriptorInfo, descriptorBufferProperties.uniformBufferDescriptorSize, uniformDescriptorBufPtr);
-
-		// Per-model uniform buffers
-		for (uint32_t i = 0; i < static_cast<uint32_t>(cubes.size()); i++) {
-			VkDescriptorAddressInfoEXT addr_info = { VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT };
-			addr_info.address = getBufferDeviceAddress(cubes[i].uniformBuffer.buffer);
-			addr_info.range = cubes[i].uniformBuffer.size;
-			addr_info.format = VK_FORMAT_UNDEFINED;
-
-			descriptorInfo.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-			descriptorInfo.data.pCombinedImageSampler = nullptr;
-			descriptorInfo.data.pUniformBuffer = &addr_info;
-			vkGetDescriptorEXT(device, &descriptorInfo, descriptorBufferProperties.uniformBufferDescriptorSize, uniformDescriptorBufPtr + (i + 1) * uniformDescriptor.layoutSize + uniformDescriptor.layoutOffset);
+		else {
+			// Pools can't be used from multiple threads without external synchronization, so this is done on a single thread
+			if (descriptorPool != VK_NULL_HANDLE) {
+				vkDestroyDescriptorPool(device, descriptorPool, nullptr);
+			}
+			const uint32_t cubeCount = static_cast<uint32_t>(cubes.size());
+			std::vector<VkDescriptorPoolSize> poolSizes = {
+				vks::initializers::descriptorPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, cubeCount + 1),
+				vks::initializers::descriptorPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, cubeCount),
+			};
+			VkDescriptorPoolCreateInfo descriptorPoolInfo = vks::initializers::descriptorPoolCreateInfo(poolSizes, 2 * cubeCount + 1);
+			VK_CHECK_RESULT(vkCreateDescriptorPool(device, &descriptorPoolInfo, nullptr, &descriptorPool));
+
+			VkDescriptorSetAllocateInfo allocInfo = vks::initializers::descriptorSetAllocateInfo(descriptorPool, &descriptorSetPath.uniformSetLayout, 1);
+			VK_CHECK_RESULT(vkAllocateDescriptorSets(device, &allocInfo, &cameraDescriptorSet));
+			std::vector<VkDescriptorBufferInfo> bufferInfos(cubeCount);
+			std::vector<VkWriteDescriptorSet> writeDescriptorSets = {
+				vks::initializers::writeDescriptorSet(cameraDescriptorSet, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 0, &cameraBufferInfo),
+			};
+			for (uint32_t i = 0; i < cubeCount; i++) {
+				Cube& cube = cubes[i];
+				allocInfo.pSetLayouts = &descriptorSetPath.uniformSetLayout;
+				VK_CHECK_RESULT(vkAllocateDescriptorSets(device, &allocInfo, &cube.uniformDescriptorSet));
+				allocInfo.pSetLayouts = &descriptorSetPath.imageSetLayout;
+				VK_CHECK_RESULT(vkAllocateDescriptorSets(device, &allocInfo, &cube.imageDescriptorSet));
+				bufferInfos[i] = { uniformBufferCubes.buffer, i * cubeUniformStride, sizeof(glm::mat4) };
+				writeDescriptorSets.push_back(vks::initializers::writeDescriptorSet(cube.uniformDescriptorSet, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 0, &bufferInfos[i]));
+				writeDescriptorSets.push_back(vks::initializers::writeDescriptorSet(cube.imageDescriptorSet, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 0, &textures[cube.textureIndex].descriptor));
+			}
+			vkUpdateDescriptorSets(device, static_cast<uint32_t>(writeDescriptorSets.size()), writeDescriptorSets.data(), 0, nullptr);
 		}
+		timings.descriptorUpdate = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - tStart).count();
 	}
 
 	void buildCommandBuffers()
@@ -286,6 +317,9 @@ public:
 		renderPassBeginInfo.clearValueCount = 2;
 		renderPassBeginInfo.pClearValues = clearValues;
 
+		const Path& path = useDescriptorBuffers ? descriptorBufferPath : descriptorSetPath;
+
+		auto tStart = std::chrono::high_resolution_clock::now();
 		for (int32_t i = 0; i < drawCmdBuffers.size(); ++i) {
 			renderPassBeginInfo.framebuffer = frameBuffers[i];
 
@@ -293,7 +327,7 @@ public:
 
 			vkCmdBeginRenderPass(drawCmdBuffers[i], &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
 
-			vkCmdBindPipeline(drawCmdBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+			vkCmdBindPipeline(drawCmdBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, path.pipeline);
 
 			VkViewport viewport = vks::initializers::viewport((float)width, (float)height, 0.0f, 1.0f);
 			vkCmdSetViewport(drawCmdBuffers[i], 0, 1, &viewport);
@@ -301,56 +335,44 @@ public:
 			VkRect2D scissor = vks::initializers::rect2D(width, height, 0, 0);
 			vkCmdSetScissor(drawCmdBuffers[i], 0, 1, &scissor);
 
-			VkDeviceSize offsets[1] = { 0 };
 			model.bindBuffers(drawCmdBuffers[i]);
 
-			// Descriptor buffer bindings
-			// Set 0 = uniform buffer
-			VkDescriptorBufferBindingInfoEXT bindingInfos[2]{};
-			bindingInfos[0].sType = VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT;
-			bindingInfos[0].address = uniformDescriptor.bufferDeviceAddress.deviceAddress;
-			bindingInfos[0].usage = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT;// | VK_BUFFER_USAGE_PUSH_DESCRIPTORS_DESCRIPTOR_BUFFER_BIT_EXT;
-			// Set 1 = Image
-			bindingInfos[1].sType = VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT;
-			bindingInfos[1].pNext = nullptr;
-			bindingInfos[1].address = combinedImageDescriptor.bufferDeviceAddress.deviceAddress;
-			bindingInfos[1].usage = VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT;
-			vkCmdBindDescriptorBuffersEXT(drawCmdBuffers[i], 2, bindingInfos);
-
-			uint32_t bufferIndexUbo = 0;
-			VkDeviceSize bufferOffset = 0;
-
-			// Global Matrices (set 0)
-			bufferOffset = 0;
-			vkCmdSetDescriptorBufferOffsetsEXT(drawCmdBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &bufferIndexUbo, &bufferOffset);
-
-			// Set and offset into descriptor for each model
-			for (uint32_t j = 0; j < static_cast<uint32_t>(cubes.size()); j++) {
-				// Uniform buffer (set 1)
-				// Model ubos start at offset * 1 (slot 0 is global matrices)
-				bufferOffset = (j + 1) * uniformDescriptor.layoutSize;
-				vkCmdSetDescriptorBufferOffsetsEXT(drawCmdBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 1, 1, &bufferIndexUbo, &bufferOffset);
-				// Image (set 2)
-				uint32_t bufferIndexImage = 1;
-				bufferOffset = j * combinedImageDescriptor.layoutSize;
-				vkCmdSetDescriptorBufferOffsetsEXT(drawCmdBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 2, 1, &bufferIndexImage, &bufferOffset);
-				model.draw(drawCmdBuffers[i]);
+			if (useDescriptorBuffers) {
+				// Descriptor buffer bindings, the uniform buffer descriptors are bound at index 0 and the image descriptors at index 1
+				vks::DescriptorBuffer::bind(drawCmdBuffers[i], { &uniformDescriptorBuffer, &imageDescriptorBuffer });
+				// Global Matrices (set 0)
+				uniformDescriptorBuffer.setOffset(drawCmdBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, path.pipelineLayout, 0, cameraSet);
+				// Set an offset into the descriptor buffers for each cube
+				for (const Cube& cube : cubes) {
+					// Uniform buffer (set 1)
+					uniformDescriptorBuffer.setOffset(drawCmdBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, path.pipelineLayout, 1, cube.uniformSet);
+					// Image (set 2)
+					imageDescriptorBuffer.setOffset(drawCmdBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, path.pipelineLayout, 2, cube.imageSet);
+					model.draw(drawCmdBuffers[i]);
+				}
+			}
+			else {
+				vkCmdBindDescriptorSets(drawCmdBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, path.pipelineLayout, 0, 1, &cameraDescriptorSet, 0, nullptr);
+				for (const Cube& cube : cubes) {
+					const std::array<VkDescriptorSet, 2> descriptorSets = { cube.uniformDescriptorSet, cube.imageDescriptorSet };
+					vkCmdBindDescriptorSets(drawCmdBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, path.pipelineLayout, 1, static_cast<uint32_t>(descriptorSets.size()), descriptorSets.data(), 0, nullptr);
+					model.draw(drawCmdBuffers[i]);
+				}
 			}
-
-			drawUI(drawCmdBuffers[i]);
 
 			vkCmdEndRenderPass(drawCmdBuffers[i]);
 
 			VK_CHECK_RESULT(vkEndCommandBuffer(drawCmdBuffers[i]));
 		}
+		timings.commandBufferRecording = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - tStart).count() / static_cast<float>(drawCmdBuffers.size());
 	}
 
 	void loadAssets()
 	{
 		const uint32_t glTFLoadingFlags = vkglTF::FileLoadingFlags::PreTransformVertices | vkglTF::FileLoadingFlags::PreMultiplyVertexColors | vkglTF::FileLoadingFlags::FlipY;
 		model.loadFromFile(getAssetPath() + "models/cube.gltf", vulkanDevice, queue, glTFLoadingFlags);
-		cubes[0].texture.loadFromFile(getAssetPath() + "textures/crate01_color_height_rgba.ktx", VK_FORMAT_R8G8B8A8_UNORM, vulkanDevice, queue);
-		cubes[1].texture.loadFromFile(getAssetPath() + "textures/crate02_color_height_rgba.ktx", VK_FORMAT_R8G8B8A8_UNORM, vulkanDevice, queue);
+		textures[0].loadFromFile(getAssetPath() + "textures/crate01_color_height_rgba.ktx", VK_FORMAT_R8G8B8A8_UNORM, vulkanDevice, queue);
+		textures[1].loadFromFile(getAssetPath() + "textures/crate02_color_height_rgba.ktx", VK_FORMAT_R8G8B8A8_UNORM, vulkanDevice, queue);
 	}
 
 	void prepareUniformBuffers()
@@ -363,16 +385,14 @@ public:
 			sizeof(glm::mat4) * 2));
 		VK_CHECK_RESULT(uniformBufferCamera.map());
 
-		// UBOs for model matrices
-		for (uint32_t i = 0; i < static_cast<uint32_t>(cubes.size()); i++) {
-			VK_CHECK_RESULT(vulkanDevice->createBuffer(
-				VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
-				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-				&cubes[i].uniformBuffer,
-				sizeof(glm::mat4)));
-			VK_CHECK_RESULT(cubes[i].uniformBuffer.map());
-		}
-		updateUniformBuffers();
+		// One UBO for the model matrices of all cubes
+		cubeUniformStride = vks::tools::alignedVkSize(sizeof(glm::mat4), vulkanDevice->properties.limits.minUniformBufferOffsetAlignment);
+		VK_CHECK_RESULT(vulkanDevice->createBuffer(
+			VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			&uniformBufferCubes,
+			getMaxCubeCount() * cubeUniformStride));
+		VK_CHECK_RESULT(uniformBufferCubes.map());
 	}
 
 	void updateUniformBuffers()
@@ -380,18 +400,54 @@ public:
 		memcpy(uniformBufferCamera.mapped, &camera.matrices.perspective, sizeof(glm::mat4));
 		memcpy((char*)uniformBufferCamera.mapped + sizeof(glm::mat4), &camera.matrices.view, sizeof(glm::mat4));
 
-		cubes[0].matrix = glm::translate(glm::mat4(1.0f), glm::vec3(-2.0f, 0.0f, 0.0f));
-		cubes[1].matrix = glm::translate(glm::mat4(1.0f), glm::vec3( 1.5f, 0.5f, 0.0f));
-
-		for (auto& cube : cubes) {
+		for (uint32_t i = 0; i < static_cast<uint32_t>(cubes.size()); i++) {
+			Cube& cube = cubes[i];
+			cube.matrix = glm::translate(glm::mat4(1.0f), cube.position);
 			cube.matrix = glm::rotate(cube.matrix, glm::radians(cube.rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
 			cube.matrix = glm::rotate(cube.matrix, glm::radians(cube.rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
 			cube.matrix = glm::rotate(cube.matrix, glm::radians(cube.rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
 			cube.matrix = glm::scale(cube.matrix, glm::vec3(0.25f));
-			memcpy(cube.uniformBuffer.mapped, &cube.matrix, sizeof(glm::mat4));
+			memcpy((char*)uniformBufferCubes.mapped + i * cubeUniformStride, &cube.matrix, sizeof(glm::mat4));
 		}
 	}
 
+	// Sets up the cubes for the selected grid size and writes their descriptors
+	void setupScene()
+	{
+		const uint32_t gridSize = gridSizes[gridIndex];
+		cubes.clear();
+		if (gridSize == 0) {
+			cubes.resize(2);
+			cubes[0].position = glm::vec3(-2.0f, 0.0f, 0.0f);
+			cubes[1].position = glm::vec3(1.5f, 0.5f, 0.0f);
+		}
+		else {
+			// Cubes are placed on a grid in the xy plane, the camera is moved back so the whole grid is visible
+			cubes.resize(gridSize * gridSize);
+			const float spacing = 0.75f;
+			for (uint32_t y = 0; y < gridSize; y++) {
+				for (uint32_t x = 0; x < gridSize; x++) {
+					cubes[y * gridSize + x].position = glm::vec3((float(x) - float(gridSize - 1) * 0.5f) * spacing, (float(y) - float(gridSize - 1) * 0.5f) * spacing, 0.0f);
+				}
+			}
+		}
+		for (uint32_t i = 0; i < static_cast<uint32_t>(cubes.size()); i++) {
+			cubes[i].rotation = glm::vec3(0.0f, float(i % 90) * 4.0f, 0.0f);
+			cubes[i].textureIndex = i % static_cast<uint32_t>(textures.size());
+		}
+		camera.setTranslation(glm::vec3(0.0f, 0.0f, (gridSize == 0) ? -5.0f : -float(gridSize) * 0.75f));
+		updateDescriptors();
+		updateUniformBuffers();
+	}
+
+	// Switching the grid size or the descriptor path rewrites all descriptors and records the command buffers again
+	void rebuildScene()
+	{
+		vkDeviceWaitIdle(device);
+		setupScene();
+		buildCommandBuffers();
+	}
+
 	void draw()
 	{
 		VulkanExampleBase::prepareFrame();
@@ -404,22 +460,12 @@ public:
 	void prepare()
 	{
 		VulkanExampleBase::prepare();
-
-		vkGetBufferDeviceAddressKHR = reinterpret_cast<PFN_vkGetBufferDeviceAddressKHR>(vkGetDeviceProcAddr(device, "vkGetBufferDeviceAddressKHR"));
-
-		vkGetDescriptorSetLayoutSizeEXT = reinterpret_cast<PFN_vkGetDescriptorSetLayoutSizeEXT>(vkGetDeviceProcAddr(device, "vkGetDescriptorSetLayoutSizeEXT"));
-		vkGetDescriptorSetLayoutBindingOffsetEXT = reinterpret_cast<PFN_vkGetDescriptorSetLayoutBindingOffsetEXT>(vkGetDeviceProcAddr(device, "vkGetDescriptorSetLayoutBindingOffsetEXT"));
-		vkCmdBindDescriptorBuffersEXT = reinterpret_cast<PFN_vkCmdBindDescriptorBuffersEXT>(vkGetDeviceProcAddr(device, "vkCmdBindDescriptorBuffersEXT"));
-		vkGetDescriptorEXT = reinterpret_cast<PFN_vkGetDescriptorEXT>(vkGetDeviceProcAddr(device, "vkGetDescriptorEXT"));
-		vkCmdBindDescriptorBufferEmbeddedSamplersEXT = reinterpret_cast<PFN_vkCmdBindDescriptorBufferEmbeddedSamplersEXT>(vkGetDeviceProcAddr(device, "vkCmdBindDescriptorBufferEmbeddedSamplersEXT"));
-		vkCmdSetDescriptorBufferOffsetsEXT = reinterpret_cast<PFN_vkCmdSetDescriptorBufferOffsetsEXT>(vkGetDeviceProcAddr(device, "vkCmdSetDescriptorBufferOffsetsEXT"));
-
 		loadAssets();
 		prepareUniformBuffers();
-		setupDescriptors();
-		prepareDescriptorBuffer();
+		setupDescriptorSetLayouts();
+		prepareDescriptorBuffers();
 		preparePipelines();
-		buildCommandBuffers();
+		rebuildScene();
 		prepared = true;
 	}
 
@@ -429,12 +475,14 @@ public:
 			return;
 		draw();
 		if (animate && !paused) {
-			cubes[0].rotation.x += 2.5f * frameTimer;
-			if (cubes[0].rotation.x > 360.0f)
-				cubes[0].rotation.x -= 360.0f;
-			cubes[1].rotation.y += 2.0f * frameTimer;
-			if (cubes[1].rotation.y > 360.0f)
-				cubes[1].rotation.y -= 360.0f;
+			for (uint32_t i = 0; i < static_cast<uint32_t>(cubes.size()); i++) {
+				// Alternate the rotation axis, so neighbouring cubes can be told apart
+				float& angle = (i % 2 == 0) ? cubes[i].rotation.x : cubes[i].rotation.y;
+				angle += ((i % 2 == 0) ? 2.5f : 2.0f) * frameTimer;
+				if (angle > 360.0f) {
+					angle -= 360.0f;
+				}
+			}
 		}
 		if ((camera.updated) || (animate && !paused)) {
 			updateUniformBuffers();
@@ -445,6 +493,17 @@ public:
 	{
 		if (overlay->header("Settings")) {
 			overlay->checkBox("Animate", &animate);
+			if (overlay->comboBox("Scene", &gridIndex, gridNames)) {
+				rebuildScene();
+			}
+			if (overlay->checkBox("Descriptor buffers", &useDescriptorBuffers)) {
+				rebuildScene();
+			}
+		}
+		if (overlay->header("CPU timings")) {
+			overlay->text("Draws: %d", static_cast<uint32_t>(cubes.size()));
+			overlay->text("Descriptor update: %.3f ms", timings.descriptorUpdate);
+			overlay->text("Command buffer recording: %.3f ms", timings.commandBufferRecording);
 		}
 	}
 };
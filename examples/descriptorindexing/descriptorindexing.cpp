@@ -96,7 +96,7 @@ public:
 		textures.resize(32);
 		for (size_t i = 0; i < textures.size(); i++) {
 			std::random_device rndDevice;
-			std::default_random_engine rndEngine(benchmark.active ? 0 : rndDevice());
+			std::default_random_engine rndEngine(settings.deterministic ? 0 : rndDevice());
 			std::uniform_int_distribution<> rndDist(50, UCHAR_MAX);
 			const int32_t dim = 3;
 			const size_t bufferSize = dim * dim * 4;
@@ -119,7 +119,7 @@ public:
 
 		// Generate random per-face texture indices
 		std::random_device rndDevice;
-		std::default_random_engine rndEngine(benchmark.active ? 0 : rndDevice());
+		std::default_random_engine rndEngine(settings.deterministic ? 0 : rndDevice());
 		std::uniform_int_distribution<int32_t> rndDist(0, static_cast<uint32_t>(textures.size()) - 1);
 
 		// Generate cubes with random per-face texture indices
@@ -392,7 +392,6 @@ public:
 			vkCmdBindVertexBuffers(drawCmdBuffers[i], 0, 1, &vertexBuffer.buffer, offsets);
 			vkCmdBindIndexBuffer(drawCmdBuffers[i], indexBuffer.buffer, 0, VK_INDEX_TYPE_UINT32);
 			vkCmdDrawIndexed(drawCmdBuffers[i], indexCount, 1, 0, 0, 0);
-			drawUI(drawCmdBuffers[i]);
 			vkCmdEndRenderPass(drawCmdBuffers[i]);
 			VK_CHECK_RESULT(vkEndCommandBuffer(drawCmdBuffers[i]));
 		}
@@ -164,8 +164,6 @@ public:
 			vkCmdBindPipeline(drawCmdBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
 
 			model.draw(drawCmdBuffers[i], vkglTF::RenderFlags::BindImages, pipelineLayout);
-			
-			drawUI(drawCmdBuffers[i]);
 
 			// End dynamic rendering
 			vkCmdEndRenderingKHR(drawCmdBuffers[i]);
@@ -0,0 +1,69 @@
+# Copyright (C) 2025 by Sascha Willems - www.saschawillems.de
+# This code is licensed under the MIT license (MIT) (http://opensource.org/licenses/MIT)
+
+# Cooks the textures of a glTF scene into block compressed ktx files with a full mip chain
+# The sample picks the best variant supported by the device at runtime and falls back to the uncompressed textures if none is present
+
+import argparse
+import os
+import subprocess
+import sys
+
+parser = argparse.ArgumentParser(description='Cook glTF scene textures into block compressed ktx files')
+parser.add_argument('path', type=str, help='directory containing the textures to cook (e.g. assets/models/sponza)')
+parser.add_argument('--pvrtextool', type=str, help='path to PVRTexToolCLI executable')
+parser.add_argument('--formats', type=str, default='bc7,bc3,astc,etc2', help='comma separated list of formats to cook (bc7, bc3, astc, etc2)')
+parser.add_argument('--force', action='store_true', help='cook textures even if the cooked file is newer than the source')
+args = parser.parse_args()
+
+# Suffixes must match vks::getCompressedTextureFormat
+formats = {
+    "bc7": "BC7",
+    "bc3": "BC3",
+    "astc": "ASTC_4x4",
+    "etc2": "ETC2_RGBA",
+}
+suffixes = tuple(["_" + suffix for suffix in formats.keys()])
+
+def findPVRTexTool():
+    def isExe(path):
+        return os.path.isfile(path) and os.access(path, os.X_OK)
+
+    if args.pvrtextool != None and isExe(args.pvrtextool):
+        return args.pvrtextool
+
+    exe_name = "PVRTexToolCLI"
+    if os.name == "nt":
+        exe_name += ".exe"
+
+    for exe_dir in os.environ["PATH"].split(os.pathsep):
+        full_path = os.path.join(exe_dir, exe_name)
+        if isExe(full_path):
+            return full_path
+
+    sys.exit("Could not find PVRTexToolCLI executable on PATH, and was not specified with --pvrtextool")
+
+file_extensions = tuple([".ktx", ".png", ".jpg", ".jpeg"])
+
+requested_formats = [format.strip() for format in args.formats.split(",")]
+for format in requested_formats:
+    if format not in formats:
+        sys.exit("Unknown format %s" % format)
+
+pvrtextool_path = findPVRTexTool()
+for root, dirs, files in os.walk(args.path):
+    for file in files:
+        name, extension = os.path.splitext(file)
+        # Skip files that have already been cooked
+        if not file.endswith(file_extensions) or name.endswith(suffixes):
+            continue
+        input_file = os.path.join(root, file)
+        for format in requested_formats:
+            output_file = os.path.join(root, name + "_" + format + ".ktx")
+            if not args.force and os.path.isfile(output_file) and os.path.getmtime(output_file) >= os.path.getmtime(input_file):
+                continue
+            # Textures are sampled as UNORM in the sample, so they're compressed in linear color space
+            res = subprocess.call("%s -i %s -o %s -f %s,UBN,lRGB -m -q pvrtcbest" % (pvrtextool_path, input_file, output_file, formats[format]), shell=True)
+            if res != 0:
+                sys.exit(res)
+            print("%s -> %s" % (input_file, output_file))
@@ -48,11 +48,26 @@ VulkanglTFScene::~VulkanglTFScene()
 void VulkanglTFScene::loadImages(tinygltf::Model& input)
 {
 	// POI: The textures for the glTF file used in this sample are stored as external ktx files, so we can directly load them from disk without the need for conversion
+	// POI: If the textures have been cooked offline into a block compressed format supported by the device (see cooktextures.py), those are loaded instead
+	auto tStart = std::chrono::high_resolution_clock::now();
+	textureStatistics = {};
 	images.resize(input.images.size());
 	for (size_t i = 0; i < input.images.size(); i++) {
 		tinygltf::Image& glTFImage = input.images[i];
-		images[i].texture.loadFromFile(path + "/" + glTFImage.uri, VK_FORMAT_R8G8B8A8_UNORM, vulkanDevice, copyQueue);
+		const std::string filename = path + "/" + glTFImage.uri;
+		const std::string cookedFilename = vks::getCookedTextureFilename(filename, compressedTextureFormat);
+		images[i].cooked = !cookedFilename.empty();
+		if (images[i].cooked) {
+			images[i].texture.loadFromFile(cookedFilename, compressedTextureFormat.format, vulkanDevice, copyQueue);
+			textureStatistics.cookedCount++;
+		} else {
+			images[i].texture.loadFromFile(filename, VK_FORMAT_R8G8B8A8_UNORM, vulkanDevice, copyQueue);
+		}
+		textureStatistics.memorySize += images[i].texture.memorySize;
+		// Size of the same image stored as RGBA8 with a full mip chain
+		textureStatistics.uncompressedMemorySize += (VkDeviceSize)images[i].texture.width * images[i].texture.height * 4 * 4 / 3;
 	}
+	textureStatistics.loadTime = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - tStart).count();
 }
 
 void VulkanglTFScene::loadTextures(tinygltf::Model& input)
@@ -307,6 +322,10 @@ VulkanExample::~VulkanExample()
 void VulkanExample::getEnabledFeatures()
 {
 	enabledFeatures.samplerAnisotropy = deviceFeatures.samplerAnisotropy;
+	// Block compression is required for the cooked texture variants
+	enabledFeatures.textureCompressionBC = deviceFeatures.textureCompressionBC;
+	enabledFeatures.textureCompressionASTC_LDR = deviceFeatures.textureCompressionASTC_LDR;
+	enabledFeatures.textureCompressionETC2 = deviceFeatures.textureCompressionETC2;
 }
 
 void VulkanExample::buildCommandBuffers()
@@ -343,7 +362,6 @@ void VulkanExample::buildCommandBuffers()
 		// POI: Draw the glTF scene
 		glTFScene.draw(drawCmdBuffers[i], pipelineLayout);
 
-		drawUI(drawCmdBuffers[i]);
 		vkCmdEndRenderPass(drawCmdBuffers[i]);
 		VK_CHECK_RESULT(vkEndCommandBuffer(drawCmdBuffers[i]));
 	}
@@ -367,6 +385,7 @@ void VulkanExample::loadglTFFile(std::string filename)
 	// Pass some Vulkan resources required for setup and rendering to the glTF model loading class
 	glTFScene.vulkanDevice = vulkanDevice;
 	glTFScene.copyQueue    = queue;
+	glTFScene.compressedTextureFormat = vks::getCompressedTextureFormat(vulkanDevice);
 
 	size_t pos = filename.find_last_of('/');
 	glTFScene.path = filename.substr(0, pos);
@@ -658,6 +677,14 @@ void VulkanExample::OnUpdateUIOverlay(vks::UIOverlay* overlay)
 		}
 		ImGui::EndChild();
 	}
+	if (overlay->header("Textures")) {
+		const VulkanglTFScene::TextureStatistics& stats = glTFScene.textureStatistics;
+		overlay->text("Format: %s", glTFScene.compressedTextureFormat.format != VK_FORMAT_UNDEFINED ? glTFScene.compressedTextureFormat.suffix.substr(1).c_str() : "none supported");
+		overlay->text("Cooked: %d / %d", stats.cookedCount, (int)glTFScene.images.size());
+		overlay->text("Device memory: %.1f MB", (float)stats.memorySize / (1024.0f * 1024.0f));
+		overlay->text("RGBA8 equivalent: %.1f MB", (float)stats.uncompressedMemorySize / (1024.0f * 1024.0f));
+		overlay->text("Load time: %.1f ms", stats.loadTime);
+	}
 }
 
 VULKAN_EXAMPLE_MAIN()
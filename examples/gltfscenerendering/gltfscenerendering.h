@@ -103,6 +103,8 @@ public:
 	// Images may be reused by texture objects and are as such separated
 	struct Image {
 		vks::Texture2D texture;
+		// True if the image was loaded from an offline cooked block compressed variant
+		bool cooked = false;
 	};
 
 	// A glTF texture stores a reference to the image and a sampler
@@ -121,6 +123,16 @@ public:
 
 	std::string path;
 
+	// Block compressed format for cooked texture variants, undefined if the device doesn't support any of them
+	vks::CompressedTextureFormat compressedTextureFormat;
+	// Texture loading statistics, used to compare cooked block compressed textures with uncompressed RGBA8 textures
+	struct TextureStatistics {
+		uint32_t cookedCount{ 0 };
+		VkDeviceSize memorySize{ 0 };
+		VkDeviceSize uncompressedMemorySize{ 0 };
+		float loadTime{ 0.0f };
+	} textureStatistics;
+
 	~VulkanglTFScene();
 	VkDescriptorImageInfo getTextureDescriptor(const size_t index);
 	void loadImages(tinygltf::Model& input);
@@ -153,8 +153,6 @@ public:
 				}
 			}
 
-			drawUI(drawCmdBuffers[i]);
-
 			vkCmdEndRenderPass(drawCmdBuffers[i]);
 
 			VK_CHECK_RESULT(vkEndCommandBuffer(drawCmdBuffers[i]));
@@ -375,7 +373,7 @@ public:
 		shaderStageCI.pName = "main";
 
 		// Select lighting model using a specialization constant
-		srand(benchmark.active ? 0 : ((unsigned int)time(NULL)));
+		srand(settings.deterministic ? 0 : ((unsigned int)time(NULL)));
 		uint32_t lighting_model = (int)(rand() % 4);
 
 		// Each shader constant of a shader stage corresponds to one map entry
@@ -275,8 +275,6 @@ public:
 					vkCmdDraw(drawCmdBuffers[i], 3, 1, 0, 0);
 				}
 
-				drawUI(drawCmdBuffers[i]);
-
 				vkCmdEndRenderPass(drawCmdBuffers[i]);
 			}
 
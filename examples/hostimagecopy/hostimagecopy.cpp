@@ -2,8 +2,9 @@
 * Vulkan Example - Host image copy using VK_EXT_host_image_copy
 * 
 * This sample shows how to use host image copies to directly upload an image to the devic without having to use staging
-
-* Copyright (C) 2024 by Sascha Willems - www.saschawillems.de
+* It also compares the load times of the texture loaders with staging uploads against host image copies on one and on multiple threads
+*
+* Copyright (C) 2024-2025 by Sascha Willems - www.saschawillems.de
 *
 * This code is licensed under the MIT license (MIT) (http://opensource.org/licenses/MIT)
 */
@@ -12,6 +13,9 @@
 #include "VulkanglTFModel.h"
 #include <ktx.h>
 #include <ktxvulkan.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
 
 class VulkanExample : public VulkanExampleBase
 {
@@ -22,8 +26,6 @@ public:
 	// Used to check feature image format support for host image copies
 	PFN_vkGetPhysicalDeviceFormatProperties2 vkGetPhysicalDeviceFormatProperties2{ nullptr };
 
-	VkPhysicalDeviceHostImageCopyFeaturesEXT enabledPhysicalDeviceHostImageCopyFeaturesEXT{};
-
 	// Contains all Vulkan objects that are required to store and use a texture
 	struct Texture {
 		VkSampler sampler{ VK_NULL_HANDLE };
@@ -50,6 +52,17 @@ public:
 	VkDescriptorSet descriptorSet{ VK_NULL_HANDLE };
 	VkDescriptorSetLayout descriptorSetLayout{ VK_NULL_HANDLE };
 
+	// Load time benchmark of the shared texture loaders
+	struct Benchmark {
+		int32_t textureCount{ 32 };
+		bool requested{ false };
+		// Average load time per texture in milliseconds for staging, host image copy and host image copy on worker threads
+		float staging{ 0.0f };
+		float hostCopy{ 0.0f };
+		float hostCopyThreaded{ 0.0f };
+		uint32_t threadCount{ 0 };
+	} benchmark;
+
 	VulkanExample() : VulkanExampleBase()
 	{
 		title = "Host image copy";
@@ -57,17 +70,7 @@ public:
 		camera.setPosition(glm::vec3(0.0f, 0.0f, -1.5f));
 		camera.setRotation(glm::vec3(0.0f, 15.0f, 0.0f));
 		camera.setPerspective(60.0f, (float)width / (float)height, 0.1f, 256.0f);
-
-		// Enable required extensions
-		enabledInstanceExtensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
-		enabledDeviceExtensions.push_back(VK_KHR_FORMAT_FEATURE_FLAGS_2_EXTENSION_NAME);
-		enabledDeviceExtensions.push_back(VK_KHR_COPY_COMMANDS_2_EXTENSION_NAME);
-		enabledDeviceExtensions.push_back(VK_EXT_HOST_IMAGE_COPY_EXTENSION_NAME);
-
-		// Enable host image copy feature
-		enabledPhysicalDeviceHostImageCopyFeaturesEXT.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_IMAGE_COPY_FEATURES_EXT;
-		enabledPhysicalDeviceHostImageCopyFeaturesEXT.hostImageCopy = VK_TRUE;
-		deviceCreatepNextChain = &enabledPhysicalDeviceHostImageCopyFeaturesEXT;
+		// The extensions and the feature for host image copies are enabled by the base class if the device supports them
 	}
 
 	~VulkanExample()
@@ -151,7 +154,7 @@ public:
 		vkGetPhysicalDeviceFormatProperties2(physicalDevice, imageFormat, &formatProperties2);
 
 		if ((formatProperties3.optimalTilingFeatures & VK_FORMAT_FEATURE_2_HOST_IMAGE_TRANSFER_BIT_EXT) == 0) {
-			vks::tools::exitFatal("The selected image format does not support the required host transfer bit.", -1);
+			vks::tools::exitFatal("The selected image format does not support the required host transfer bit.", VK_ERROR_FEATURE_NOT_PRESENT);
 		}
 
 		// Create optimal tiled target image on the device
@@ -308,8 +311,6 @@ public:
 
 			plane.draw(drawCmdBuffers[i]);
 
-			drawUI(drawCmdBuffers[i]);
-
 			vkCmdEndRenderPass(drawCmdBuffers[i]);
 
 			VK_CHECK_RESULT(vkEndCommandBuffer(drawCmdBuffers[i]));
@@ -413,10 +414,62 @@ public:
 		plane.loadFromFile(getAssetPath() + "models/plane_z.gltf", vulkanDevice, queue, glTFLoadingFlags);
 	}
 
+	/*
+		Load time benchmark
+
+		Loads the same texture multiple times with vks::Texture2D, once with staging uploads, once with host image copies
+		and once with host image copies spread across worker threads. Staging uploads need a command buffer and a queue submission
+		per texture, while host image copies are done by the CPU and don't need any synchronization between the threads.
+		Load times include reading the ktx file, which is the same for all variants.
+	*/
+	float loadTextures(bool hostImageCopy, uint32_t threadCount)
+	{
+		const std::string filename = getAssetPath() + "textures/metalplate01_rgba.ktx";
+		std::vector<vks::Texture2D> textures(benchmark.textureCount);
+		vulkanDevice->useHostImageCopy = hostImageCopy;
+		auto tStart = std::chrono::high_resolution_clock::now();
+		std::atomic<uint32_t> nextTexture{ 0 };
+		auto loadWorker = [&]() {
+			for (uint32_t index = nextTexture++; index < textures.size(); index = nextTexture++) {
+				textures[index].loadFromFile(filename, VK_FORMAT_R8G8B8A8_UNORM, vulkanDevice, queue);
+			}
+		};
+		std::vector<std::thread> threads;
+		for (uint32_t i = 1; i < threadCount; i++) {
+			threads.emplace_back(loadWorker);
+		}
+		loadWorker();
+		for (std::thread& thread : threads) {
+			thread.join();
+		}
+		auto tEnd = std::chrono::high_resolution_clock::now();
+		vulkanDevice->useHostImageCopy = settings.hostImageCopy;
+		for (vks::Texture2D& texture : textures) {
+			texture.destroy();
+		}
+		return std::chrono::duration<float, std::milli>(tEnd - tStart).count() / static_cast<float>(textures.size());
+	}
+
+	void runBenchmark()
+	{
+		benchmark.threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+		benchmark.staging = loadTextures(false, 1);
+		benchmark.hostCopy = loadTextures(true, 1);
+		benchmark.hostCopyThreaded = loadTextures(true, benchmark.threadCount);
+		std::cout << "Average load time of " << benchmark.textureCount << " textures:\n";
+		std::cout << "  Staging: " << benchmark.staging << " ms\n";
+		std::cout << "  Host image copy: " << benchmark.hostCopy << " ms\n";
+		std::cout << "  Host image copy (" << benchmark.threadCount << " threads): " << benchmark.hostCopyThreaded << " ms\n";
+	}
+
 	void prepare()
 	{
 		VulkanExampleBase::prepare();
 
+		if (!vulkanDevice->hostImageCopySupported) {
+			vks::tools::exitFatal("Selected GPU does not support host image copies!", VK_ERROR_FEATURE_NOT_PRESENT);
+		}
+
 		// Get the function pointers required host image copies
 		vkCopyMemoryToImageEXT = reinterpret_cast<PFN_vkCopyMemoryToImageEXT>(vkGetDeviceProcAddr(device, "vkCopyMemoryToImageEXT"));
 		vkTransitionImageLayoutEXT = reinterpret_cast<PFN_vkTransitionImageLayoutEXT>(vkGetDeviceProcAddr(device, "vkTransitionImageLayoutEXT"));
@@ -444,6 +497,11 @@ public:
 	{
 		if (!prepared)
 			return;
+		// Run outside of the UI update, as staging uploads submit to the graphics queue
+		if (benchmark.requested) {
+			benchmark.requested = false;
+			runBenchmark();
+		}
 		updateUniformBuffers();
 		draw();
 	}
@@ -455,6 +513,17 @@ public:
 				updateUniformBuffers();
 			}
 		}
+		if (overlay->header("Load time benchmark")) {
+			overlay->sliderInt("Textures", &benchmark.textureCount, 1, 128);
+			if (overlay->button("Run")) {
+				benchmark.requested = true;
+			}
+			if (benchmark.threadCount > 0) {
+				overlay->text("Staging: %.3f ms", benchmark.staging);
+				overlay->text("Host image copy: %.3f ms", benchmark.hostCopy);
+				overlay->text("Host image copy (%d threads): %.3f ms", benchmark.threadCount, benchmark.hostCopyThreaded);
+			}
+		}
 	}
 };
 
@@ -147,7 +147,6 @@ public:
 				vkCmdPushConstants(drawCmdBuffers[i], pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(glm::vec3), &pos);
 				model.draw(drawCmdBuffers[i]);
 			}
-			drawUI(drawCmdBuffers[i]);
 
 			vkCmdEndRenderPass(drawCmdBuffers[i]);
 
@@ -161,7 +160,7 @@ public:
 
 		// Setup random materials for every object in the scene
 		for (uint32_t i = 0; i < objects.size(); i++) {
-			objects[i].setRandomMaterial(!benchmark.active);
+			objects[i].setRandomMaterial(!settings.deterministic);
 		}
 	}
 
@@ -342,7 +341,7 @@ public:
 	void updateMaterials() {
 		// Setup random materials for every object in the scene
 		for (uint32_t i = 0; i < objects.size(); i++) {
-			objects[i].setRandomMaterial(!benchmark.active);
+			objects[i].setRandomMaterial(!settings.deterministic);
 		}
 
 		for (auto &object : objects) {
@@ -51,7 +51,8 @@ public:
 		float locSpeed = 0.0f;
 		float globSpeed = 0.0f;
 	} uniformData;
-	vks::Buffer uniformBuffer;
+	// Written to the base class' uniform allocator, which has a copy of the slot for each command buffer
+	vks::UniformAllocator::Slot uniformSlot;
 
 	VkPipelineLayout pipelineLayout{ VK_NULL_HANDLE };
 	struct {
@@ -87,7 +88,6 @@ public:
 			vkFreeMemory(device, instanceBuffer.memory, nullptr);
 			textures.rocks.destroy();
 			textures.planet.destroy();
-			uniformBuffer.destroy();
 		}
 	}
 
@@ -102,6 +102,12 @@ public:
 
 	void buildCommandBuffers()
 	{
+		// Recreating the swap chain may change the number of command buffers, the uniform allocator needs a region for each of them
+		if (uniformAllocator.getFrameCount() != drawCmdBuffers.size()) {
+			prepareUniformBuffers();
+			updateUniformDescriptors();
+		}
+
 		VkCommandBufferBeginInfo cmdBufInfo = vks::initializers::commandBufferBeginInfo();
 
 		VkClearValue clearValues[2];
@@ -131,19 +137,21 @@ public:
 			vkCmdSetScissor(drawCmdBuffers[i], 0, 1, &scissor);
 
 			VkDeviceSize offsets[1] = { 0 };
+			// The dynamic offset selects the uniform data of the frame this command buffer is used for
+			const uint32_t dynamicOffset = uniformAllocator.getOffset(uniformSlot, i);
 
 			// Star field
-			vkCmdBindDescriptorSets(drawCmdBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descriptorSets.planet, 0, NULL);
+			vkCmdBindDescriptorSets(drawCmdBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descriptorSets.planet, 1, &dynamicOffset);
 			vkCmdBindPipeline(drawCmdBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines.starfield);
 			vkCmdDraw(drawCmdBuffers[i], 3, 1, 0, 0);
 
 			// Planet
-			vkCmdBindDescriptorSets(drawCmdBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descriptorSets.planet, 0, NULL);
+			vkCmdBindDescriptorSets(drawCmdBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descriptorSets.planet, 1, &dynamicOffset);
 			vkCmdBindPipeline(drawCmdBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines.planet);
 			models.planet.draw(drawCmdBuffers[i]);
 
 			// Instanced rocks
-			vkCmdBindDescriptorSets(drawCmdBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descriptorSets.instancedRocks, 0, NULL);
+			vkCmdBindDescriptorSets(drawCmdBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descriptorSets.instancedRocks, 1, &dynamicOffset);
 			vkCmdBindPipeline(drawCmdBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines.instancedRocks);
 			// Binding point 0 : Mesh vertex buffer
 			vkCmdBindVertexBuffers(drawCmdBuffers[i], 0, 1, &models.rock.vertices.buffer, offsets);
@@ -155,8 +163,6 @@ public:
 			// Render instances
 			vkCmdDrawIndexed(drawCmdBuffers[i], models.rock.indices.count, INSTANCE_COUNT, 0, 0, 0);
 
-			drawUI(drawCmdBuffers[i]);
-
 			vkCmdEndRenderPass(drawCmdBuffers[i]);
 
 			VK_CHECK_RESULT(vkEndCommandBuffer(drawCmdBuffers[i]));
@@ -177,7 +183,7 @@ public:
 	{
 		// Pool
 		std::vector<VkDescriptorPoolSize> poolSizes = {
-			vks::initializers::descriptorPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2),
+			vks::initializers::descriptorPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 2),
 			vks::initializers::descriptorPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 2),
 		};
 		VkDescriptorPoolCreateInfo descriptorPoolInfo = vks::initializers::descriptorPoolCreateInfo(poolSizes, 2);
@@ -186,7 +192,7 @@ public:
 		// Layout
 		std::vector<VkDescriptorSetLayoutBinding> setLayoutBindings = {
 			// Binding 0 : Vertex shader uniform buffer
-			vks::initializers::descriptorSetLayoutBinding(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_VERTEX_BIT, 0),
+			vks::initializers::descriptorSetLayoutBinding(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, VK_SHADER_STAGE_VERTEX_BIT, 0),
 			// Binding 1 : Fragment shader combined sampler
 			vks::initializers::descriptorSetLayoutBinding(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT, 1),
 		};
@@ -200,24 +206,36 @@ public:
 		descripotrSetAllocInfo = vks::initializers::descriptorSetAllocateInfo(descriptorPool, &descriptorSetLayout, 1);
 
 		// Instanced rocks
-		//	Binding 0 : Vertex shader uniform buffer
+		//	Binding 0 : Vertex shader uniform buffer (see updateUniformDescriptors)
 		//	Binding 1 : Color map
 		VK_CHECK_RESULT(vkAllocateDescriptorSets(device, &descripotrSetAllocInfo, &descriptorSets.instancedRocks));
 		writeDescriptorSets = {
-			vks::initializers::writeDescriptorSet(descriptorSets.instancedRocks, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,	0, &uniformBuffer.descriptor),
 			vks::initializers::writeDescriptorSet(descriptorSets.instancedRocks, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, &textures.rocks.descriptor)
 		};
 		vkUpdateDescriptorSets(device, static_cast<uint32_t>(writeDescriptorSets.size()), writeDescriptorSets.data(), 0, nullptr);
 
 		// Planet
-		//	Binding 0 : Vertex shader uniform buffer
+		//	Binding 0 : Vertex shader uniform buffer (see updateUniformDescriptors)
 		//	Binding 1 : Color map
 		VK_CHECK_RESULT(vkAllocateDescriptorSets(device, &descripotrSetAllocInfo, &descriptorSets.planet));
 		writeDescriptorSets = {
-			vks::initializers::writeDescriptorSet(descriptorSets.planet, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,	0, &uniformBuffer.descriptor),
 			vks::initializers::writeDescriptorSet(descriptorSets.planet, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, &textures.planet.descriptor)
 		};
 		vkUpdateDescriptorSets(device, static_cast<uint32_t>(writeDescriptorSets.size()), writeDescriptorSets.data(), 0, nullptr);
+
+		updateUniformDescriptors();
+	}
+
+	// Points both sets at the uniform allocator's buffer, which changes whenever the allocator is recreated
+	void updateUniformDescriptors()
+	{
+		VkDescriptorBufferInfo uniformDescriptor = uniformAllocator.getDescriptor(sizeof(UniformData));
+		std::vector<VkWriteDescriptorSet> writeDescriptorSets = {
+			// Binding 0 : Vertex shader uniform buffer
+			vks::initializers::writeDescriptorSet(descriptorSets.instancedRocks, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 0, &uniformDescriptor),
+			vks::initializers::writeDescriptorSet(descriptorSets.planet, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 0, &uniformDescriptor)
+		};
+		vkUpdateDescriptorSets(device, static_cast<uint32_t>(writeDescriptorSets.size()), writeDescriptorSets.data(), 0, nullptr);
 	}
 
 	void preparePipelines()
@@ -321,7 +339,7 @@ public:
 		std::vector<InstanceData> instanceData;
 		instanceData.resize(INSTANCE_COUNT);
 
-		std::default_random_engine rndGenerator(benchmark.active ? 0 : (unsigned)time(nullptr));
+		std::default_random_engine rndGenerator(settings.deterministic ? 0 : (unsigned)time(nullptr));
 		std::uniform_real_distribution<float> uniformDist(0.0, 1.0);
 		std::uniform_int_distribution<uint32_t> rndTextureIndex(0, textures.rocks.layerCount);
 
@@ -400,12 +418,12 @@ public:
 		vkFreeMemory(device, stagingBuffer.memory, nullptr);
 	}
 
+	// Prepare the uniform allocator with one region per command buffer that holds the vertex shader uniform block
 	void prepareUniformBuffers()
 	{
-		VK_CHECK_RESULT(vulkanDevice->createBuffer(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &uniformBuffer, sizeof(UniformData)));
-		VK_CHECK_RESULT(uniformBuffer.map());
-
-		updateUniformBuffer();
+		uniformAllocator.destroy();
+		uniformAllocator.create(vulkanDevice, static_cast<uint32_t>(drawCmdBuffers.size()), sizeof(UniformData));
+		uniformSlot = uniformAllocator.reserve(sizeof(UniformData));
 	}
 
 	void updateUniformBuffer()
@@ -418,7 +436,7 @@ public:
 			uniformData.globSpeed += frameTimer * 0.01f;
 		}
 
-		memcpy(uniformBuffer.mapped, &uniformData, sizeof(uniformData));
+		uniformAllocator.write(uniformSlot, uniformData);
 	}
 
 	void prepare()
@@ -436,6 +454,8 @@ public:
 	void draw()
 	{
 		VulkanExampleBase::prepareFrame();
+		// The uniform allocator's region for the acquired image has been selected by prepareFrame
+		updateUniformBuffer();
 		submitInfo.commandBufferCount = 1;
 		submitInfo.pCommandBuffers = &drawCmdBuffers[currentBuffer];
 		VK_CHECK_RESULT(vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE));
@@ -448,7 +468,6 @@ public:
 		{
 			return;
 		}
-		updateUniformBuffer();
 		draw();
 	}
 
@@ -105,8 +105,6 @@ public:
 			// Use mesh and task shader to draw the scene
 			vkCmdDrawMeshTasksEXT(drawCmdBuffers[i], 1, 1, 1);
 
-			drawUI(drawCmdBuffers[i]);
-
 			vkCmdEndRenderPass(drawCmdBuffers[i]);
 
 			VK_CHECK_RESULT(vkEndCommandBuffer(drawCmdBuffers[i]));
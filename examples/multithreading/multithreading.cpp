@@ -39,7 +39,6 @@ public:
 	// Secondary scene command buffers used to store backdrop and user interface
 	struct SecondaryCommandBuffers {
 		VkCommandBuffer background{ VK_NULL_HANDLE };
-		VkCommandBuffer ui{ VK_NULL_HANDLE };
 	} secondaryCommandBuffers;
 
 	// Number of animated objects to be renderer
@@ -109,7 +108,7 @@ public:
 #endif
 		threadPool.setThreadCount(numThreads);
 		numObjectsPerThread = 512 / numThreads;
-		rndEngine.seed(benchmark.active ? 0 : (unsigned)time(nullptr));
+		rndEngine.seed(settings.deterministic ? 0 : (unsigned)time(nullptr));
 	}
 
 	~VulkanExample()
@@ -145,10 +144,9 @@ public:
 				1);
 		VK_CHECK_RESULT(vkAllocateCommandBuffers(device, &cmdBufAllocateInfo, &primaryCommandBuffer));
 
-		// Create additional secondary CBs for background and ui
+		// Create an additional secondary CB for the background
 		cmdBufAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
 		VK_CHECK_RESULT(vkAllocateCommandBuffers(device, &cmdBufAllocateInfo, &secondaryCommandBuffers.background));
-		VK_CHECK_RESULT(vkAllocateCommandBuffers(device, &cmdBufAllocateInfo, &secondaryCommandBuffers.ui));
 
 		threadData.resize(numThreads);
 
@@ -299,24 +297,6 @@ public:
 		models.starSphere.draw(secondaryCommandBuffers.background);
 		
 		VK_CHECK_RESULT(vkEndCommandBuffer(secondaryCommandBuffers.background));
-
-		/*
-			User interface
-
-			With VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS, the primary command buffer's content has to be defined
-			by secondary command buffers, which also applies to the UI overlay command buffer
-		*/
-
-		VK_CHECK_RESULT(vkBeginCommandBuffer(secondaryCommandBuffers.ui, &commandBufferBeginInfo));
-
-		vkCmdSetViewport(secondaryCommandBuffers.ui, 0, 1, &viewport);
-		vkCmdSetScissor(secondaryCommandBuffers.ui, 0, 1, &scissor);
-
-		vkCmdBindPipeline(secondaryCommandBuffers.ui, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines.starsphere);
-
-		drawUI(secondaryCommandBuffers.ui);
-
-		VK_CHECK_RESULT(vkEndCommandBuffer(secondaryCommandBuffers.ui));
 	}
 
 	// Updates the secondary command buffers using a thread pool
@@ -387,11 +367,6 @@ public:
 			}
 		}
 
-		// Render ui last
-		if (ui.visible) {
-			commandBuffers.push_back(secondaryCommandBuffers.ui);
-		}
-
 		// Execute render commands from the secondary command buffer
 		vkCmdExecuteCommands(primaryCommandBuffer, static_cast<uint32_t>(commandBuffers.size()), commandBuffers.data());
 
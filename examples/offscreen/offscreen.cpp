@@ -385,8 +385,6 @@ public:
 					models.example.draw(drawCmdBuffers[i]);
 				}
 
-				drawUI(drawCmdBuffers[i]);
-
 				vkCmdEndRenderPass(drawCmdBuffers[i]);
 			}
 
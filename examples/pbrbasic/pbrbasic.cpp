@@ -186,8 +186,6 @@ public:
 				}
 			}
 
-			drawUI(drawCmdBuffers[i]);  //  UI
-
 			vkCmdEndRenderPass(drawCmdBuffers[i]);  // Ⱦͨ
 
 			VK_CHECK_RESULT(vkEndCommandBuffer(drawCmdBuffers[i]));  // ¼
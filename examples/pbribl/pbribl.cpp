@@ -203,7 +203,6 @@ public:
 				models.objects[models.objectIndex].draw(drawCmdBuffers[i]);
 
 			}
-			drawUI(drawCmdBuffers[i]);
 
 			vkCmdEndRenderPass(drawCmdBuffers[i]);
 
@@ -21,7 +21,8 @@ public:
 		glm::mat4 modelView;
 		glm::vec4 lightPos{ 0.0f, 2.0f, 1.0f, 0.0f };
 	} uniformData;
-	vks::Buffer uniformBuffer;
+	// Written to the base class' uniform allocator, which has a copy of the slot for each command buffer
+	vks::UniformAllocator::Slot uniformSlot;
 
 	VkPipelineLayout pipelineLayout{ VK_NULL_HANDLE };
 	VkDescriptorSet descriptorSet{ VK_NULL_HANDLE };
@@ -55,8 +56,6 @@ public:
 
 			vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
 			vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
-
-			uniformBuffer.destroy();
 		}
 	}
 
@@ -76,6 +75,12 @@ public:
 
 	void buildCommandBuffers()
 	{
+		// Recreating the swap chain may change the number of command buffers, the uniform allocator needs a region for each of them
+		if (uniformAllocator.getFrameCount() != drawCmdBuffers.size()) {
+			prepareUniformBuffers();
+			updateUniformDescriptors();
+		}
+
 		VkCommandBufferBeginInfo cmdBufInfo = vks::initializers::commandBufferBeginInfo();
 
 		VkClearValue clearValues[2];
@@ -105,7 +110,9 @@ public:
 			VkRect2D scissor = vks::initializers::rect2D(width, height,	0, 0);
 			vkCmdSetScissor(drawCmdBuffers[i], 0, 1, &scissor);
 
-			vkCmdBindDescriptorSets(drawCmdBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descriptorSet, 0, NULL);
+			// The dynamic offset selects the uniform data of the frame this command buffer is used for
+			const uint32_t dynamicOffset = uniformAllocator.getOffset(uniformSlot, i);
+			vkCmdBindDescriptorSets(drawCmdBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descriptorSet, 1, &dynamicOffset);
 			scene.bindBuffers(drawCmdBuffers[i]);
 
 			// Left : Render the scene using the solid colored pipeline with phong shading
@@ -133,8 +140,6 @@ public:
 				scene.draw(drawCmdBuffers[i]);
 			}
 
-			drawUI(drawCmdBuffers[i]);
-
 			vkCmdEndRenderPass(drawCmdBuffers[i]);
 
 			VK_CHECK_RESULT(vkEndCommandBuffer(drawCmdBuffers[i]));
@@ -151,7 +156,7 @@ public:
 	{
 		// Pool
 		std::vector<VkDescriptorPoolSize> poolSizes = {
-			vks::initializers::descriptorPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1)
+			vks::initializers::descriptorPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1)
 		};
 		VkDescriptorPoolCreateInfo descriptorPoolInfo = vks::initializers::descriptorPoolCreateInfo(poolSizes, 2);
 		VK_CHECK_RESULT(vkCreateDescriptorPool(device, &descriptorPoolInfo, nullptr, &descriptorPool));
@@ -159,7 +164,7 @@ public:
 		// Layout
 		std::vector<VkDescriptorSetLayoutBinding> setLayoutBindings = {
 			// Binding 0 : Vertex shader uniform buffer
-			vks::initializers::descriptorSetLayoutBinding(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_VERTEX_BIT, 0)
+			vks::initializers::descriptorSetLayoutBinding(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, VK_SHADER_STAGE_VERTEX_BIT, 0)
 		};
 		VkDescriptorSetLayoutCreateInfo descriptorLayout = vks::initializers::descriptorSetLayoutCreateInfo(setLayoutBindings);
 		VK_CHECK_RESULT(vkCreateDescriptorSetLayout(device, &descriptorLayout, nullptr, &descriptorSetLayout));
@@ -167,10 +172,16 @@ public:
 		// Set
 		VkDescriptorSetAllocateInfo allocInfo = vks::initializers::descriptorSetAllocateInfo(descriptorPool, &descriptorSetLayout, 1);
 		VK_CHECK_RESULT(vkAllocateDescriptorSets(device, &allocInfo, &descriptorSet));
+		updateUniformDescriptors();
+	}
 
+	// Points the descriptor at the uniform allocator's buffer, which changes whenever the allocator is recreated
+	void updateUniformDescriptors()
+	{
+		VkDescriptorBufferInfo uniformDescriptor = uniformAllocator.getDescriptor(sizeof(UniformData));
 		std::vector<VkWriteDescriptorSet> writeDescriptorSets = {
 			// Binding 0 : Vertex shader uniform buffer
-			vks::initializers::writeDescriptorSet(descriptorSet, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 0, &uniformBuffer.descriptor)
+			vks::initializers::writeDescriptorSet(descriptorSet, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 0, &uniformDescriptor)
 		};
 		vkUpdateDescriptorSets(device, static_cast<uint32_t>(writeDescriptorSets.size()), writeDescriptorSets.data(), 0, nullptr);
 	}
@@ -244,13 +255,12 @@ public:
 		}
 	}
 
-	// Prepare and initialize uniform buffer containing shader uniforms
+	// Prepare the uniform allocator with one region per command buffer that holds the vertex shader uniform block
 	void prepareUniformBuffers()
 	{
-		// Create the vertex shader uniform buffer block
-		VK_CHECK_RESULT(vulkanDevice->createBuffer(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &uniformBuffer, sizeof(UniformData)));
-		// Map persistent
-		VK_CHECK_RESULT(uniformBuffer.map());
+		uniformAllocator.destroy();
+		uniformAllocator.create(vulkanDevice, static_cast<uint32_t>(drawCmdBuffers.size()), sizeof(UniformData));
+		uniformSlot = uniformAllocator.reserve(sizeof(UniformData));
 	}
 
 	void updateUniformBuffers()
@@ -259,7 +269,7 @@ public:
 		camera.setPerspective(60.0f, (float)(width / 3.0f) / (float)height, 0.1f, 256.0f);
 		uniformData.projection = camera.matrices.perspective;
 		uniformData.modelView = camera.matrices.view;
-		memcpy(uniformBuffer.mapped, &uniformData, sizeof(UniformData));
+		uniformAllocator.write(uniformSlot, uniformData);
 	}
 
 	void prepare()
@@ -276,6 +286,8 @@ public:
 	void draw()
 	{
 		VulkanExampleBase::prepareFrame();
+		// The uniform allocator's region for the acquired image has been selected by prepareFrame
+		updateUniformBuffers();
 		submitInfo.commandBufferCount = 1;
 		submitInfo.pCommandBuffers = &drawCmdBuffers[currentBuffer];
 		VK_CHECK_RESULT(vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE));
@@ -286,7 +298,6 @@ public:
 	{
 		if (!prepared)
 			return;
-		updateUniformBuffers();
 		draw();
 	}
 
@@ -1,7 +1,7 @@
 /*
  * Vulkan Example - Rendering a glTF model using hardware accelerated ray tracing example (for proper transparency, this sample does frame accumulation)
  *
- * Copyright (C) 2023-2024 by Sascha Willems - www.saschawillems.de
+ * Copyright (C) 2023-2025 by Sascha Willems - www.saschawillems.de
  *
  * This code is licensed under the MIT license (MIT) (http://opensource.org/licenses/MIT)
  */
@@ -13,13 +13,28 @@
 class VulkanExample : public VulkanRaytracingSample
 {
 public:
-	AccelerationStructure bottomLevelAS{};
-	AccelerationStructure topLevelAS{};
+	// The model is placed twice in the scene, once with a static BLAS that is compacted and once with a BLAS that is refitted for an animated exploded view
+	// Both BLAS contain one geometry per glTF primitive in the same order, so the shaders can look up geometry nodes with gl_GeometryIndexEXT for either of them
+	struct BLASHandles {
+		uint32_t staticModel{ 0 };
+		uint32_t animatedModel{ 0 };
+	} blasHandles;
+	// Owned by the acceleration structure manager of the base class
+	VkAccelerationStructureKHR topLevelAS{ VK_NULL_HANDLE };
 
 	vks::Buffer vertexBuffer;
 	vks::Buffer indexBuffer;
 	uint32_t indexCount{ 0 };
 	vks::Buffer transformBuffer;
+	struct GeometryTransform {
+		glm::mat4 matrix;
+		glm::vec3 explodeDirection;
+	};
+	std::vector<GeometryTransform> geometryTransforms;
+
+	// Animates an exploded view of the second model by changing its geometry transforms and refitting its BLAS every frame
+	bool animate{ false };
+	float explodeDistance{ 0.1f };
 	
 	struct GeometryNode {
 		uint64_t vertexBufferDeviceAddress;
@@ -60,7 +75,7 @@ public:
 		camera.type = Camera::CameraType::lookat;
 		camera.setPerspective(60.0f, (float)width / (float)height, 0.1f, 512.0f);
 		camera.setRotation(glm::vec3(0.0f, 0.0f, 0.0f));
-		camera.setTranslation(glm::vec3(0.0f, -0.1f, -1.0f));
+		camera.setTranslation(glm::vec3(0.0f, -0.1f, -1.25f));
 		
 		enableExtensions();
 
@@ -78,8 +93,6 @@ public:
 			vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
 			vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
 			deleteStorageImage();
-			deleteAccelerationStructure(bottomLevelAS);
-			deleteAccelerationStructure(topLevelAS);
 			vertexBuffer.destroy();
 			indexBuffer.destroy();
 			transformBuffer.destroy();
@@ -91,111 +104,101 @@ public:
 		}
 	}
 
-	void createAccelerationStructureBuffer(AccelerationStructure &accelerationStructure, VkAccelerationStructureBuildSizesInfoKHR buildSizeInfo)
-	{
-		VkBufferCreateInfo bufferCreateInfo{};
-		bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-		bufferCreateInfo.size = buildSizeInfo.accelerationStructureSize;
-		bufferCreateInfo.usage = VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
-		VK_CHECK_RESULT(vkCreateBuffer(device, &bufferCreateInfo, nullptr, &accelerationStructure.buffer));
-		VkMemoryRequirements memoryRequirements{};
-		vkGetBufferMemoryRequirements(device, accelerationStructure.buffer, &memoryRequirements);
-		VkMemoryAllocateFlagsInfo memoryAllocateFlagsInfo{};
-		memoryAllocateFlagsInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
-		memoryAllocateFlagsInfo.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT_KHR;
-		VkMemoryAllocateInfo memoryAllocateInfo{};
-		memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-		memoryAllocateInfo.pNext = &memoryAllocateFlagsInfo;
-		memoryAllocateInfo.allocationSize = memoryRequirements.size;
-		memoryAllocateInfo.memoryTypeIndex = vulkanDevice->getMemoryType(memoryRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-		VK_CHECK_RESULT(vkAllocateMemory(device, &memoryAllocateInfo, nullptr, &accelerationStructure.memory));
-		VK_CHECK_RESULT(vkBindBufferMemory(device, accelerationStructure.buffer, accelerationStructure.memory, 0));
-	}
-
 	/*
-		Create the bottom level acceleration structure that contains the scene's actual geometry (vertices, triangles)
+		Create the bottom level acceleration structures containing all of the glTF model's primitives as geometries
+		Both are built in a single batch by the acceleration structure manager of the base class, which compacts the static one
+		and refits the animated one (if animation is enabled)
 	*/
-	void createBottomLevelAccelerationStructure()
+	void createBottomLevelAccelerationStructures()
 	{
 		// Use transform matrices from the glTF nodes
-		std::vector<VkTransformMatrixKHR> transformMatrices{};
+		// The direction from the center of the model to the center of each primitive is used to animate an exploded view of the model
+		glm::vec3 modelCenter{ 0.0f };
 		for (auto node : model.linearNodes) {
 			if (node->mesh) {
 				for (auto primitive : node->mesh->primitives) {
 					if (primitive->indexCount > 0) {
-						VkTransformMatrixKHR transformMatrix{};
-						auto m = glm::mat3x4(glm::transpose(node->getMatrix()));
-						memcpy(&transformMatrix, (void*)&m, sizeof(glm::mat3x4));
-						transformMatrices.push_back(transformMatrix);
+						GeometryTransform geometryTransform{};
+						geometryTransform.matrix = node->getMatrix();
+						geometryTransform.explodeDirection = glm::vec3(geometryTransform.matrix * glm::vec4(primitive->dimensions.center, 1.0f));
+						modelCenter += geometryTransform.explodeDirection;
+						geometryTransforms.push_back(geometryTransform);
 					}
 				}
 			}
 		}
+		modelCenter /= static_cast<float>(std::max(geometryTransforms.size(), size_t(1)));
+		for (auto& geometryTransform : geometryTransforms) {
+			const glm::vec3 direction = geometryTransform.explodeDirection - modelCenter;
+			geometryTransform.explodeDirection = (glm::length(direction) > 0.0f) ? glm::normalize(direction) : glm::vec3(0.0f);
+		}
 
-		// Transform buffer
+		// Transform buffer with the transforms of the static model followed by those of the animated model
+		// It stays mapped so the transforms of the animated model can be changed for refits
 		VK_CHECK_RESULT(vulkanDevice->createBuffer(
 			VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR,
 			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
 			&transformBuffer,
-			static_cast<uint32_t>(transformMatrices.size()) * sizeof(VkTransformMatrixKHR),
-			transformMatrices.data()));
-		
-		// Build
-		// One geometry per glTF node, so we can index materials using gl_GeometryIndexEXT
-		uint32_t maxPrimCount{ 0 };
-		std::vector<uint32_t> maxPrimitiveCounts{};
+			static_cast<uint32_t>(geometryTransforms.size()) * 2 * sizeof(VkTransformMatrixKHR)));
+		VK_CHECK_RESULT(transformBuffer.map());
+		writeGeometryTransforms(0, 0.0f);
+		writeGeometryTransforms(static_cast<uint32_t>(geometryTransforms.size()), 0.0f);
+
+		// One geometry per glTF primitive, so we can index materials using gl_GeometryIndexEXT
+		std::vector<GeometryNode> geometryNodes{};
 		std::vector<VkAccelerationStructureGeometryKHR> geometries{};
 		std::vector<VkAccelerationStructureBuildRangeInfoKHR> buildRangeInfos{};
-		std::vector<VkAccelerationStructureBuildRangeInfoKHR*> pBuildRangeInfos{};
-		std::vector<GeometryNode> geometryNodes{};
 		for (auto node : model.linearNodes) {
-			if (node->mesh) {
-				for (auto primitive : node->mesh->primitives) {
-					if (primitive->indexCount > 0) {
-						VkDeviceOrHostAddressConstKHR vertexBufferDeviceAddress{};
-						VkDeviceOrHostAddressConstKHR indexBufferDeviceAddress{};
-						VkDeviceOrHostAddressConstKHR transformBufferDeviceAddress{};
-
-						vertexBufferDeviceAddress.deviceAddress = getBufferDeviceAddress(model.vertices.buffer);// +primitive->firstVertex * sizeof(vkglTF::Vertex);
-						indexBufferDeviceAddress.deviceAddress = getBufferDeviceAddress(model.indices.buffer) + primitive->firstIndex * sizeof(uint32_t);
-						transformBufferDeviceAddress.deviceAddress = getBufferDeviceAddress(transformBuffer.buffer) + static_cast<uint32_t>(geometryNodes.size()) * sizeof(VkTransformMatrixKHR);
-
-						VkAccelerationStructureGeometryKHR geometry{};
-						geometry.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR;
-						geometry.geometryType = VK_GEOMETRY_TYPE_TRIANGLES_KHR;
-						geometry.geometry.triangles.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_TRIANGLES_DATA_KHR;
-						geometry.geometry.triangles.vertexFormat = VK_FORMAT_R32G32B32_SFLOAT;
-						geometry.geometry.triangles.vertexData = vertexBufferDeviceAddress;
-						geometry.geometry.triangles.maxVertex = model.vertices.count;
-						//geometry.geometry.triangles.maxVertex = primitive->vertexCount;
-						geometry.geometry.triangles.vertexStride = sizeof(vkglTF::Vertex);
-						geometry.geometry.triangles.indexType = VK_INDEX_TYPE_UINT32;
-						geometry.geometry.triangles.indexData = indexBufferDeviceAddress;
-						geometry.geometry.triangles.transformData = transformBufferDeviceAddress;
-						geometries.push_back(geometry);
-						maxPrimitiveCounts.push_back(primitive->indexCount / 3);
-						maxPrimCount += primitive->indexCount / 3;
-
-						VkAccelerationStructureBuildRangeInfoKHR buildRangeInfo{};
-						buildRangeInfo.firstVertex = 0;
-						buildRangeInfo.primitiveOffset = 0; // primitive->firstIndex * sizeof(uint32_t);
-						buildRangeInfo.primitiveCount = primitive->indexCount / 3;
-						buildRangeInfo.transformOffset = 0;
-						buildRangeInfos.push_back(buildRangeInfo);
-
-						GeometryNode geometryNode{};
-						geometryNode.vertexBufferDeviceAddress = vertexBufferDeviceAddress.deviceAddress;
-						geometryNode.indexBufferDeviceAddress = indexBufferDeviceAddress.deviceAddress;
-						geometryNode.textureIndexBaseColor = primitive->material.baseColorTexture->index;
-						geometryNode.textureIndexOcclusion = primitive->material.occlusionTexture ? primitive->material.occlusionTexture->index : -1;
-						geometryNodes.push_back(geometryNode);
-					}
+			if (!node->mesh) {
+				continue;
+			}
+			for (auto primitive : node->mesh->primitives) {
+				if (primitive->indexCount > 0) {
+					VkDeviceOrHostAddressConstKHR vertexBufferDeviceAddress{};
+					VkDeviceOrHostAddressConstKHR indexBufferDeviceAddress{};
+					VkDeviceOrHostAddressConstKHR transformBufferDeviceAddress{};
+
+					vertexBufferDeviceAddress.deviceAddress = getBufferDeviceAddress(model.vertices.buffer);
+					indexBufferDeviceAddress.deviceAddress = getBufferDeviceAddress(model.indices.buffer) + primitive->firstIndex * sizeof(uint32_t);
+					transformBufferDeviceAddress.deviceAddress = getBufferDeviceAddress(transformBuffer.buffer) + static_cast<uint32_t>(geometryNodes.size()) * sizeof(VkTransformMatrixKHR);
+
+					VkAccelerationStructureGeometryKHR geometry{};
+					geometry.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR;
+					geometry.geometryType = VK_GEOMETRY_TYPE_TRIANGLES_KHR;
+					geometry.geometry.triangles.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_TRIANGLES_DATA_KHR;
+					geometry.geometry.triangles.vertexFormat = VK_FORMAT_R32G32B32_SFLOAT;
+					geometry.geometry.triangles.vertexData = vertexBufferDeviceAddress;
+					geometry.geometry.triangles.maxVertex = model.vertices.count;
+					geometry.geometry.triangles.vertexStride = sizeof(vkglTF::Vertex);
+					geometry.geometry.triangles.indexType = VK_INDEX_TYPE_UINT32;
+					geometry.geometry.triangles.indexData = indexBufferDeviceAddress;
+					geometry.geometry.triangles.transformData = transformBufferDeviceAddress;
+					geometries.push_back(geometry);
+
+					VkAccelerationStructureBuildRangeInfoKHR buildRangeInfo{};
+					buildRangeInfo.firstVertex = 0;
+					buildRangeInfo.primitiveOffset = 0;
+					buildRangeInfo.primitiveCount = primitive->indexCount / 3;
+					buildRangeInfo.transformOffset = 0;
+					buildRangeInfos.push_back(buildRangeInfo);
+
+					GeometryNode geometryNode{};
+					geometryNode.vertexBufferDeviceAddress = vertexBufferDeviceAddress.deviceAddress;
+					geometryNode.indexBufferDeviceAddress = indexBufferDeviceAddress.deviceAddress;
+					geometryNode.textureIndexBaseColor = primitive->material.baseColorTexture->index;
+					geometryNode.textureIndexOcclusion = primitive->material.occlusionTexture ? primitive->material.occlusionTexture->index : -1;
+					geometryNodes.push_back(geometryNode);
 				}
 			}
 		}
-		for (auto& rangeInfo : buildRangeInfos) {
-			pBuildRangeInfos.push_back(&rangeInfo);
+		// Compaction typically saves a lot of memory, so it's used for the static model
+		blasHandles.staticModel = accelerationStructureManager.addBLAS(geometries, buildRangeInfos, VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR | VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_COMPACTION_BIT_KHR);
+		// The animated model uses the same geometries with the second half of the transform buffer
+		// Allowing updates is required for refits, such a BLAS can't be compacted
+		for (auto& geometry : geometries) {
+			geometry.geometry.triangles.transformData.deviceAddress += geometryTransforms.size() * sizeof(VkTransformMatrixKHR);
 		}
+		blasHandles.animatedModel = accelerationStructureManager.addBLAS(geometries, buildRangeInfos, VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR | VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR);
 
 		vks::Buffer stagingBuffer;
 
@@ -215,168 +218,54 @@ public:
 		vulkanDevice->copyBuffer(&stagingBuffer, &geometryNodesBuffer, queue);
 
 		stagingBuffer.destroy();
-	
-		// Get size info
-		VkAccelerationStructureBuildGeometryInfoKHR accelerationStructureBuildGeometryInfo{};
-		accelerationStructureBuildGeometryInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
-		accelerationStructureBuildGeometryInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR;
-		accelerationStructureBuildGeometryInfo.flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR;
-		accelerationStructureBuildGeometryInfo.geometryCount = static_cast<uint32_t>(geometries.size());
-		accelerationStructureBuildGeometryInfo.pGeometries = geometries.data();
-		
-		const uint32_t numTriangles = maxPrimitiveCounts[0];
-
-		VkAccelerationStructureBuildSizesInfoKHR accelerationStructureBuildSizesInfo{};
-		accelerationStructureBuildSizesInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_SIZES_INFO_KHR;
-		vkGetAccelerationStructureBuildSizesKHR(
-			device,
-			VK_ACCELERATION_STRUCTURE_BUILD_TYPE_DEVICE_KHR,
-			&accelerationStructureBuildGeometryInfo,
-			maxPrimitiveCounts.data(),
-			&accelerationStructureBuildSizesInfo);
-
-		createAccelerationStructureBuffer(bottomLevelAS, accelerationStructureBuildSizesInfo);
-
-		VkAccelerationStructureCreateInfoKHR accelerationStructureCreateInfo{};
-		accelerationStructureCreateInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_CREATE_INFO_KHR;
-		accelerationStructureCreateInfo.buffer = bottomLevelAS.buffer;
-		accelerationStructureCreateInfo.size = accelerationStructureBuildSizesInfo.accelerationStructureSize;
-		accelerationStructureCreateInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR;
-		vkCreateAccelerationStructureKHR(device, &accelerationStructureCreateInfo, nullptr, &bottomLevelAS.handle);
-
-		// Create a small scratch buffer used during build of the bottom level acceleration structure
-		ScratchBuffer scratchBuffer = createScratchBuffer(accelerationStructureBuildSizesInfo.buildScratchSize);
-
-		accelerationStructureBuildGeometryInfo.mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
-		accelerationStructureBuildGeometryInfo.dstAccelerationStructure = bottomLevelAS.handle;
-		accelerationStructureBuildGeometryInfo.scratchData.deviceAddress = scratchBuffer.deviceAddress;
-
-		const VkAccelerationStructureBuildRangeInfoKHR* buildOffsetInfo = buildRangeInfos.data();
-
-		// Build the acceleration structure on the device via a one-time command buffer submission
-		// Some implementations may support acceleration structure building on the host (VkPhysicalDeviceAccelerationStructureFeaturesKHR->accelerationStructureHostCommands), but we prefer device builds
-		VkCommandBuffer commandBuffer = vulkanDevice->createCommandBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
-		vkCmdBuildAccelerationStructuresKHR(
-			commandBuffer,
-			1,
-			&accelerationStructureBuildGeometryInfo,
-			pBuildRangeInfos.data());
-		vulkanDevice->flushCommandBuffer(commandBuffer, queue);
-
-		VkAccelerationStructureDeviceAddressInfoKHR accelerationDeviceAddressInfo{};
-		accelerationDeviceAddressInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_DEVICE_ADDRESS_INFO_KHR;
-		accelerationDeviceAddressInfo.accelerationStructure = bottomLevelAS.handle;
-		bottomLevelAS.deviceAddress = vkGetAccelerationStructureDeviceAddressKHR(device, &accelerationDeviceAddressInfo);
-
-		deleteScratchBuffer(scratchBuffer);
+
+		// Build both BLAS on the device in one batch sharing the scratch arena, then compact the static one
+		accelerationStructureManager.buildBLAS();
 	}
 
 	/*
-		The top level acceleration structure contains the scene's object instances
+		The top level acceleration structure contains one instance of the static and one of the animated model next to each other
 	*/
 	void createTopLevelAccelerationStructure()
 	{
-		// We flip the matrix [1][1] = -1.0f to accomodate for the glTF up vector
-		VkTransformMatrixKHR transformMatrix = {
-			1.0f, 0.0f, 0.0f, 0.0f,
-			0.0f, -1.0f, 0.0f, 0.0f,
-			0.0f, 0.0f, 1.0f, 0.0f };
-
-		VkAccelerationStructureInstanceKHR instance{};
-		instance.transform = transformMatrix;
-		instance.instanceCustomIndex = 0;
-		instance.mask = 0xFF;
-		instance.instanceShaderBindingTableRecordOffset = 0;
-		instance.flags = VK_GEOMETRY_INSTANCE_TRIANGLE_FACING_CULL_DISABLE_BIT_KHR;
-		instance.accelerationStructureReference = bottomLevelAS.deviceAddress;
-
-		// Buffer for instance data
-		vks::Buffer instancesBuffer;
-		VK_CHECK_RESULT(vulkanDevice->createBuffer(
-			VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR,
-			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-			&instancesBuffer,
-			sizeof(VkAccelerationStructureInstanceKHR),
-			&instance));
-
-		VkDeviceOrHostAddressConstKHR instanceDataDeviceAddress{};
-		instanceDataDeviceAddress.deviceAddress = getBufferDeviceAddress(instancesBuffer.buffer);
-
-		VkAccelerationStructureGeometryKHR accelerationStructureGeometry{};
-		accelerationStructureGeometry.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR;
-		accelerationStructureGeometry.geometryType = VK_GEOMETRY_TYPE_INSTANCES_KHR;
-		accelerationStructureGeometry.flags = VK_GEOMETRY_OPAQUE_BIT_KHR;
-		accelerationStructureGeometry.geometry.instances.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_INSTANCES_DATA_KHR;
-		accelerationStructureGeometry.geometry.instances.arrayOfPointers = VK_FALSE;
-		accelerationStructureGeometry.geometry.instances.data = instanceDataDeviceAddress;
-
-		// Get size info
-		/*
-		The pSrcAccelerationStructure, dstAccelerationStructure, and mode members of pBuildInfo are ignored. Any VkDeviceOrHostAddressKHR members of pBuildInfo are ignored by this command, except that the hostAddress member of VkAccelerationStructureGeometryTrianglesDataKHR::transformData will be examined to check if it is NULL.*
-		*/
-		VkAccelerationStructureBuildGeometryInfoKHR accelerationStructureBuildGeometryInfo{};
-		accelerationStructureBuildGeometryInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
-		accelerationStructureBuildGeometryInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR;
-		accelerationStructureBuildGeometryInfo.flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR;
-		accelerationStructureBuildGeometryInfo.geometryCount = 1;
-		accelerationStructureBuildGeometryInfo.pGeometries = &accelerationStructureGeometry;
-
-		uint32_t primitive_count = 1;
-
-		VkAccelerationStructureBuildSizesInfoKHR accelerationStructureBuildSizesInfo{};
-		accelerationStructureBuildSizesInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_SIZES_INFO_KHR;
-		vkGetAccelerationStructureBuildSizesKHR(
-			device, 
-			VK_ACCELERATION_STRUCTURE_BUILD_TYPE_DEVICE_KHR,
-			&accelerationStructureBuildGeometryInfo,
-			&primitive_count,
-			&accelerationStructureBuildSizesInfo);
-
-		createAccelerationStructureBuffer(topLevelAS, accelerationStructureBuildSizesInfo);
-
-		VkAccelerationStructureCreateInfoKHR accelerationStructureCreateInfo{};
-		accelerationStructureCreateInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_CREATE_INFO_KHR;
-		accelerationStructureCreateInfo.buffer = topLevelAS.buffer;
-		accelerationStructureCreateInfo.size = accelerationStructureBuildSizesInfo.accelerationStructureSize;
-		accelerationStructureCreateInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR;
-		vkCreateAccelerationStructureKHR(device, &accelerationStructureCreateInfo, nullptr, &topLevelAS.handle);
-
-		// Create a small scratch buffer used during build of the top level acceleration structure
-		ScratchBuffer scratchBuffer = createScratchBuffer(accelerationStructureBuildSizesInfo.buildScratchSize);
-
-		VkAccelerationStructureBuildGeometryInfoKHR accelerationBuildGeometryInfo{};
-		accelerationBuildGeometryInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
-		accelerationBuildGeometryInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR;
-		accelerationBuildGeometryInfo.flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR;
-		accelerationBuildGeometryInfo.mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
-		accelerationBuildGeometryInfo.dstAccelerationStructure = topLevelAS.handle;
-		accelerationBuildGeometryInfo.geometryCount = 1;
-		accelerationBuildGeometryInfo.pGeometries = &accelerationStructureGeometry;
-		accelerationBuildGeometryInfo.scratchData.deviceAddress = scratchBuffer.deviceAddress;
-
-		VkAccelerationStructureBuildRangeInfoKHR accelerationStructureBuildRangeInfo{};
-		accelerationStructureBuildRangeInfo.primitiveCount = 1;
-		accelerationStructureBuildRangeInfo.primitiveOffset = 0;
-		accelerationStructureBuildRangeInfo.firstVertex = 0;
-		accelerationStructureBuildRangeInfo.transformOffset = 0;
-		std::vector<VkAccelerationStructureBuildRangeInfoKHR*> accelerationBuildStructureRangeInfos = { &accelerationStructureBuildRangeInfo };
-
-		// Build the acceleration structure on the device via a one-time command buffer submission
-		// Some implementations may support acceleration structure building on the host (VkPhysicalDeviceAccelerationStructureFeaturesKHR->accelerationStructureHostCommands), but we prefer device builds
-		VkCommandBuffer commandBuffer = vulkanDevice->createCommandBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
-		vkCmdBuildAccelerationStructuresKHR(
-			commandBuffer,
-			1,
-			&accelerationBuildGeometryInfo,
-			accelerationBuildStructureRangeInfos.data());
-		vulkanDevice->flushCommandBuffer(commandBuffer, queue);
-
-		VkAccelerationStructureDeviceAddressInfoKHR accelerationDeviceAddressInfo{};
-		accelerationDeviceAddressInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_DEVICE_ADDRESS_INFO_KHR;
-		accelerationDeviceAddressInfo.accelerationStructure = topLevelAS.handle;
-
-		deleteScratchBuffer(scratchBuffer);
-		instancesBuffer.destroy();
+		const std::array<uint32_t, 2> instanceBlasHandles = { blasHandles.staticModel, blasHandles.animatedModel };
+		const std::array<float, 2> instanceOffsets = { -0.25f, 0.25f };
+
+		std::vector<VkAccelerationStructureInstanceKHR> instances{};
+		for (size_t i = 0; i < instanceBlasHandles.size(); i++) {
+			// We flip the matrix [1][1] = -1.0f to accomodate for the glTF up vector
+			VkTransformMatrixKHR transformMatrix = {
+				1.0f, 0.0f, 0.0f, instanceOffsets[i],
+				0.0f, -1.0f, 0.0f, 0.0f,
+				0.0f, 0.0f, 1.0f, 0.0f };
+
+			VkAccelerationStructureInstanceKHR instance{};
+			instance.transform = transformMatrix;
+			instance.instanceCustomIndex = 0;
+			instance.mask = 0xFF;
+			instance.instanceShaderBindingTableRecordOffset = 0;
+			instance.flags = VK_GEOMETRY_INSTANCE_TRIANGLE_FACING_CULL_DISABLE_BIT_KHR;
+			instance.accelerationStructureReference = accelerationStructureManager.getBLASDeviceAddress(instanceBlasHandles[i]);
+			instances.push_back(instance);
+		}
+
+		accelerationStructureManager.setInstances(instances);
+		accelerationStructureManager.buildTLAS();
+		topLevelAS = accelerationStructureManager.getTLAS();
+	}
+
+	/*
+		Writes the per geometry transforms for the given explode factor to the transform buffer starting at the given matrix index,
+		a BLAS using them needs to be refitted afterwards
+	*/
+	void writeGeometryTransforms(uint32_t firstMatrix, float explodeFactor)
+	{
+		VkTransformMatrixKHR* transformMatrices = static_cast<VkTransformMatrixKHR*>(transformBuffer.mapped) + firstMatrix;
+		for (size_t i = 0; i < geometryTransforms.size(); i++) {
+			glm::mat4 matrix = glm::translate(glm::mat4(1.0f), geometryTransforms[i].explodeDirection * explodeDistance * explodeFactor) * geometryTransforms[i].matrix;
+			auto m = glm::mat3x4(glm::transpose(matrix));
+			memcpy(&transformMatrices[i], (void*)&m, sizeof(glm::mat3x4));
+		}
 	}
 
 	/*
@@ -549,7 +438,7 @@ public:
 
 		VkWriteDescriptorSetAccelerationStructureKHR descriptorAccelerationStructureInfo = vks::initializers::writeDescriptorSetAccelerationStructureKHR();
 		descriptorAccelerationStructureInfo.accelerationStructureCount = 1;
-		descriptorAccelerationStructureInfo.pAccelerationStructures = &topLevelAS.handle;
+		descriptorAccelerationStructureInfo.pAccelerationStructures = &topLevelAS;
 
 		VkWriteDescriptorSet accelerationStructureWrite{};
 		accelerationStructureWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
@@ -643,6 +532,12 @@ public:
 		{
 			VK_CHECK_RESULT(vkBeginCommandBuffer(drawCmdBuffers[i], &cmdBufInfo));
 
+			if (animate) {
+				// Refit the animated model's BLAS to the geometry transforms written on the host, the TLAS then needs to be rebuilt for the new BLAS bounds
+				accelerationStructureManager.recordRefit(drawCmdBuffers[i], { blasHandles.animatedModel });
+				accelerationStructureManager.recordTLASBuild(drawCmdBuffers[i]);
+			}
+
 			/*
 				Dispatch the ray tracing commands
 			*/
@@ -704,8 +599,6 @@ public:
 				VK_IMAGE_LAYOUT_GENERAL,
 				subresourceRange);
 
-			drawUI(drawCmdBuffers[i], frameBuffers[i]);
-
 			VK_CHECK_RESULT(vkEndCommandBuffer(drawCmdBuffers[i]));
 		}
 	}
@@ -760,7 +653,7 @@ public:
 		loadAssets();
 
 		// Create the acceleration structures used to render the ray traced scene
-		createBottomLevelAccelerationStructure();
+		createBottomLevelAccelerationStructures();
 		createTopLevelAccelerationStructure();
 
 		createStorageImage(swapChain.colorFormat, { width, height, 1 });
@@ -785,13 +678,32 @@ public:
 	{
 		if (!prepared)
 			return;
+		if (animate && !paused) {
+			writeGeometryTransforms(static_cast<uint32_t>(geometryTransforms.size()), 0.5f - 0.5f * cos(timer * 2.0f * glm::pi<float>()));
+		}
 		updateUniformBuffers();
-		if (camera.updated) {
-			// If the camera's view has been updated we reset the frame accumulation
+		if (camera.updated || animate) {
+			// If the camera's view or the geometry has been updated we reset the frame accumulation
 			uniformData.frame = -1;
 		}
 		draw();
 	}
+
+	virtual void OnUpdateUIOverlay(vks::UIOverlay *overlay)
+	{
+		if (overlay->header("Settings")) {
+			overlay->checkBox("Animate (BLAS refit)", &animate);
+		}
+		if (overlay->header("Acceleration structures")) {
+			const auto& statistics = accelerationStructureManager.statistics;
+			overlay->text("BLAS: %d in %d build batch(es)", statistics.blasCount, statistics.batchCount);
+			overlay->text("Before compaction: %.1f KB", statistics.memoryBeforeCompaction / 1024.0f);
+			overlay->text("After compaction: %.1f KB", statistics.memoryAfterCompaction / 1024.0f);
+			overlay->text("Scratch arena: %.1f KB", statistics.scratchArenaSize / 1024.0f);
+			overlay->text("Refit scratch: %.1f KB", statistics.updateScratchSize / 1024.0f);
+			overlay->text("TLAS: %.1f KB", statistics.tlasSize / 1024.0f);
+		}
+	}
 };
 
 VULKAN_EXAMPLE_MAIN()
@@ -0,0 +1,231 @@
+# Copyright (C) 2025 by Sascha Willems - www.saschawillems.de
+# This code is licensed under the MIT license (MIT) (http://opensource.org/licenses/MIT)
+
+# Renders a fixed frame of every example without a window and compares it against reference images
+# Examples run with --headless, which uses fixed random seeds and a fixed frame time, so the same build on the same Vulkan implementation renders the same images
+# Reference images depend on the implementation, a software implementation like lavapipe gives results that can be shared between machines
+# Usage:
+#   regression.py --bin build/bin --update    Stores the current output as reference images
+#   regression.py --bin build/bin             Compares the current output against the reference images
+
+import argparse
+import json
+import math
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+from concurrent.futures import ProcessPoolExecutor
+
+parser = argparse.ArgumentParser(description='Compare the output of all examples against reference images')
+parser.add_argument('--bin', type=str, default='build/bin', help='directory containing the example executables')
+parser.add_argument('--reference', type=str, default='regression/reference', help='directory containing the reference images')
+parser.add_argument('--output', type=str, default='regression/output', help='directory the rendered frames and difference images are written to')
+parser.add_argument('--update', action='store_true', help='store the rendered frames as new reference images instead of comparing them')
+parser.add_argument('--examples', type=str, help='comma separated list of examples to run (defaults to all executables in the bin directory)')
+parser.add_argument('--exclude', type=str, default='', help='comma separated list of examples to skip')
+parser.add_argument('--jobs', type=int, default=os.cpu_count(), help='number of examples run at the same time')
+parser.add_argument('--frames', type=int, default=5, help='number of frames to render, the last one is compared')
+parser.add_argument('--width', type=int, default=320, help='width of the rendered frames')
+parser.add_argument('--height', type=int, default=240, help='height of the rendered frames')
+parser.add_argument('--timeout', type=int, default=120, help='time in seconds an example may take before it is counted as failed')
+parser.add_argument('--rmse', type=float, default=2.0, help='maximum root mean square error of any color channel (0..255)')
+parser.add_argument('--perceptual', type=float, default=0.01, help='maximum mean perceptual error (0..1)')
+parser.add_argument('--args', type=str, default='', help='additional arguments passed to all examples')
+args = parser.parse_args()
+
+# Examples that don't present images
+non_presenting = ['renderheadless', 'computeheadless']
+
+# Examples exit through vks::tools::exitFatal with one of these results if the device lacks a required extension or feature
+# The exit status only keeps the low byte on POSIX, while Windows reports the full 32 bit value
+VK_ERROR_EXTENSION_NOT_PRESENT = -7
+VK_ERROR_FEATURE_NOT_PRESENT = -8
+unsupported_exit_codes = set(code & mask for code in (VK_ERROR_EXTENSION_NOT_PRESENT, VK_ERROR_FEATURE_NOT_PRESENT) for mask in (0xff, 0xffffffff))
+
+def lastLine(process):
+    output = process.stdout.decode(errors='replace').strip().splitlines()
+    return output[-1] if output else ''
+
+def exitStatus(process):
+    # A negative return code is the signal that terminated the process (POSIX only)
+    if process.returncode < 0:
+        return 'terminated by signal %d' % -process.returncode
+    return 'exit code %d' % process.returncode
+
+def readPPM(filename):
+    with open(filename, 'rb') as file:
+        data = file.read()
+    # Header is "P6", width, height and maximum value separated by whitespace, followed by a single whitespace and the pixel data
+    fields = []
+    pos = 0
+    while len(fields) < 4:
+        while data[pos:pos + 1].isspace():
+            pos += 1
+        start = pos
+        while not data[pos:pos + 1].isspace():
+            pos += 1
+        fields.append(data[start:pos])
+    if fields[0] != b'P6' or int(fields[3]) != 255:
+        raise ValueError('%s is not an 8 bit binary PPM image' % filename)
+    width, height = int(fields[1]), int(fields[2])
+    return width, height, data[pos + 1:pos + 1 + width * height * 3]
+
+def writePPM(filename, width, height, pixels):
+    with open(filename, 'wb') as file:
+        file.write(b'P6\n%d\n%d\n255\n' % (width, height))
+        file.write(bytes(pixels))
+
+# sRGB encoded 8 bit values to CIELAB (D65), with the lookup table removing the sRGB encoding
+srgb_to_linear = [(c / 12.92) if c <= 0.04045 else ((c + 0.055) / 1.055) ** 2.4 for c in [i / 255.0 for i in range(256)]]
+
+def labf(t):
+    return t ** (1.0 / 3.0) if t > 0.008856 else (7.787 * t + 16.0 / 116.0)
+
+def toLab(pixels, count):
+    lab = [None] * count
+    for i in range(count):
+        r = srgb_to_linear[pixels[i * 3]]
+        g = srgb_to_linear[pixels[i * 3 + 1]]
+        b = srgb_to_linear[pixels[i * 3 + 2]]
+        x = labf((0.4124 * r + 0.3576 * g + 0.1805 * b) / 0.95047)
+        y = labf(0.2126 * r + 0.7152 * g + 0.0722 * b)
+        z = labf((0.0193 * r + 0.1192 * g + 0.9505 * b) / 1.08883)
+        lab[i] = (116.0 * y - 16.0, 500.0 * (x - y), 200.0 * (y - z))
+    return lab
+
+def blur(values, width, height):
+    # 3x3 binomial filter as a cheap stand-in for the contrast sensitivity filtering of FLIP, so single pixel noise counts less than structured differences
+    weights = [1, 2, 1]
+    result = [None] * (width * height)
+    for y in range(height):
+        for x in range(width):
+            acc = [0.0, 0.0, 0.0]
+            total = 0
+            for dy in (-1, 0, 1):
+                sy = min(max(y + dy, 0), height - 1)
+                for dx in (-1, 0, 1):
+                    sx = min(max(x + dx, 0), width - 1)
+                    w = weights[dy + 1] * weights[dx + 1]
+                    v = values[sy * width + sx]
+                    acc[0] += v[0] * w
+                    acc[1] += v[1] * w
+                    acc[2] += v[2] * w
+                    total += w
+            result[y * width + x] = (acc[0] / total, acc[1] / total, acc[2] / total)
+    return result
+
+def gradient(lab, width, height, x, y):
+    left = lab[y * width + max(x - 1, 0)][0]
+    right = lab[y * width + min(x + 1, width - 1)][0]
+    up = lab[max(y - 1, 0) * width + x][0]
+    down = lab[min(y + 1, height - 1) * width + x][0]
+    return math.hypot(right - left, down - up) * 0.5
+
+def heatColor(error):
+    # Black over red and yellow to white
+    error = min(max(error, 0.0), 1.0)
+    return (int(min(error * 3.0, 1.0) * 255), int(min(max(error * 3.0 - 1.0, 0.0), 1.0) * 255), int(min(max(error * 3.0 - 2.0, 0.0), 1.0) * 255))
+
+def compare(width, height, reference, test):
+    """Returns the per channel root mean square errors, the mean and maximum perceptual error and the per pixel perceptual errors"""
+    count = width * height
+    squared = [0.0, 0.0, 0.0]
+    for i in range(count * 3):
+        d = reference[i] - test[i]
+        squared[i % 3] += d * d
+    rmse = [math.sqrt(s / count) for s in squared]
+    # FLIP style error: color differences of the filtered images, amplified where edges differ between the images
+    ref_lab = blur(toLab(reference, count), width, height)
+    test_lab = blur(toLab(test, count), width, height)
+    errors = [0.0] * count
+    for y in range(height):
+        for x in range(width):
+            i = y * width + x
+            a, b = ref_lab[i], test_lab[i]
+            color = min(math.sqrt((a[0] - b[0]) ** 2 + (a[1] - b[1]) ** 2 + (a[2] - b[2]) ** 2) / 100.0, 1.0)
+            feature = min(abs(gradient(ref_lab, width, height, x, y) - gradient(test_lab, width, height, x, y)) / 50.0, 1.0)
+            errors[i] = color ** (1.0 - feature) if color > 0.0 else 0.0
+    return rmse, sum(errors) / count, max(errors), errors
+
+def run(example):
+    """Renders and compares one example, runs in a separate process"""
+    result = {'example': example, 'status': 'passed', 'message': ''}
+    bin_dir = os.path.abspath(args.bin)
+    executable = os.path.join(bin_dir, example)
+    frame_dir = tempfile.mkdtemp(prefix=example + '_')
+    try:
+        command = [executable, '--headless', '-hf', str(args.frames), '-df', frame_dir, '-dfm', 'ppm', '-w', str(args.width), '-h', str(args.height)] + args.args.split()
+        try:
+            process = subprocess.run(command, cwd=bin_dir, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, timeout=args.timeout)
+        except subprocess.TimeoutExpired:
+            return dict(result, status='failed', message='timed out after %d seconds' % args.timeout)
+        if process.returncode in unsupported_exit_codes:
+            return dict(result, status='skipped', message=lastLine(process) or exitStatus(process))
+        if process.returncode != 0:
+            # Crashes, failed asserts and all other errors
+            output = lastLine(process)
+            return dict(result, status='failed', message=exitStatus(process) + (': ' + output if output else ''))
+        frame = os.path.join(frame_dir, 'frame_%05d.ppm' % (args.frames - 1))
+        if not os.path.exists(frame):
+            return dict(result, status='failed', message='no frame written')
+        shutil.copy(frame, os.path.join(args.output, example + '.ppm'))
+        reference = os.path.join(args.reference, example + '.ppm')
+        if args.update:
+            shutil.copy(frame, reference)
+            return dict(result, status='updated')
+        if not os.path.exists(reference):
+            return dict(result, status='new', message='no reference image')
+        ref_width, ref_height, ref_pixels = readPPM(reference)
+        width, height, pixels = readPPM(frame)
+        if (ref_width, ref_height) != (width, height):
+            return dict(result, status='failed', message='size %dx%d differs from reference %dx%d' % (width, height, ref_width, ref_height))
+        if ref_pixels == pixels:
+            return dict(result, message='identical')
+        rmse, perceptual_mean, perceptual_max, errors = compare(width, height, ref_pixels, pixels)
+        result.update({'rmse': rmse, 'perceptual_mean': perceptual_mean, 'perceptual_max': perceptual_max})
+        result['message'] = 'rmse %.2f/%.2f/%.2f, perceptual mean %.4f max %.4f' % (rmse[0], rmse[1], rmse[2], perceptual_mean, perceptual_max)
+        if max(rmse) > args.rmse or perceptual_mean > args.perceptual:
+            result['status'] = 'failed'
+        if max(rmse) > 0.0:
+            heatmap = []
+            for error in errors:
+                heatmap.extend(heatColor(error))
+            writePPM(os.path.join(args.output, example + '_diff.ppm'), width, height, heatmap)
+        return result
+    finally:
+        shutil.rmtree(frame_dir, ignore_errors=True)
+
+if __name__ == '__main__':
+    if not os.path.isdir(args.bin):
+        sys.exit('Could not find bin directory %s' % args.bin)
+    os.makedirs(args.output, exist_ok=True)
+    os.makedirs(args.reference, exist_ok=True)
+
+    excluded = set(non_presenting + [name.strip() for name in args.exclude.split(',') if name.strip()])
+    if args.examples:
+        examples = [name.strip() for name in args.examples.split(',') if name.strip()]
+    else:
+        examples = []
+        for file in sorted(os.listdir(args.bin)):
+            name, extension = os.path.splitext(file)
+            path = os.path.join(args.bin, file)
+            if os.path.isfile(path) and os.access(path, os.X_OK) and extension in ('', '.exe'):
+                examples.append(name)
+    examples = [example for example in examples if example not in excluded]
+
+    results = []
+    with ProcessPoolExecutor(max_workers=max(args.jobs, 1)) as executor:
+        for result in executor.map(run, examples):
+            print('%-40s %-8s %s' % (result['example'], result['status'], result['message']))
+            results.append(result)
+
+    with open(os.path.join(args.output, 'results.json'), 'w') as file:
+        json.dump(results, file, indent=2)
+
+    counts = {}
+    for result in results:
+        counts[result['status']] = counts.get(result['status'], 0) + 1
+    print(', '.join('%d %s' % (count, status) for status, count in sorted(counts.items())))
+    sys.exit(1 if counts.get('failed', 0) > 0 else 0)
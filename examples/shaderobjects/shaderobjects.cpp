@@ -376,9 +376,6 @@ public:
 			vkCmdBindShadersEXT(drawCmdBuffers[i], 2, stages, shaders);
 			scene.draw(drawCmdBuffers[i]);
 
-			// @todo: Currently disabled, the UI needs to be adopated to work with shader objects
-			// drawUI(drawCmdBuffers[i]);
-
 			// End dynamic rendering
 			vkCmdEndRenderingKHR(drawCmdBuffers[i]);
 
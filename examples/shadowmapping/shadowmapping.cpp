@@ -348,8 +348,6 @@ public:
 					scenes[sceneIndex].draw(drawCmdBuffers[i]);
 				}
 
-				drawUI(drawCmdBuffers[i]);
-
 				vkCmdEndRenderPass(drawCmdBuffers[i]);
 			}
 
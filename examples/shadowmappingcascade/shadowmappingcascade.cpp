@@ -15,6 +15,10 @@
 
 	A further optimization could be done using a geometry shader to do a single-pass render for the depth map
 	cascades instead of multiple passes (geometry shaders are not supported on all target devices).
+
+	To reduce the cost of the shadow pass, cascades are cached: Their projections are snapped to shadow map texels,
+	so a cascade only needs to be rendered again if its snapped projection changes, with far cascades allowed to lag
+	behind for a few frames. Shadow casters are culled against each cascade.
 */
 
 #include "vulkanexamplebase.h"
@@ -35,6 +39,19 @@ public:
 	int32_t displayDepthMapCascadeIndex = 0;
 	bool colorCascades = false;
 	bool filterPCF = false;
+	// Only render cascades if their projection changed
+	bool cacheCascades = true;
+	// Cull shadow casters against the bounds of each cascade
+	bool cullCasters = true;
+	// Number of frames a cascade may keep using its last rendered projection before it has to be updated (near to far)
+	const std::array<uint32_t, SHADOW_MAP_CASCADE_COUNT> cascadeUpdateIntervals = { 1, 1, 2, 4 };
+
+	// Shadow pass statistics of the last recorded frame
+	struct ShadowStatistics {
+		uint32_t cascadesRendered{ 0 };
+		uint32_t castersDrawn{ 0 };
+		uint32_t castersCulled{ 0 };
+	} shadowStatistics;
 
 	float cascadeSplitLambda = 0.95f;
 
@@ -111,6 +128,12 @@ public:
 		VkImageView view;
 		float splitDepth;
 		glm::mat4 viewProjMatrix;
+		// Matrix the cascade was last rendered with, this is the one passed to the shaders
+		glm::mat4 cachedViewProjMatrix{ 1.0f };
+		uint32_t framesSinceUpdate{ 0 };
+		bool valid{ false };
+		// Set if the cascade needs to be rendered in the current frame
+		bool update{ true };
 		void destroy(VkDevice device) {
 			vkDestroyImageView(device, view, nullptr);
 			vkDestroyFramebuffer(device, frameBuffer, nullptr);
@@ -163,11 +186,30 @@ public:
 		enabledFeatures.depthClamp = deviceFeatures.depthClamp;
 	}
 
+	/*
+		Checks if the bounding sphere of a tree overlaps the light space bounds of a cascade
+		Casters in front of the cascade's near plane are kept, as they can still cast shadows into the cascade (depth clamp)
+	*/
+	bool casterInCascade(const glm::mat4& viewProjMatrix, const glm::vec3& position)
+	{
+		const glm::vec4 center = viewProjMatrix * glm::vec4(position + models.tree.dimensions.center, 1.0f);
+		for (uint32_t axis = 0; axis < 3; axis++) {
+			// The projection is orthographic, so the radius scales with the length of the matrix row
+			const float radius = models.tree.dimensions.radius * glm::length(glm::vec3(viewProjMatrix[0][axis], viewProjMatrix[1][axis], viewProjMatrix[2][axis]));
+			const float minBound = (axis < 2) ? -1.0f : -FLT_MAX;
+			if ((center[axis] - radius > 1.0f) || (center[axis] + radius < minBound)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
 	/*
 		Render the example scene to acommand buffer using the supplied pipeline layout and for the selected shadow cascade index
 		Used by the scene rendering and depth pass generation command buffer
+		If a cull matrix is passed, shadow casters outside of it are skipped
 	*/
-	void renderScene(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, uint32_t cascadeIndex = 0) {
+	void renderScene(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, uint32_t cascadeIndex = 0, const glm::mat4* cullMatrix = nullptr) {
 		// We use push constants for passing shadow cascade info to the shaders
 		PushConstBlock pushConstBlock = { glm::vec4(0.0f), cascadeIndex };
 
@@ -188,6 +230,13 @@ public:
 		};
 
 		for (auto& position : positions) {
+			if (cullMatrix) {
+				if (!casterInCascade(*cullMatrix, position)) {
+					shadowStatistics.castersCulled++;
+					continue;
+				}
+				shadowStatistics.castersDrawn++;
+			}
 			pushConstBlock.position = glm::vec4(position, 0.0f);
 			vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PushConstBlock), &pushConstBlock);
 			// This will also bind the texture images to set 1
@@ -333,12 +382,23 @@ public:
 		VK_CHECK_RESULT(vkCreateSampler(device, &sampler, nullptr, &depth.sampler));
 	}
 
+	/*
+		Command buffers are recorded every frame, as the cascades to update and the shadow casters to draw can change from frame to frame
+	*/
 	void buildCommandBuffers()
+	{
+		for (int32_t i = 0; i < drawCmdBuffers.size(); i++) {
+			buildCommandBuffer(i);
+		}
+	}
+
+	void buildCommandBuffer(uint32_t i)
 	{
 		VkCommandBufferBeginInfo cmdBufInfo = vks::initializers::commandBufferBeginInfo();
 
-		for (int32_t i = 0; i < drawCmdBuffers.size(); i++) {
+		shadowStatistics = {};
 
+		{
 			VK_CHECK_RESULT(vkBeginCommandBuffer(drawCmdBuffers[i], &cmdBufInfo));
 
 			/*
@@ -366,13 +426,17 @@ public:
 				VkRect2D scissor = vks::initializers::rect2D(SHADOWMAP_DIM, SHADOWMAP_DIM, 0, 0);
 				vkCmdSetScissor(drawCmdBuffers[i], 0, 1, &scissor);
 
-				// One pass per cascade
+				// One pass per cascade, cached cascades keep the content of their last update
 				for (uint32_t j = 0; j < SHADOW_MAP_CASCADE_COUNT; j++) {
+					if (!cascades[j].update) {
+						continue;
+					}
 					renderPassBeginInfo.framebuffer = cascades[j].frameBuffer;
 					vkCmdBeginRenderPass(drawCmdBuffers[i], &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
 					vkCmdBindPipeline(drawCmdBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, depthPass.pipeline);
-					renderScene(drawCmdBuffers[i], depthPass.pipelineLayout, j);
+					renderScene(drawCmdBuffers[i], depthPass.pipelineLayout, j, cullCasters ? &cascades[j].cachedViewProjMatrix : nullptr);
 					vkCmdEndRenderPass(drawCmdBuffers[i]);
+					shadowStatistics.cascadesRendered++;
 				}
 			}
 
@@ -421,8 +485,6 @@ public:
 				vkCmdBindPipeline(drawCmdBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, (filterPCF) ? pipelines.sceneShadowPCF : pipelines.sceneShadow);
 				renderScene(drawCmdBuffers[i], pipelineLayout);
 
-				drawUI(drawCmdBuffers[i]);
-
 				vkCmdEndRenderPass(drawCmdBuffers[i]);
 			}
 
@@ -678,6 +740,15 @@ public:
 			glm::vec3 minExtents = -maxExtents;
 
 			glm::vec3 lightDir = normalize(-lightPos);
+
+			// Snap the cascade center to shadow map texels in light space, so the projection only changes in whole texel steps
+			// This avoids shimmering shadow edges when the camera moves and gives identical matrices for small camera movements
+			const float texelSize = (maxExtents.x - minExtents.x) / (float)SHADOWMAP_DIM;
+			glm::mat4 lightRotation = glm::lookAt(glm::vec3(0.0f), lightDir, glm::vec3(0.0f, 1.0f, 0.0f));
+			glm::vec3 lightSpaceCenter = glm::vec3(lightRotation * glm::vec4(frustumCenter, 1.0f));
+			lightSpaceCenter = glm::floor(lightSpaceCenter / texelSize) * texelSize;
+			frustumCenter = glm::vec3(glm::inverse(lightRotation) * glm::vec4(lightSpaceCenter, 1.0f));
+
 			glm::mat4 lightViewMatrix = glm::lookAt(frustumCenter - lightDir * -minExtents.z, frustumCenter, glm::vec3(0.0f, 1.0f, 0.0f));
 			glm::mat4 lightOrthoMatrix = glm::ortho(minExtents.x, maxExtents.x, minExtents.y, maxExtents.y, 0.0f, maxExtents.z - minExtents.z);
 
@@ -689,6 +760,31 @@ public:
 		}
 	}
 
+	/*
+		Select the cascades that need to be rendered in this frame
+		A cascade whose projection didn't change keeps its content, far cascades may keep using their last projection for a few frames
+	*/
+	void updateCascadeCache()
+	{
+		for (uint32_t i = 0; i < SHADOW_MAP_CASCADE_COUNT; i++) {
+			Cascade& cascade = cascades[i];
+			if (!cacheCascades || !cascade.valid) {
+				cascade.update = true;
+			} else if (cascade.viewProjMatrix != cascade.cachedViewProjMatrix) {
+				cascade.update = (cascade.framesSinceUpdate + 1 >= cascadeUpdateIntervals[i]);
+			} else {
+				cascade.update = false;
+			}
+			if (cascade.update) {
+				cascade.cachedViewProjMatrix = cascade.viewProjMatrix;
+				cascade.framesSinceUpdate = 0;
+				cascade.valid = true;
+			} else {
+				cascade.framesSinceUpdate++;
+			}
+		}
+	}
+
 	void updateLight()
 	{
 		float angle = glm::radians(timer * 360.0f);
@@ -703,7 +799,7 @@ public:
 		*/
 		std::vector<glm::mat4> cascadeViewProjMatrices(SHADOW_MAP_CASCADE_COUNT);
 		for (uint32_t i = 0; i < SHADOW_MAP_CASCADE_COUNT; i++) {
-			cascadeViewProjMatrices[i] = cascades[i].viewProjMatrix;
+			cascadeViewProjMatrices[i] = cascades[i].cachedViewProjMatrix;
 		}
 		memcpy(cascadeViewProjMatricesBuffer.mapped, cascadeViewProjMatrices.data(), sizeof(glm::mat4) * SHADOW_MAP_CASCADE_COUNT);
 
@@ -727,6 +823,7 @@ public:
 	void draw()
 	{
 		VulkanExampleBase::prepareFrame();
+		buildCommandBuffer(currentBuffer);
 		submitInfo.commandBufferCount = 1;
 		submitInfo.pCommandBuffers = &drawCmdBuffers[currentBuffer];
 		VK_CHECK_RESULT(vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE));
@@ -739,6 +836,7 @@ public:
 		loadAssets();
 		updateLight();
 		updateCascades();
+		updateCascadeCache();
 		prepareDepthPass();
 		prepareUniformBuffers();
 		setupLayoutsAndDescriptors();
@@ -751,21 +849,20 @@ public:
 	{
 		if (!prepared)
 			return;
-		draw();
 		if (!paused || camera.updated) {
 			updateLight();
-			updateCascades();
-			updateUniformBuffers();
 		}
+		// Cascades are updated every frame, the cache decides which of them need to be rendered again
+		updateCascades();
+		updateCascadeCache();
+		updateUniformBuffers();
+		draw();
 	}
 
 	virtual void OnUpdateUIOverlay(vks::UIOverlay *overlay)
 	{
 		if (overlay->header("Settings")) {
-			if (overlay->sliderFloat("Split lambda", &cascadeSplitLambda, 0.1f, 1.0f)) {
-				updateCascades();
-				updateUniformBuffers();
-			}
+			overlay->sliderFloat("Split lambda", &cascadeSplitLambda, 0.1f, 1.0f);
 			if (overlay->checkBox("Color cascades", &colorCascades)) {
 				updateUniformBuffers();
 			}
@@ -780,6 +877,12 @@ public:
 			if (overlay->checkBox("PCF filtering", &filterPCF)) {
 				buildCommandBuffers();
 			}
+			overlay->checkBox("Cache cascades", &cacheCascades);
+			overlay->checkBox("Cull shadow casters", &cullCasters);
+		}
+		if (overlay->header("Shadow pass")) {
+			overlay->text("Cascades rendered: %d / %d", shadowStatistics.cascadesRendered, SHADOW_MAP_CASCADE_COUNT);
+			overlay->text("Casters drawn: %d, culled: %d", shadowStatistics.castersDrawn, shadowStatistics.castersCulled);
 		}
 	}
 };
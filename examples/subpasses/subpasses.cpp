@@ -98,7 +98,6 @@ public:
 		camera.setPosition(glm::vec3(-3.2f, 1.0f, 5.9f));
 		camera.setRotation(glm::vec3(0.5f, 210.05f, 0.0f));
 		camera.setPerspective(60.0f, (float)width / (float)height, 0.1f, 256.0f);
-		ui.subpass = 2;
 	}
 
 	~VulkanExample()
@@ -499,8 +498,6 @@ public:
 				vks::debugutils::cmdEndLabel(drawCmdBuffers[i]);
 			}
 
-			drawUI(drawCmdBuffers[i]);
-
 			vkCmdEndRenderPass(drawCmdBuffers[i]);
 
 			VK_CHECK_RESULT(vkEndCommandBuffer(drawCmdBuffers[i]));
@@ -760,7 +757,7 @@ public:
 		};
 
 		std::random_device rndDevice;
-		std::default_random_engine rndGen(benchmark.active ? 0 : rndDevice());
+		std::default_random_engine rndGen(settings.deterministic ? 0 : rndDevice());
 		std::uniform_real_distribution<float> rndDist(-1.0f, 1.0f);
 		std::uniform_real_distribution<float> rndCol(0.0f, 0.5f);
 
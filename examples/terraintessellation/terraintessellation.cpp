@@ -325,8 +325,6 @@ public:
 				vkCmdEndQuery(drawCmdBuffers[i], queryPool, 0);
 			}
 
-			drawUI(drawCmdBuffers[i]);
-
 			vkCmdEndRenderPass(drawCmdBuffers[i]);
 
 			VK_CHECK_RESULT(vkEndCommandBuffer(drawCmdBuffers[i]));
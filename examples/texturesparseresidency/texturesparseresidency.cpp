@@ -516,8 +516,6 @@ void VulkanExample::buildCommandBuffers()
 		vkCmdBindPipeline(drawCmdBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
 		plane.draw(drawCmdBuffers[i]);
 
-		drawUI(drawCmdBuffers[i]);
-
 		vkCmdEndRenderPass(drawCmdBuffers[i]);
 
 		VK_CHECK_RESULT(vkEndCommandBuffer(drawCmdBuffers[i]));
@@ -714,7 +712,7 @@ void VulkanExample::fillRandomPages()
 {
 	vkDeviceWaitIdle(device);
 
-	std::default_random_engine rndEngine(benchmark.active ? 0 : std::random_device{}());
+	std::default_random_engine rndEngine(settings.deterministic ? 0 : std::random_device{}());
 	std::uniform_real_distribution<float> rndDist(0.0f, 1.0f);
 
 	std::vector<VirtualTexturePage> updatedPages;
@@ -810,7 +808,7 @@ void VulkanExample::flushRandomPages()
 {
 	vkDeviceWaitIdle(device);
 
-	std::default_random_engine rndEngine(benchmark.active ? 0 : std::random_device{}());
+	std::default_random_engine rndEngine(settings.deterministic ? 0 : std::random_device{}());
 	std::uniform_real_distribution<float> rndDist(0.0f, 1.0f);
 
 	std::vector<VirtualTexturePage> updatedPages;
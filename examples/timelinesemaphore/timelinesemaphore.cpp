@@ -1,14 +1,18 @@
 /*
 * Vulkan Example - Using timeline semaphores
 * 
-* Based on the compute n-nbody sample, this sample replaces multiple semaphores with a single timeline semaphore
+* Based on the compute n-nbody sample, this sample uses the async compute scheduler from the base library,
+* which synchronizes the compute and graphics queues with timeline semaphores and derives queue family ownership
+* transfers from the declared buffer dependencies. Compute for the next frame is submitted while the current frame
+* is still being drawn, and the achieved overlap is estimated from timestamp queries
 *
-* Copyright (C) 2024 by Sascha Willems - www.saschawillems.de
+* Copyright (C) 2024-2025 by Sascha Willems - www.saschawillems.de
 *
 * This code is licensed under the MIT license (MIT) (http://opensource.org/licenses/MIT)
 */
 
 #include "vulkanexamplebase.h"
+#include "VulkanAsyncCompute.h"
 
 #if defined(__ANDROID__)
 // Lower particle count on Android for performance reasons
@@ -31,11 +35,13 @@ public:
 		glm::vec4 vel;
 	};
 	uint32_t numParticles{ 0 };
+	// Simulation state, only accessed by the compute queue
 	vks::Buffer storageBuffer;
+	// Per frame in flight copies of the simulation state that are used as vertex buffers for rendering
+	std::array<vks::Buffer, 2> vertexBuffers;
 
 	// Resources for the graphics part of the example
 	struct Graphics {
-		uint32_t queueFamilyIndex;
 		VkDescriptorSetLayout descriptorSetLayout;
 		VkDescriptorSet descriptorSet;
 		VkPipelineLayout pipelineLayout;
@@ -50,12 +56,10 @@ public:
 
 	// Resources for the compute part of the example
 	struct Compute {
-		uint32_t queueFamilyIndex;
 		VkQueue queue;
-		VkCommandPool commandPool;
-		VkCommandBuffer commandBuffer;
 		VkDescriptorSetLayout descriptorSetLayout;
-		VkDescriptorSet descriptorSet;
+		// The uniform buffer is updated while the previous frame's compute workload may still be running, so there is one per frame in flight
+		std::array<VkDescriptorSet, 2> descriptorSets;
 		VkPipelineLayout pipelineLayout;
 		VkPipeline pipelineCalculate;
 		VkPipeline pipelineIntegrate;
@@ -66,15 +70,16 @@ public:
 			float power{ 0.75f };
 			float soften{ 0.05f };
 		} uniformData;
-		vks::Buffer uniformBuffer;
+		std::array<vks::Buffer, 2> uniformBuffers;
 	} compute{};
 
-	// Along with the actual semaphore we also need to track the increasing value of the timeline, 
-	// so we store both in a single struct
-	struct TimeLineSemaphore {
-		VkSemaphore handle{ VK_NULL_HANDLE };
-		uint64_t value{ 0 };
-	} timeLineSemaphore;
+	// The scheduler owns the timeline semaphores and the compute command buffers
+	vks::AsyncComputeScheduler scheduler;
+	struct SchedulerResources {
+		uint32_t particles;
+		uint32_t vertices;
+	} schedulerResources{};
+	uint64_t frameIndex{ 0 };
 
 	VkPhysicalDeviceTimelineSemaphoreFeaturesKHR enabledTimelineSemaphoreFeaturesKHR{};
 
@@ -99,7 +104,7 @@ public:
 	~VulkanExample()
 	{
 		if (device) {
-			vkDestroySemaphore(device, timeLineSemaphore.handle, nullptr);
+			scheduler.destroy();
 
 			// Graphics
 			graphics.uniformBuffer.destroy();
@@ -108,14 +113,18 @@ public:
 			vkDestroyDescriptorSetLayout(device, graphics.descriptorSetLayout, nullptr);
 
 			// Compute
-			compute.uniformBuffer.destroy();
+			for (auto& uniformBuffer : compute.uniformBuffers) {
+				uniformBuffer.destroy();
+			}
 			vkDestroyPipelineLayout(device, compute.pipelineLayout, nullptr);
 			vkDestroyDescriptorSetLayout(device, compute.descriptorSetLayout, nullptr);
 			vkDestroyPipeline(device, compute.pipelineCalculate, nullptr);
 			vkDestroyPipeline(device, compute.pipelineIntegrate, nullptr);
-			vkDestroyCommandPool(device, compute.commandPool, nullptr);
 
 			storageBuffer.destroy();
+			for (auto& vertexBuffer : vertexBuffers) {
+				vertexBuffer.destroy();
+			}
 
 			textures.particle.destroy();
 			textures.gradient.destroy();
@@ -128,7 +137,8 @@ public:
 		textures.gradient.loadFromFile(getAssetPath() + "textures/particle_gradient_rgba.ktx", VK_FORMAT_R8G8B8A8_UNORM, vulkanDevice, queue);
 	}
 
-	void buildCommandBuffers()
+	// Graphics commands are recorded per frame, as the vertex buffer written by compute alternates between frames in flight
+	void buildGraphicsCommandBuffer(VkCommandBuffer commandBuffer)
 	{
 		VkCommandBufferBeginInfo cmdBufInfo = vks::initializers::commandBufferBeginInfo();
 
@@ -144,128 +154,53 @@ public:
 		renderPassBeginInfo.renderArea.extent.height = height;
 		renderPassBeginInfo.clearValueCount = 2;
 		renderPassBeginInfo.pClearValues = clearValues;
+		renderPassBeginInfo.framebuffer = frameBuffers[currentBuffer];
 
-		for (int32_t i = 0; i < drawCmdBuffers.size(); ++i)
-		{
-			// Set target frame buffer
-			renderPassBeginInfo.framebuffer = frameBuffers[i];
+		VK_CHECK_RESULT(vkBeginCommandBuffer(commandBuffer, &cmdBufInfo));
 
-			VK_CHECK_RESULT(vkBeginCommandBuffer(drawCmdBuffers[i], &cmdBufInfo));
+		// Acquire barriers (if compute and graphics queue families differ) are inserted by the scheduler
+		scheduler.beginGraphics(commandBuffer, frameIndex);
 
-			// Acquire barrier
-			if (graphics.queueFamilyIndex != compute.queueFamilyIndex)
-			{
-				VkBufferMemoryBarrier buffer_barrier =
-				{
-					VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
-					nullptr,
-					0,
-					VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT,
-					compute.queueFamilyIndex,
-					graphics.queueFamilyIndex,
-					storageBuffer.buffer,
-					0,
-					storageBuffer.size
-				};
-
-				vkCmdPipelineBarrier(
-					drawCmdBuffers[i],
-					VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-					VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
-					0,
-					0, nullptr,
-					1, &buffer_barrier,
-					0, nullptr);
-			}
+		vkCmdBeginRenderPass(commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
 
-			// Draw the particle system using the update vertex buffer
-			vkCmdBeginRenderPass(drawCmdBuffers[i], &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+		VkViewport viewport = vks::initializers::viewport((float)width, (float)height, 0.0f, 1.0f);
+		vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
 
-			VkViewport viewport = vks::initializers::viewport((float)width, (float)height, 0.0f, 1.0f);
-			vkCmdSetViewport(drawCmdBuffers[i], 0, 1, &viewport);
+		VkRect2D scissor = vks::initializers::rect2D(width, height, 0, 0);
+		vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
 
-			VkRect2D scissor = vks::initializers::rect2D(width, height, 0, 0);
-			vkCmdSetScissor(drawCmdBuffers[i], 0, 1, &scissor);
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphics.pipeline);
+		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphics.pipelineLayout, 0, 1, &graphics.descriptorSet, 0, nullptr);
 
-			vkCmdBindPipeline(drawCmdBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, graphics.pipeline);
-			vkCmdBindDescriptorSets(drawCmdBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, graphics.pipelineLayout, 0, 1, &graphics.descriptorSet, 0, nullptr);
+		// Draw the particle system using the vertex buffer written by the compute workload of this frame
+		VkDeviceSize offsets[1] = { 0 };
+		VkBuffer vertexBuffer = scheduler.getBuffer(schedulerResources.vertices, frameIndex);
+		vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer, offsets);
+		vkCmdDraw(commandBuffer, numParticles, 1, 0, 0);
 
-			VkDeviceSize offsets[1] = { 0 };
-			vkCmdBindVertexBuffers(drawCmdBuffers[i], 0, 1, &storageBuffer.buffer, offsets);
-			vkCmdDraw(drawCmdBuffers[i], numParticles, 1, 0, 0);
+		vkCmdEndRenderPass(commandBuffer);
 
-			drawUI(drawCmdBuffers[i]);
-
-			vkCmdEndRenderPass(drawCmdBuffers[i]);
-
-			// Release barrier
-			if (graphics.queueFamilyIndex != compute.queueFamilyIndex)
-			{
-				VkBufferMemoryBarrier buffer_barrier =
-				{
-					VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
-					nullptr,
-					VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT,
-					0,
-					graphics.queueFamilyIndex,
-					compute.queueFamilyIndex,
-					storageBuffer.buffer,
-					0,
-					storageBuffer.size
-				};
-
-				vkCmdPipelineBarrier(
-					drawCmdBuffers[i],
-					VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
-					VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
-					0,
-					0, nullptr,
-					1, &buffer_barrier,
-					0, nullptr);
-			}
-
-			VK_CHECK_RESULT(vkEndCommandBuffer(drawCmdBuffers[i]));
-		}
+		// Release barriers are inserted by the scheduler
+		scheduler.endGraphics(commandBuffer, frameIndex);
 
+		VK_CHECK_RESULT(vkEndCommandBuffer(commandBuffer));
 	}
 
-	void buildComputeCommandBuffer()
+	// Compute commands are recorded per frame into a command buffer owned by the scheduler
+	void buildComputeCommandBuffer(uint64_t computeFrameIndex)
 	{
-		VkCommandBufferBeginInfo cmdBufInfo = vks::initializers::commandBufferBeginInfo();
-
-		VK_CHECK_RESULT(vkBeginCommandBuffer(compute.commandBuffer, &cmdBufInfo));
-
-		// Acquire barrier
-		if (graphics.queueFamilyIndex != compute.queueFamilyIndex)
-		{
-			VkBufferMemoryBarrier buffer_barrier =
-			{
-				VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
-				nullptr,
-				0,
-				VK_ACCESS_SHADER_WRITE_BIT,
-				graphics.queueFamilyIndex,
-				compute.queueFamilyIndex,
-				storageBuffer.buffer,
-				0,
-				storageBuffer.size
-			};
+		VkCommandBuffer commandBuffer = scheduler.beginCompute(computeFrameIndex);
+		const uint32_t slot = scheduler.getSlot(computeFrameIndex);
 
-			vkCmdPipelineBarrier(
-				compute.commandBuffer,
-				VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-				VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-				0,
-				0, nullptr,
-				1, &buffer_barrier,
-				0, nullptr);
-		}
+		// The compute workload that last used this slot has finished, so its uniform buffer can be updated
+		compute.uniformData.deltaT = paused ? 0.0f : frameTimer * 0.05f;
+		memcpy(compute.uniformBuffers[slot].mapped, &compute.uniformData, sizeof(Compute::UniformData));
 
 		// First pass: Calculate particle movement
 		// -------------------------------------------------------------------------------------------------------
-		vkCmdBindPipeline(compute.commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, compute.pipelineCalculate);
-		vkCmdBindDescriptorSets(compute.commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, compute.pipelineLayout, 0, 1, &compute.descriptorSet, 0, 0);
-		vkCmdDispatch(compute.commandBuffer, numParticles / 256, 1, 1);
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, compute.pipelineCalculate);
+		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, compute.pipelineLayout, 0, 1, &compute.descriptorSets[slot], 0, 0);
+		vkCmdDispatch(commandBuffer, numParticles / 256, 1, 1);
 
 		// Add memory barrier to ensure that the computer shader has finished writing to the buffer
 		VkBufferMemoryBarrier bufferBarrier = vks::initializers::bufferMemoryBarrier();
@@ -273,51 +208,22 @@ public:
 		bufferBarrier.size = storageBuffer.descriptor.range;
 		bufferBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
 		bufferBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-		// Transfer ownership if compute and graphics queue family indices differ
 		bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
 		bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-
-		vkCmdPipelineBarrier(
-			compute.commandBuffer,
-			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-			VK_FLAGS_NONE,
-			0, nullptr,
-			1, &bufferBarrier,
-			0, nullptr);
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_FLAGS_NONE, 0, nullptr, 1, &bufferBarrier, 0, nullptr);
 
 		// Second pass: Integrate particles
 		// -------------------------------------------------------------------------------------------------------
-		vkCmdBindPipeline(compute.commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, compute.pipelineIntegrate);
-		vkCmdDispatch(compute.commandBuffer, numParticles / 256, 1, 1);
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, compute.pipelineIntegrate);
+		vkCmdDispatch(commandBuffer, numParticles / 256, 1, 1);
 
-		// Release barrier
-		if (graphics.queueFamilyIndex != compute.queueFamilyIndex)
-		{
-			VkBufferMemoryBarrier buffer_barrier =
-			{
-				VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
-				nullptr,
-				VK_ACCESS_SHADER_WRITE_BIT,
-				0,
-				compute.queueFamilyIndex,
-				graphics.queueFamilyIndex,
-				storageBuffer.buffer,
-				0,
-				storageBuffer.size
-			};
+		// Copy the simulation state to this frame's vertex buffer, so the simulation of the next frame can start while this one is still being drawn
+		bufferBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_FLAGS_NONE, 0, nullptr, 1, &bufferBarrier, 0, nullptr);
+		VkBufferCopy copyRegion{ 0, 0, storageBuffer.size };
+		vkCmdCopyBuffer(commandBuffer, storageBuffer.buffer, scheduler.getBuffer(schedulerResources.vertices, computeFrameIndex), 1, &copyRegion);
 
-			vkCmdPipelineBarrier(
-				compute.commandBuffer,
-				VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-				VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
-				0,
-				0, nullptr,
-				1, &buffer_barrier,
-				0, nullptr);
-		}
-
-		vkEndCommandBuffer(compute.commandBuffer);
+		scheduler.endCompute(computeFrameIndex);
 	}
 
 	// Setup and fill the compute shader storage buffers containing the particles
@@ -338,7 +244,7 @@ public:
 		// Initial particle positions
 		std::vector<Particle> particleBuffer(numParticles);
 
-		std::default_random_engine rndEngine(benchmark.active ? 0 : (unsigned)time(nullptr));
+		std::default_random_engine rndEngine(settings.deterministic ? 0 : (unsigned)time(nullptr));
 		std::normal_distribution<float> rndDist(0.0f, 1.0f);
 
 		for (uint32_t i = 0; i < static_cast<uint32_t>(attractors.size()); i++)
@@ -381,39 +287,20 @@ public:
 		// Staging
 		vks::Buffer stagingBuffer;
 		vulkanDevice->createBuffer(VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &stagingBuffer, storageBufferSize, particleBuffer.data());
-		vulkanDevice->createBuffer(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &storageBuffer, storageBufferSize);
+		vulkanDevice->createBuffer(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &storageBuffer, storageBufferSize);
+		for (auto& vertexBuffer : vertexBuffers) {
+			vulkanDevice->createBuffer(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &vertexBuffer, storageBufferSize);
+		}
 
 		// Copy from staging buffer to storage buffer
-		VkCommandBuffer copyCmd = vulkanDevice->createCommandBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
+		// The upload is done on the compute queue, which is the only queue ever accessing the storage buffer, so no ownership transfer is required
+		VkCommandPool copyPool = vulkanDevice->createCommandPool(vulkanDevice->queueFamilyIndices.compute);
+		VkCommandBuffer copyCmd = vulkanDevice->createCommandBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, copyPool, true);
 		VkBufferCopy copyRegion = {};
 		copyRegion.size = storageBufferSize;
 		vkCmdCopyBuffer(copyCmd, stagingBuffer.buffer, storageBuffer.buffer, 1, &copyRegion);
-		// Execute a transfer barrier to the compute queue, if necessary
-		if (graphics.queueFamilyIndex != compute.queueFamilyIndex)
-		{
-			VkBufferMemoryBarrier buffer_barrier =
-			{
-				VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
-				nullptr,
-				VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT,
-				0,
-				graphics.queueFamilyIndex,
-				compute.queueFamilyIndex,
-				storageBuffer.buffer,
-				0,
-				storageBuffer.size
-			};
-
-			vkCmdPipelineBarrier(
-				copyCmd,
-				VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
-				VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
-				0,
-				0, nullptr,
-				1, &buffer_barrier,
-				0, nullptr);
-		}
-		vulkanDevice->flushCommandBuffer(copyCmd, queue, true);
+		vulkanDevice->flushCommandBuffer(copyCmd, compute.queue, copyPool, true);
+		vkDestroyCommandPool(device, copyPool, nullptr);
 
 		stagingBuffer.destroy();
 	}
@@ -426,11 +313,11 @@ public:
 
 		// Descriptor pool
 		std::vector<VkDescriptorPoolSize> poolSizes = {
-			vks::initializers::descriptorPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2),
-			vks::initializers::descriptorPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1),
+			vks::initializers::descriptorPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 3),
+			vks::initializers::descriptorPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2),
 			vks::initializers::descriptorPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 2)
 		};
-		VkDescriptorPoolCreateInfo descriptorPoolInfo = vks::initializers::descriptorPoolCreateInfo(poolSizes, 2);
+		VkDescriptorPoolCreateInfo descriptorPoolInfo = vks::initializers::descriptorPoolCreateInfo(poolSizes, 3);
 		VK_CHECK_RESULT(vkCreateDescriptorPool(device, &descriptorPoolInfo, nullptr, &descriptorPool));
 
 		// Descriptor layout
@@ -513,15 +400,14 @@ public:
 		blendAttachmentState.dstAlphaBlendFactor = VK_BLEND_FACTOR_DST_ALPHA;
 
 		VK_CHECK_RESULT(vkCreateGraphicsPipelines(device, pipelineCache, 1, &pipelineCreateInfo, nullptr, &graphics.pipeline));
-
-		buildCommandBuffers();
 	}
 
 	void prepareCompute()
 	{
-		vkGetDeviceQueue(device, compute.queueFamilyIndex, 0, &compute.queue);
-		vulkanDevice->createBuffer(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &compute.uniformBuffer, sizeof(Compute::UniformData));
-		VK_CHECK_RESULT(compute.uniformBuffer.map());
+		for (auto& uniformBuffer : compute.uniformBuffers) {
+			vulkanDevice->createBuffer(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &uniformBuffer, sizeof(Compute::UniformData));
+			VK_CHECK_RESULT(uniformBuffer.map());
+		}
 		std::vector<VkDescriptorSetLayoutBinding> setLayoutBindings = {
 			// Binding 0 : Particle position storage buffer
 			vks::initializers::descriptorSetLayoutBinding(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 0),
@@ -530,13 +416,15 @@ public:
 		};
 		VkDescriptorSetLayoutCreateInfo descriptorLayout = vks::initializers::descriptorSetLayoutCreateInfo(setLayoutBindings);
 		VK_CHECK_RESULT(vkCreateDescriptorSetLayout(device, &descriptorLayout, nullptr, &compute.descriptorSetLayout));
-		VkDescriptorSetAllocateInfo allocInfo = vks::initializers::descriptorSetAllocateInfo(descriptorPool, &compute.descriptorSetLayout, 1);
-		VK_CHECK_RESULT(vkAllocateDescriptorSets(device, &allocInfo, &compute.descriptorSet));
-		std::vector<VkWriteDescriptorSet> computeWriteDescriptorSets = {
-			vks::initializers::writeDescriptorSet(compute.descriptorSet, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 0, &storageBuffer.descriptor),
-			vks::initializers::writeDescriptorSet(compute.descriptorSet, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,1,&compute.uniformBuffer.descriptor)
-		};
-		vkUpdateDescriptorSets(device, static_cast<uint32_t>(computeWriteDescriptorSets.size()), computeWriteDescriptorSets.data(), 0, nullptr);
+		for (size_t i = 0; i < compute.descriptorSets.size(); i++) {
+			VkDescriptorSetAllocateInfo allocInfo = vks::initializers::descriptorSetAllocateInfo(descriptorPool, &compute.descriptorSetLayout, 1);
+			VK_CHECK_RESULT(vkAllocateDescriptorSets(device, &allocInfo, &compute.descriptorSets[i]));
+			std::vector<VkWriteDescriptorSet> computeWriteDescriptorSets = {
+				vks::initializers::writeDescriptorSet(compute.descriptorSets[i], VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 0, &storageBuffer.descriptor),
+				vks::initializers::writeDescriptorSet(compute.descriptorSets[i], VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, &compute.uniformBuffers[i].descriptor)
+			};
+			vkUpdateDescriptorSets(device, static_cast<uint32_t>(computeWriteDescriptorSets.size()), computeWriteDescriptorSets.data(), 0, nullptr);
+		}
 		VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo = vks::initializers::pipelineLayoutCreateInfo(&compute.descriptorSetLayout, 1);
 		VK_CHECK_RESULT(vkCreatePipelineLayout(device, &pipelineLayoutCreateInfo, nullptr, &compute.pipelineLayout));
 		VkComputePipelineCreateInfo computePipelineCreateInfo = vks::initializers::computePipelineCreateInfo(compute.pipelineLayout, 0);
@@ -548,19 +436,18 @@ public:
 		VK_CHECK_RESULT(vkCreateComputePipelines(device, pipelineCache, 1, &computePipelineCreateInfo, nullptr, &compute.pipelineCalculate));
 		computePipelineCreateInfo.stage = loadShader(getShadersPath() + "computenbody/particle_integrate.comp.spv", VK_SHADER_STAGE_COMPUTE_BIT);
 		VK_CHECK_RESULT(vkCreateComputePipelines(device, pipelineCache, 1, &computePipelineCreateInfo, nullptr, &compute.pipelineIntegrate));
-		VkCommandPoolCreateInfo cmdPoolInfo = {};
-		cmdPoolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-		cmdPoolInfo.queueFamilyIndex = compute.queueFamilyIndex;
-		cmdPoolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-		VK_CHECK_RESULT(vkCreateCommandPool(device, &cmdPoolInfo, nullptr, &compute.commandPool));
-		compute.commandBuffer = vulkanDevice->createCommandBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, compute.commandPool);
-		buildComputeCommandBuffer();
 	}
 
-	void updateComputeUniformBuffers()
+	// Declare the buffers shared between the workloads and how each queue accesses them
+	// The scheduler uses this to insert ownership transfers and semaphore waits
+	void prepareScheduler()
 	{
-		compute.uniformData.deltaT = paused ? 0.0f : frameTimer * 0.05f;
-		memcpy(compute.uniformBuffer.mapped, &compute.uniformData, sizeof(Compute::UniformData));
+		scheduler.prepare(vulkanDevice, queue, compute.queue, static_cast<uint32_t>(vertexBuffers.size()));
+		schedulerResources.particles = scheduler.addBuffer({ storageBuffer.buffer }, storageBuffer.size);
+		scheduler.declareAccess(schedulerResources.particles, vks::WorkloadQueue::Compute, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_READ_BIT);
+		schedulerResources.vertices = scheduler.addBuffer({ vertexBuffers[0].buffer, vertexBuffers[1].buffer }, vertexBuffers[0].size);
+		scheduler.declareAccess(schedulerResources.vertices, vks::WorkloadQueue::Compute, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+		scheduler.declareAccess(schedulerResources.vertices, vks::WorkloadQueue::Graphics, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT);
 	}
 
 	void updateGraphicsUniformBuffers()
@@ -574,101 +461,63 @@ public:
 	void prepare()
 	{
 		VulkanExampleBase::prepare();
-		graphics.queueFamilyIndex = vulkanDevice->queueFamilyIndices.graphics;
-		compute.queueFamilyIndex = vulkanDevice->queueFamilyIndices.compute;
-
-		// Setup the timeline semaphore
-		VkSemaphoreCreateInfo semaphoreCI{};
-		semaphoreCI.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
-		// It's a variation of the core semaphore type, creation is handled via an extension struture
-		VkSemaphoreTypeCreateInfoKHR semaphoreTypeCI{};
-		semaphoreTypeCI.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR;
-		semaphoreTypeCI.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
-		semaphoreTypeCI.initialValue = timeLineSemaphore.value;
-
-		semaphoreCI.pNext = &semaphoreTypeCI;
-		VK_CHECK_RESULT(vkCreateSemaphore(device, &semaphoreCI, nullptr, &timeLineSemaphore.handle));
-
+		// The VulkanDevice::createLogicalDevice functions finds a compute capable queue and prefers queue families that only support compute
+		vkGetDeviceQueue(device, vulkanDevice->queueFamilyIndices.compute, 0, &compute.queue);
 		loadAssets();
 		prepareStorageBuffers();
 		prepareGraphics();
 		prepareCompute();
+		prepareScheduler();
 		prepared = true;
 	}
 
 	void draw()
 	{
-		// Wait for rendering finished
-		VkPipelineStageFlags waitStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
-
-		// Submit compute commands
+		scheduler.beginFrame();
 
-		// Define incremental timeline sempahore states
-		const uint64_t graphics_finished = timeLineSemaphore.value;
-		const uint64_t compute_finished = timeLineSemaphore.value + 1;
-		const uint64_t all_finished = timeLineSemaphore.value + 2;
-
-		// With timeline semaphores, we can state on what value we want to wait on / signal on
-		VkTimelineSemaphoreSubmitInfoKHR timeLineSubmitInfo{ VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR };
-		timeLineSubmitInfo.waitSemaphoreValueCount = 1;
-		timeLineSubmitInfo.pWaitSemaphoreValues = &graphics_finished;
-		timeLineSubmitInfo.signalSemaphoreValueCount = 1;
-		timeLineSubmitInfo.pSignalSemaphoreValues = &compute_finished;
-
-		VkSubmitInfo computeSubmitInfo = vks::initializers::submitInfo();
-		computeSubmitInfo.commandBufferCount = 1;
-		computeSubmitInfo.pCommandBuffers = &compute.commandBuffer;
-		computeSubmitInfo.waitSemaphoreCount = 1;
-		computeSubmitInfo.pWaitSemaphores = &timeLineSemaphore.handle;
-		computeSubmitInfo.pWaitDstStageMask = &waitStageMask;
-		computeSubmitInfo.signalSemaphoreCount = 1;
-		computeSubmitInfo.pSignalSemaphores = &timeLineSemaphore.handle;
-
-		computeSubmitInfo.pNext = &timeLineSubmitInfo;
-
-		VK_CHECK_RESULT(vkQueueSubmit(compute.queue, 1, &computeSubmitInfo, VK_NULL_HANDLE));
+		// The compute workload of the first frame has no preceding frame to overlap with
+		if (frameIndex == 0) {
+			buildComputeCommandBuffer(frameIndex);
+			scheduler.submitCompute(frameIndex);
+		}
 
 		VulkanExampleBase::prepareFrame();
 
-		VkPipelineStageFlags graphicsWaitStageMasks[] = { VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-		VkSemaphore graphicsWaitSemaphores[] = { timeLineSemaphore.handle, semaphores.presentComplete };
-		VkSemaphore graphicsSignalSemaphores[] = { timeLineSemaphore.handle, semaphores.renderComplete };
-
-		// Submit graphics commands
-		submitInfo.commandBufferCount = 1;
-		submitInfo.pCommandBuffers = &drawCmdBuffers[currentBuffer];
-		submitInfo.waitSemaphoreCount = 2;
-		submitInfo.pWaitSemaphores = graphicsWaitSemaphores;
-		submitInfo.pWaitDstStageMask = graphicsWaitStageMasks;
-		submitInfo.signalSemaphoreCount = 2;
-		submitInfo.pSignalSemaphores = graphicsSignalSemaphores;
-
-		uint64_t wait_values[2] = { compute_finished, compute_finished };
-		uint64_t signal_values[2] = { all_finished, all_finished };
-
-		timeLineSubmitInfo.waitSemaphoreValueCount = 2;
-		timeLineSubmitInfo.pWaitSemaphoreValues = &wait_values[0];
-		timeLineSubmitInfo.signalSemaphoreValueCount = 2;
-		timeLineSubmitInfo.pSignalSemaphoreValues = &signal_values[0];
+		// Submit graphics commands, the scheduler adds a wait for the compute workload of this frame
+		// Nothing waits on the graphics timeline before the command buffer and the single graphics uniform buffer (see render) are reused,
+		// this is only safe because submitFrame ends with vkQueueWaitIdle, so the graphics workload of the previous frame has finished
+		buildGraphicsCommandBuffer(drawCmdBuffers[currentBuffer]);
+		scheduler.submitGraphics(drawCmdBuffers[currentBuffer], frameIndex, semaphores.presentComplete, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, semaphores.renderComplete);
 
-		submitInfo.pNext = &timeLineSubmitInfo;
-
-		VK_CHECK_RESULT(vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE));
-
-		// Increase timeline value base for next frame
-		timeLineSemaphore.value = all_finished;
+		// Submit compute for the next frame right away, so it can run on the compute queue while this frame is being drawn
+		buildComputeCommandBuffer(frameIndex + 1);
+		scheduler.submitCompute(frameIndex + 1);
 
 		VulkanExampleBase::submitFrame();
+		frameIndex++;
 	}
 
 	virtual void render()
 	{
 		if (!prepared)
 			return;
-		updateComputeUniformBuffers();
 		updateGraphicsUniformBuffers();
 		draw();
 	}
+
+	virtual void OnUpdateUIOverlay(vks::UIOverlay* overlay)
+	{
+		if (overlay->header("Async compute")) {
+			overlay->text("Queue families: %s", scheduler.separateQueueFamilies() ? "separate" : "shared");
+			overlay->text("Ownership transfers: %d", scheduler.getOwnershipTransferCount());
+			if (scheduler.statistics.available) {
+				overlay->text("Compute: %.3f ms", scheduler.statistics.computeTime);
+				overlay->text("Graphics: %.3f ms", scheduler.statistics.graphicsTime);
+				// Compares timestamps of different queues, see AsyncComputeScheduler::Statistics
+				overlay->text("Overlap (estimate): %.1f %%", scheduler.statistics.overlapEstimate * 100.0f);
+			}
+		}
+	}
 };
 
 VULKAN_EXAMPLE_MAIN()
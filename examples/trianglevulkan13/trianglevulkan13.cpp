@@ -681,8 +681,9 @@ public:
 
 		// Get the next swap chain image from the implementation
 		// Note that the implementation is free to return the images in any order, so we must use the acquire function and can't just cycle through the images/imageIndex on our own
+		// The swap chain class calls vkAcquireNextImageKHR, or hands out its own images when running without a window (--headless)
 		uint32_t imageIndex;
-		VkResult result = vkAcquireNextImageKHR(device, swapChain.swapChain, UINT64_MAX, presentCompleteSemaphores[currentFrame], VK_NULL_HANDLE, &imageIndex);
+		VkResult result = swapChain.acquireNextImage(presentCompleteSemaphores[currentFrame], imageIndex);
 		if (result == VK_ERROR_OUT_OF_DATE_KHR) {
 			windowResize();
 			return;
@@ -781,13 +782,13 @@ public:
 		// Present the current frame buffer to the swap chain
 		// Pass the semaphore signaled by the command buffer submission from the submit info as the wait semaphore for swap chain presentation
 		// This ensures that the image is not presented to the windowing system until all commands have been submitted
-		VkPresentInfoKHR presentInfo{ VK_STRUCTURE_TYPE_PRESENT_INFO_KHR };
-		presentInfo.waitSemaphoreCount = 1;
-		presentInfo.pWaitSemaphores = &renderCompleteSemaphores[currentFrame];
-		presentInfo.swapchainCount = 1;
-		presentInfo.pSwapchains = &swapChain.swapChain;
-		presentInfo.pImageIndices = &imageIndex;
-		result = vkQueuePresentKHR(queue, &presentInfo);
+		VkSemaphore waitSemaphore = renderCompleteSemaphores[currentFrame];
+		if (frameCapture.active()) {
+			// Frames requested with -df are copied after rendering has finished, and presentation then waits for the copy instead
+			waitSemaphore = frameCapture.capture(swapChain.images[imageIndex], waitSemaphore);
+		}
+		// The swap chain class calls vkQueuePresentKHR, or only waits for the semaphore when running without a window
+		result = swapChain.queuePresent(queue, imageIndex, waitSemaphore);
 		if ((result == VK_ERROR_OUT_OF_DATE_KHR) || (result == VK_SUBOPTIMAL_KHR)) {
 			windowResize();
 		} else if (result != VK_SUCCESS) {
@@ -261,7 +261,6 @@ void VulkanExample::buildCommandBuffers()
 			drawSceneNode(drawCmdBuffers[i], node);
 		}
 
-		drawUI(drawCmdBuffers[i]);
 		vkCmdEndRenderPass(drawCmdBuffers[i]);
 		VK_CHECK_RESULT(vkEndCommandBuffer(drawCmdBuffers[i]));
 	}